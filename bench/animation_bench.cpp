@@ -0,0 +1,57 @@
+// Clip sampling throughput (cursor-cached forward playback vs. random seeks) and clip memory,
+// raw vs. compressed. items_per_second counts bone samples.
+
+#include "animation.h"
+#include "bench_common.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+
+// Every bone rotates (LINEAR) and the root translates; the remaining tracks are constant,
+// as exported by most DCC tools that bake every channel.
+static AnimationClip MakeSyntheticClip(uint32_t bones, uint32_t keys, BenchRng& rng) {
+    AnimationClip clip; clip.name = "synthetic"; clip.boneCount = bones;
+    for (uint32_t k = 0; k < keys; ++k) clip.times.push_back(k / 30.0f);
+    clip.duration = clip.times.back();
+    auto addTrack = [&](uint32_t slot, AnimPath path, int comps, auto&& value) {
+        AnimTrack tr{};
+        tr.slot = slot; tr.path = uint8_t(path); tr.interp = uint8_t(AnimInterp::Linear);
+        tr.encoding = uint8_t(TrackEncoding::Float); tr.comps = uint8_t(comps); tr.keyCount = keys;
+        tr.timeOffset = 0; tr.valueOffset = uint32_t(clip.values.size());
+        for (uint32_t k = 0; k < keys; ++k) { float v[4]; value(clip.times[k], v); clip.values.insert(clip.values.end(), v, v + comps); }
+        clip.tracks.push_back(tr);
+    };
+    for (uint32_t b = 0; b < bones; ++b) {
+        const float phase = rng.Uniform(0, 6.28f), speed = rng.Uniform(0.5f, 3.0f);
+        addTrack(b, AnimPath::Rotation, 4, [&](float t, float* v) {
+            const float a = 0.5f * std::sin(t * speed + phase);
+            v[0] = std::sin(a); v[1] = 0; v[2] = 0; v[3] = std::cos(a);
+        });
+        addTrack(b, AnimPath::Translation, 3, [&](float t, float* v) { v[0] = 0; v[1] = b ? 0.1f : 0.2f * t; v[2] = 0; });
+        addTrack(b, AnimPath::Scale, 3, [](float, float* v) { v[0] = v[1] = v[2] = 1; });
+    }
+    return clip;
+}
+
+static void BM_SampleClip(benchmark::State& state) {
+    BenchRng rng;
+    const uint32_t bones = uint32_t(state.range(0));
+    const bool compressed = state.range(1) != 0, sequential = state.range(2) != 0;
+    const AnimationClip raw = MakeSyntheticClip(bones, 300, rng);
+    const AnimationClip clip = compressed ? CompressClip(raw) : raw;
+    const ClipView view = ViewOf(clip);
+    ClipSampler sampler; ResetSampler(sampler, view);
+    std::vector<float> locals(size_t(bones) * 16);
+    float t = 0;
+    for (auto _ : state) {
+        t = sequential ? std::fmod(t + 1.0f / 60.0f, clip.duration) : rng.Uniform(0, clip.duration);
+        SampleClip(view, t, sampler, locals.data());
+        benchmark::DoNotOptimize(locals.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * bones);
+    state.counters["clip_bytes"] = double(ClipMemoryBytes(clip));
+    state.counters["raw_bytes"] = double(ClipMemoryBytes(raw));
+    state.SetLabel(std::string(compressed ? "compressed" : "raw") + (sequential ? "/sequential" : "/random"));
+}
+BENCHMARK(BM_SampleClip)->ArgsProduct({ { 64, 512 }, { 0, 1 }, { 1, 0 } })->Unit(benchmark::kMicrosecond);
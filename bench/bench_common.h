@@ -0,0 +1,74 @@
+#pragma once
+// Deterministic synthetic inputs shared by the benchmarks and tests.
+
+#include "mesh_types.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+struct BenchRng {
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint32_t Next() { state = state * 6364136223846793005ull + 1442695040888963407ull; return uint32_t(state >> 33); }
+    float Uniform(float lo = 0.0f, float hi = 1.0f) { return lo + (hi - lo) * (Next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+// Random vertices with 4 distinct influences over `boneCount` bones, weights summing to 1.
+inline std::vector<VertexIn> MakeRandomSkinnedVertices(size_t count, uint32_t boneCount, BenchRng& rng) {
+    std::vector<VertexIn> v(count);
+    for (auto& x : v) {
+        for (int c = 0; c < 3; ++c) { x.pos[c] = rng.Uniform(-1, 1); x.nrm[c] = rng.Uniform(-1, 1); }
+        float w[4], sum = 0;
+        for (int k = 0; k < 4; ++k) { x.boneIdx[k] = (rng.Next() % boneCount); w[k] = rng.Uniform(0.05f, 1.0f); sum += w[k]; }
+        for (int k = 0; k < 4; ++k) x.boneWgt[k] = w[k] / sum;
+    }
+    return v;
+}
+
+// N x N grid of random-influence vertices (positions on a bumpy sheet, random unit normals)
+// with a triangle list, for anything that needs connectivity (meshlets, LODs).
+inline void MakeRandomSkinnedGrid(uint32_t n, uint32_t boneCount, BenchRng& rng,
+                                  std::vector<VertexIn>& verts, std::vector<uint32_t>& indices) {
+    verts = MakeRandomSkinnedVertices(size_t(n + 1) * (n + 1), boneCount, rng);
+    for (uint32_t y = 0; y <= n; ++y)
+        for (uint32_t x = 0; x <= n; ++x) {
+            VertexIn& v = verts[size_t(y) * (n + 1) + x];
+            v.pos[0] = float(x) / n; v.pos[1] = float(y) / n; v.pos[2] = 0.05f * v.pos[2];
+            const float len = std::sqrt(v.nrm[0]*v.nrm[0] + v.nrm[1]*v.nrm[1] + v.nrm[2]*v.nrm[2]) + 1e-6f;
+            for (float& c : v.nrm) c /= len;
+        }
+    indices.clear(); indices.reserve(size_t(n) * n * 6);
+    for (uint32_t y = 0; y < n; ++y)
+        for (uint32_t x = 0; x < n; ++x) {
+            const uint32_t i = y * (n + 1) + x;
+            indices.insert(indices.end(), { i, i + n + 1, i + 1, i + 1, i + n + 1, i + n + 2 });
+        }
+}
+
+// Column-major rigid transforms (rotation about a random axis + translation), 16 floats each.
+inline std::vector<float> MakeRandomPalette(uint32_t boneCount, BenchRng& rng) {
+    std::vector<float> p(size_t(boneCount) * 16, 0.0f);
+    for (uint32_t b = 0; b < boneCount; ++b) {
+        float ax = rng.Uniform(-1, 1), ay = rng.Uniform(-1, 1), az = rng.Uniform(-1, 1);
+        const float len = std::sqrt(ax*ax + ay*ay + az*az) + 1e-6f; ax /= len; ay /= len; az /= len;
+        const float a = rng.Uniform(-3.14159f, 3.14159f), c = std::cos(a), s = std::sin(a), t = 1 - c;
+        float* m = &p[size_t(b) * 16];
+        m[0] = t*ax*ax + c;    m[1] = t*ax*ay + s*az; m[2]  = t*ax*az - s*ay;
+        m[4] = t*ax*ay - s*az; m[5] = t*ay*ay + c;    m[6]  = t*ay*az + s*ax;
+        m[8] = t*ax*az + s*ay; m[9] = t*ay*az - s*ax; m[10] = t*az*az + c;
+        m[12] = rng.Uniform(-1, 1); m[13] = rng.Uniform(-1, 1); m[14] = rng.Uniform(-1, 1); m[15] = 1;
+    }
+    return p;
+}
+
+// Random bone tree (parent index < child index) with identity inverse binds.
+template <class SkinT>
+inline SkinT MakeRandomSkin(uint32_t boneCount, BenchRng& rng) {
+    SkinT s; s.skinIndex = 0; s.bones.resize(boneCount);
+    for (uint32_t i = 0; i < boneCount; ++i) {
+        auto& b = s.bones[i];
+        b.node = int(i); b.parent = i ? int(rng.Next() % i) : -1;
+        for (int e = 0; e < 16; ++e) b.inverseBind[e] = b.globalMatrix[e] = (e % 5 == 0) ? 1.0f : 0.0f;
+    }
+    return s;
+}
@@ -0,0 +1,81 @@
+// Bone palette encodings: conversion throughput from skinning matrices to each gBones format
+// (single thread and a thread sweep over a crowd-sized palette) and the scalar reference
+// skinning cost per format.
+
+#include "bench_common.h"
+#include "bone_palette.h"
+#include "thread_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+static std::vector<float> Encode(PaletteFormat format, const std::vector<float>& skinning) {
+    std::vector<float> out(skinning.size() / 16 * PaletteFloats(format));
+    EncodePalette(format, skinning.data(), skinning.size() / 16, out.data());
+    return out;
+}
+
+static void BM_EncodePalette(benchmark::State& state) {
+    const PaletteFormat format = PaletteFormat(state.range(0));
+    const uint32_t bones = uint32_t(state.range(1));
+    BenchRng rng;
+    const std::vector<float> skinning = MakeRandomPalette(bones, rng);
+    std::vector<float> out(size_t(bones) * PaletteFloats(format));
+    for (auto _ : state) {
+        EncodePalette(format, skinning.data(), bones, out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetLabel(PaletteFormatName(format));
+    state.SetItemsProcessed(int64_t(state.iterations()) * bones);
+    state.SetBytesProcessed(int64_t(state.iterations()) * bones * PaletteFloats(format) * sizeof(float));
+    state.counters["bytes/bone"] = double(PaletteFloats(format) * sizeof(float));
+}
+BENCHMARK(BM_EncodePalette)->ArgsProduct({ { 0, 1, 2 }, { 64, 4096 } });
+
+// Crowd-sized palette (4096 instances x 64 bones) encoded on the pool.
+static void BM_EncodePaletteParallel(benchmark::State& state) {
+    const PaletteFormat format = PaletteFormat(state.range(0));
+    const int threads = int(state.range(1));
+    constexpr uint32_t kBones = 64, kInstances = 4096;
+    BenchRng rng;
+    const std::vector<float> pose = MakeRandomPalette(kBones, rng);
+    std::vector<float> skinning(size_t(kInstances) * pose.size());
+    for (uint32_t i = 0; i < kInstances; ++i) memcpy(&skinning[size_t(i) * pose.size()], pose.data(), pose.size() * sizeof(float));
+    std::vector<float> out(size_t(kInstances) * kBones * PaletteFloats(format));
+    ThreadPool pool(threads - 1);
+    for (auto _ : state) {
+        EncodePaletteParallel(pool, format, skinning.data(), size_t(kInstances) * kBones, out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetLabel(PaletteFormatName(format));
+    state.SetItemsProcessed(int64_t(state.iterations()) * kInstances * kBones);
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(out.size() * sizeof(float)));
+}
+BENCHMARK(BM_EncodePaletteParallel)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+        const int hw = int(std::max(1u, std::thread::hardware_concurrency()));
+        for (int f : { 1, 2 }) {
+            for (int t = 1; t < hw; t *= 2) b->Args({ f, t });
+            b->Args({ f, hw });
+        }
+    })
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+static void BM_SkinVertexReference(benchmark::State& state) {
+    const PaletteFormat format = PaletteFormat(state.range(0));
+    constexpr uint32_t kBones = 64;
+    BenchRng rng;
+    const std::vector<float> palette = Encode(format, MakeRandomPalette(kBones, rng));
+    const std::vector<VertexIn> verts = MakeRandomSkinnedVertices(16384, kBones, rng);
+    std::vector<float> out(verts.size() * 6);
+    for (auto _ : state) {
+        for (size_t i = 0; i < verts.size(); ++i) SkinVertexReference(format, palette.data(), verts[i], &out[i * 6], &out[i * 6 + 3]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetLabel(PaletteFormatName(format));
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(verts.size()));
+}
+BENCHMARK(BM_SkinVertexReference)->DenseRange(0, 2);
@@ -0,0 +1,47 @@
+// Crowd culling: meshlet bounds generation and the CPU emulation of ASMain over a grid of
+// skinned instances.
+
+#include "crowd.h"
+#include "crowd_fixture.h"
+#include "thread_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <thread>
+
+static void BM_ComputeMeshletBounds(benchmark::State& state) {
+    BenchRng rng; std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    MakeRandomSkinnedGrid(256, 64, rng, verts, indices);
+    const MeshletMesh mesh = BuildMeshlets(verts, indices);
+    for (auto _ : state) {
+        std::vector<MeshletBounds> bounds = ComputeMeshletBounds(mesh);
+        benchmark::DoNotOptimize(bounds.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(mesh.meshlets.size()));
+}
+BENCHMARK(BM_ComputeMeshletBounds)->Unit(benchmark::kMillisecond);
+
+static void BM_CullCrowd(benchmark::State& state) {
+    static const CrowdFixture f(64, 6);
+    const int threads = int(state.range(0));
+    ThreadPool pool(threads - 1);
+    std::vector<CrowdDraw> survivors;
+    CullStats stats;
+    for (auto _ : state) {
+        stats = CullCrowd(pool, f.mesh, f.bounds, f.instances, f.palettes.data(), f.view, &survivors);
+        benchmark::DoNotOptimize(survivors.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(stats.tested));
+    state.counters["culled_fraction"] = stats.CulledFraction();
+    state.counters["frustum_culled"] = double(stats.frustumCulled);
+    state.counters["cone_culled"] = double(stats.coneCulled);
+    state.counters["visible"] = double(stats.visible);
+}
+BENCHMARK(BM_CullCrowd)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+        const int hw = int(std::max(1u, std::thread::hardware_concurrency()));
+        for (int t = 1; t < hw; t *= 2) b->Arg(t);
+        b->Arg(hw);
+    })
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
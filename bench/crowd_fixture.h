@@ -0,0 +1,104 @@
+#pragma once
+// Skinned crowd shared by crowd_bench and the crowd tests: a grid of swaying sphere characters
+// in front of a camera, with meshlet bounds and per-instance palettes.
+
+#include "bench_common.h"
+#include "crowd.h"
+#include "mat4.h"
+
+#include <algorithm>
+#include <cmath>
+
+// A UV sphere "character" split into latitude bands, one bone per band. Each vertex is bound
+// rigidly to its band, so meshlets inside a band are rigid and the ones crossing a band edge
+// are blended (two bones).
+inline void MakeBandedSphere(uint32_t rings, uint32_t segments, uint32_t bands,
+                             std::vector<VertexIn>& verts, std::vector<uint32_t>& indices) {
+    verts.clear(); indices.clear();
+    for (uint32_t r = 0; r <= rings; ++r)
+        for (uint32_t s = 0; s <= segments; ++s) {
+            const float theta = 3.14159265f * float(r) / rings, phi = 6.2831853f * float(s) / segments;
+            VertexIn v{};
+            v.nrm[0] = std::sin(theta) * std::cos(phi); v.nrm[1] = std::cos(theta); v.nrm[2] = std::sin(theta) * std::sin(phi);
+            for (int c = 0; c < 3; ++c) v.pos[c] = 0.5f * v.nrm[c];
+            v.pos[1] += 1.0f; // stand on the ground
+            v.boneIdx[0] = std::min(bands - 1, r * bands / rings); v.boneWgt[0] = 1.0f;
+            verts.push_back(v);
+        }
+    for (uint32_t r = 0; r < rings; ++r)
+        for (uint32_t s = 0; s < segments; ++s) {
+            const uint32_t i = r * (segments + 1) + s, j = i + segments + 1;
+            indices.insert(indices.end(), { i, i + 1, j, i + 1, j + 1, j }); // outward facing
+        }
+}
+
+struct CrowdFixture {
+    MeshletMesh mesh;
+    std::vector<MeshletBounds> bounds;
+    std::vector<InstanceData> instances;
+    std::vector<float> palettes;
+    CullView view{};
+    uint32_t bones = 0;
+
+    CrowdFixture(uint32_t side, uint32_t bands) : bones(bands) {
+        std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+        MakeBandedSphere(48, 64, bands, verts, indices);
+        mesh = BuildMeshlets(verts, indices);
+        bounds = ComputeMeshletBounds(mesh);
+
+        // each band sways about the sphere's centre axis, phase-shifted per instance
+        BenchRng rng;
+        instances.resize(size_t(side) * side);
+        palettes.assign(instances.size() * bands * 16, 0.0f);
+        for (uint32_t i = 0; i < instances.size(); ++i) {
+            InstanceData& inst = instances[i]; Mat4Identity(inst.world);
+            inst.world[12] = (float(i % side) - 0.5f * side) * 1.5f; inst.world[14] = -float(i / side) * 1.5f;
+            inst.paletteOffset = i * bands;
+            for (uint32_t b = 0; b < bands; ++b) {
+                const float a = 0.3f * std::sin(rng.Uniform(0, 6.2831853f)), c = std::cos(a), s = std::sin(a);
+                float* m = &palettes[(size_t(i) * bands + b) * 16]; Mat4Identity(m);
+                m[0] = c; m[2] = -s; m[8] = s; m[10] = c; // rotation about Y through the origin
+            }
+            inst.boundsPadding = 0.0f;
+        }
+        for (InstanceData& inst : instances) inst.boundsPadding = MaxBlendDeviation(inst);
+
+        // camera in front of the crowd, looking down the grid: a good share is outside the frustum
+        const float eye[3] = { 0.0f, 3.0f, 6.0f }, fovY = 0.8f, aspect = 16.0f / 9.0f, zn = 0.1f, zf = 60.0f;
+        const float f = 1.0f / std::tan(fovY * 0.5f);
+        float proj[16] = {}, viewM[16], vp[16];
+        proj[0] = f / aspect; proj[5] = f; proj[10] = zf / (zn - zf); proj[11] = -1.0f; proj[14] = zn * zf / (zn - zf);
+        Mat4Identity(viewM); viewM[12] = -eye[0]; viewM[13] = -eye[1]; viewM[14] = -eye[2];
+        Mat4Mul(proj, viewM, vp);
+        ExtractFrustumPlanes(vp, view.frustum);
+        for (int c = 0; c < 3; ++c) view.cameraPos[c] = eye[c];
+    }
+
+    const float* Bone(const InstanceData& inst, const MeshletData& m, uint32_t local) const {
+        return &palettes[size_t(inst.paletteOffset + mesh.boneRemap[m.boneBase + local]) * 16];
+    }
+    void Skin(const InstanceData& inst, const MeshletData& m, const VertexIn& v, float out[3]) const {
+        float p[3] = {};
+        for (int k = 0; k < 4; ++k) {
+            if (v.boneWgt[k] == 0.0f) continue;
+            const float* b = Bone(inst, m, v.boneIdx[k]);
+            for (int r = 0; r < 3; ++r) p[r] += v.boneWgt[k] * (b[r] * v.pos[0] + b[4 + r] * v.pos[1] + b[8 + r] * v.pos[2] + b[12 + r]);
+        }
+        for (int r = 0; r < 3; ++r) out[r] = inst.world[r] * p[0] + inst.world[4 + r] * p[1] + inst.world[8 + r] * p[2] + inst.world[12 + r];
+    }
+    // How far skinned vertices drift from where the dominant bone alone would put them.
+    float MaxBlendDeviation(const InstanceData& inst) const {
+        float worst = 0.0f;
+        for (size_t mi = 0; mi < mesh.meshlets.size(); ++mi) {
+            const MeshletData& m = mesh.meshlets[mi];
+            float toWorld[16]; Mat4Mul(inst.world, Bone(inst, m, bounds[mi].dominantBone), toWorld);
+            for (uint32_t v = 0; v < m.vCount; ++v) {
+                const VertexIn& vin = mesh.vertices[m.vOffset + v];
+                float s[3], d[3]; Skin(inst, m, vin, s);
+                for (int r = 0; r < 3; ++r) d[r] = toWorld[r] * vin.pos[0] + toWorld[4 + r] * vin.pos[1] + toWorld[8 + r] * vin.pos[2] + toWorld[12 + r] - s[r];
+                worst = std::max(worst, std::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]));
+            }
+        }
+        return worst;
+    }
+};
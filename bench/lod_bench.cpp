@@ -0,0 +1,81 @@
+// LOD chains: build throughput, triangle reduction per level, and position error of each level
+// against the source mesh once both are skinned with the same posed skeleton, for the
+// skin-aware simplifier and for plain quadric simplification (joint constraint and skin cost
+// off).
+
+#include "lod.h"
+#include "lod_fixture.h"
+
+#include <benchmark/benchmark.h>
+
+struct LodFixture {
+    std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    LodChain skinAware, plain;
+    std::vector<float> palette;
+    explicit LodFixture(const TubeSize& size) {
+        MakeSkinnedTube(size.rings, size.segments, kTubeBones, verts, indices);
+        skinAware = BuildLodChain(verts, indices);
+        plain = BuildLodChain(verts, indices, PlainQuadricOptions());
+        BenchRng rng; palette = MakeBentPalette(kTubeBones, rng);
+    }
+};
+
+static const LodFixture& GetLodFixture(size_t tube) {
+    static const LodFixture small(kTubes[0]), large(kTubes[1]);
+    return tube ? large : small;
+}
+
+static void BM_BuildLodChain(benchmark::State& state) {
+    const LodFixture& f = GetLodFixture(size_t(state.range(0)));
+    LodChain chain;
+    for (auto _ : state) {
+        chain = BuildLodChain(f.verts, f.indices);
+        benchmark::DoNotOptimize(chain.levels.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(f.indices.size() / 3));
+    state.counters["levels"] = double(chain.levels.size());
+    state.counters["source_tris"] = double(f.indices.size() / 3);
+    state.counters["coarsest_tris"] = double(chain.levels.back().indices.size() / 3);
+}
+BENCHMARK(BM_BuildLodChain)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Args: tube, level, skin-aware (1) or plain quadrics (0). Times the error measurement; the
+// counters are the result.
+static void BM_LodLevelError(benchmark::State& state) {
+    const LodFixture& f = GetLodFixture(size_t(state.range(0)));
+    const LodChain& chain = state.range(2) ? f.skinAware : f.plain;
+    if (size_t(state.range(1)) >= chain.levels.size()) { state.SkipWithError("chain has fewer levels"); return; }
+    const LodLevel& level = chain.levels[size_t(state.range(1))];
+    LodError animated, rest;
+    for (auto _ : state) {
+        animated = MeasureLodError(f.verts, level, f.palette.data());
+        benchmark::DoNotOptimize(animated.max);
+    }
+    rest = MeasureLodError(f.verts, level, BindPalette(kTubeBones).data());
+    state.SetLabel(state.range(2) ? "skin-aware" : "plain quadrics");
+    state.counters["tri_ratio"] = double(level.indices.size()) / double(chain.levels[0].indices.size());
+    state.counters["error_estimate"] = level.error;
+    state.counters["rest_err_max"] = rest.max;
+    state.counters["anim_err_mean"] = animated.mean;
+    state.counters["anim_err_max"] = animated.max;
+}
+BENCHMARK(BM_LodLevelError)
+    ->ArgsProduct({ { 0, 1 }, { 1, 2, 3, 4, 5 }, { 1, 0 } })
+    ->Unit(benchmark::kMillisecond);
+
+// Per-instance selection for a crowd spread over 1..200 units.
+static void BM_SelectLod(benchmark::State& state) {
+    const LodFixture& f = GetLodFixture(0);
+    BenchRng rng;
+    std::vector<float> distances(4096);
+    for (float& d : distances) d = rng.Uniform(1.0f, 200.0f);
+    const float proj = LodProjectionScale(0.8f, 1080.0f);
+    uint64_t levelSum = 0;
+    for (auto _ : state) {
+        for (float d : distances) levelSum += SelectLod(f.skinAware, d, proj, 1.0f);
+        benchmark::DoNotOptimize(levelSum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(distances.size()));
+    state.counters["avg_level"] = double(levelSum) / double(state.iterations() * distances.size());
+}
+BENCHMARK(BM_SelectLod);
@@ -0,0 +1,103 @@
+#pragma once
+// Skinned tube and LOD error measurement shared by lod_bench and the LOD tests.
+
+#include "bench_common.h"
+#include "lod.h"
+#include "mat4.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+constexpr float kJointBand = 0.1f; // length of the blend region around each joint
+
+// A bumpy tube along +Y over a chain of unit-length bones; rigid along each bone, blended
+// across a band around every joint. Open ends (locked borders), no seams.
+inline void MakeSkinnedTube(uint32_t rings, uint32_t segments, uint32_t bones,
+                            std::vector<VertexIn>& verts, std::vector<uint32_t>& indices) {
+    verts.clear(); indices.clear();
+    for (uint32_t r = 0; r <= rings; ++r)
+        for (uint32_t s = 0; s < segments; ++s) {
+            const float y = float(bones) * r / rings, phi = 6.2831853f * float(s) / segments;
+            const float radius = 0.25f + 0.03f * std::sin(5.0f * phi) * std::sin(7.0f * y);
+            VertexIn v{};
+            v.nrm[0] = std::cos(phi); v.nrm[2] = std::sin(phi);
+            v.pos[0] = radius * v.nrm[0]; v.pos[1] = y; v.pos[2] = radius * v.nrm[2];
+            const uint32_t joint = std::clamp(uint32_t(y + 0.5f), 1u, bones - 1); // nearest inner joint
+            const float t = std::clamp((y - float(joint) + 0.5f * kJointBand) / kJointBand, 0.0f, 1.0f);
+            v.boneIdx[0] = joint - 1; v.boneWgt[0] = 1.0f - t;
+            v.boneIdx[1] = joint;     v.boneWgt[1] = t;
+            verts.push_back(v);
+        }
+    for (uint32_t r = 0; r < rings; ++r)
+        for (uint32_t s = 0; s < segments; ++s) {
+            const uint32_t i = r * segments + s, i1 = r * segments + (s + 1) % segments;
+            indices.insert(indices.end(), { i, i1, i + segments, i1, i1 + segments, i + segments });
+        }
+}
+
+// Bone b pivots about (0, b, 0); each joint bends about Z by a random angle.
+inline std::vector<float> MakeBentPalette(uint32_t bones, BenchRng& rng) {
+    std::vector<float> palette(size_t(bones) * 16);
+    float global[16], parent[16]; Mat4Identity(parent);
+    for (uint32_t b = 0; b < bones; ++b) {
+        const float a = rng.Uniform(-1.2f, 1.2f), q[4] = { 0, 0, std::sin(0.5f * a), std::cos(0.5f * a) };
+        const float t[3] = { 0, b ? 1.0f : 0.0f, 0 }, one[3] = { 1, 1, 1 };
+        float local[16], invBind[16]; ComposeTRS(t, q, one, local);
+        Mat4Mul(parent, local, global);
+        Mat4Identity(invBind); invBind[13] = -float(b);
+        Mat4Mul(global, invBind, &palette[size_t(b) * 16]);
+        memcpy(parent, global, sizeof(global));
+    }
+    return palette;
+}
+
+inline std::vector<float> BindPalette(uint32_t bones) {
+    std::vector<float> palette(size_t(bones) * 16);
+    for (uint32_t b = 0; b < bones; ++b) Mat4Identity(&palette[size_t(b) * 16]);
+    return palette;
+}
+
+inline void SkinPosition(const VertexIn& v, const float* palette, float out[3]) {
+    out[0] = out[1] = out[2] = 0.0f;
+    for (int k = 0; k < 4; ++k) {
+        if (v.boneWgt[k] == 0.0f) continue;
+        const float* m = &palette[size_t(v.boneIdx[k]) * 16];
+        for (int r = 0; r < 3; ++r) out[r] += v.boneWgt[k] * (m[r] * v.pos[0] + m[4 + r] * v.pos[1] + m[8 + r] * v.pos[2] + m[12 + r]);
+    }
+}
+
+struct LodError { double mean = 0, max = 0; };
+
+// Distance of every skinned source vertex to the skinned triangles around the vertex it
+// collapsed into (a local stand-in for the distance to the level's surface).
+inline LodError MeasureLodError(const std::vector<VertexIn>& source, const LodLevel& level, const float* palette) {
+    std::vector<float> skinned(level.vertices.size() * 3);
+    for (size_t v = 0; v < level.vertices.size(); ++v) SkinPosition(level.vertices[v], palette, &skinned[v * 3]);
+    std::vector<uint32_t> offsets(level.vertices.size() + 1, 0), tris(level.indices.size());
+    for (uint32_t v : level.indices) offsets[v + 1]++;
+    for (size_t v = 0; v < level.vertices.size(); ++v) offsets[v + 1] += offsets[v];
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < level.indices.size(); ++i) tris[fill[level.indices[i]]++] = uint32_t(i / 3);
+
+    LodError e; size_t count = 0;
+    for (size_t s = 0; s < source.size(); ++s) {
+        const uint32_t r = level.remap[s];
+        if (r == ~0u) continue;
+        float p[3]; SkinPosition(source[s], palette, p);
+        float best = 1e30f;
+        for (uint32_t k = offsets[r]; k < offsets[r + 1]; ++k) {
+            const uint32_t* t = &level.indices[size_t(tris[k]) * 3];
+            best = std::min(best, PointTriangleDistance(p, &skinned[t[0] * 3], &skinned[t[1] * 3], &skinned[t[2] * 3]));
+        }
+        e.mean += best; e.max = std::max(e.max, double(best)); ++count;
+    }
+    if (count) e.mean /= double(count);
+    return e;
+}
+
+constexpr uint32_t kTubeBones = 8;
+struct TubeSize { uint32_t rings, segments; };
+inline const TubeSize kTubes[] = { { 128, 64 }, { 512, 256 } }; // 16K and 256K triangles
+
+inline LodOptions PlainQuadricOptions() { LodOptions o; o.heavyWeight = 2.0f; o.skinWeight = 0.0f; return o; }
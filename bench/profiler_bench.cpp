@@ -0,0 +1,60 @@
+// Profiler overhead: ns per CPU zone (enabled, disabled, from several threads at once) and per
+// counter sample, plus the Chrome trace export rate.
+
+#include "profiler.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+static void Drain() { std::vector<ProfileEvent> sink; ProfilerCollect(sink); }
+
+// One zone per iteration; the ring is drained outside the timed region before it fills.
+static void BM_ProfileZone(benchmark::State& state) {
+    ProfilerSetEnabled(state.range(0) != 0);
+    size_t n = 0;
+    for (auto _ : state) {
+        { GRFX_PROFILE_ZONE("bench"); }
+        if (++n == kProfileRingEvents / 2) { state.PauseTiming(); Drain(); n = 0; state.ResumeTiming(); }
+    }
+    ProfilerSetEnabled(true);
+    Drain();
+    state.SetLabel(state.range(0) ? "enabled" : "disabled");
+}
+BENCHMARK(BM_ProfileZone)->Arg(1)->Arg(0);
+
+// Every thread records into its own ring at the same time.
+static void BM_ProfileZoneThreads(benchmark::State& state) {
+    size_t n = 0;
+    for (auto _ : state) {
+        { GRFX_PROFILE_ZONE("bench"); }
+        if (++n == kProfileRingEvents / 2) { state.PauseTiming(); Drain(); n = 0; state.ResumeTiming(); }
+    }
+}
+BENCHMARK(BM_ProfileZoneThreads)->ThreadRange(1, 8);
+
+static void BM_ProfileCounter(benchmark::State& state) {
+    size_t n = 0;
+    for (auto _ : state) {
+        ProfileCounter("bench", double(n));
+        if (++n == kProfileRingEvents / 2) { state.PauseTiming(); Drain(); n = 0; state.ResumeTiming(); }
+    }
+    Drain();
+}
+BENCHMARK(BM_ProfileCounter);
+
+static void BM_ChromeTraceJson(benchmark::State& state) {
+    std::vector<ProfileEvent> events(100000);
+    for (size_t i = 0; i < events.size(); ++i)
+        events[i] = ProfileEvent{ "zone", i * 100, { i * 100 + 50 }, uint32_t(i % 4), ProfileEventKind::Zone };
+    size_t bytes = 0;
+    for (auto _ : state) {
+        const std::string json = ChromeTraceJson(events, {});
+        bytes = json.size();
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(events.size()));
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(bytes));
+}
+BENCHMARK(BM_ChromeTraceJson)->Unit(benchmark::kMillisecond);
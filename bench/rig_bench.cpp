@@ -0,0 +1,125 @@
+// End-to-end asset path over synthetic rigs of increasing size: glTF (GLB) load, BuildSkin,
+// ValidatePrimitiveSkin, primitive extraction + meshletization, and skinning with a palette
+// evaluated from the rig's own skeleton. Arg 0..2 picks the rig (see kRigs); every benchmark
+// reports bones/vertices counters so JSON results stay comparable across commits.
+
+#include "bench_common.h"
+#include "cpu_skinning.h"
+#include "mat4.h"
+#include "meshlet.h"
+#include "skeleton.h"
+#include "skin_validate.h"
+#include "synthetic_rig.h"
+#include "tinygltf.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+
+static const RigSize kRigs[] = { { "small", 32, 8 << 10 }, { "medium", 128, 64 << 10 }, { "large", 512, 512 << 10 } };
+
+struct RigFixture {
+    RigSize size;
+    tinygltf::Model model;
+    std::string glbPath; bool glbWritten = false; uintmax_t glbBytes = 0;
+
+    explicit RigFixture(const RigSize& s) : size(s) {
+        BenchRng rng;
+        model = MakeSyntheticRig(size, rng);
+        glbPath = (std::filesystem::temp_directory_path() / (std::string("grfx_bench_rig_") + size.name + ".glb")).string();
+        tinygltf::TinyGLTF writer;
+        glbWritten = writer.WriteGltfSceneToFile(&model, glbPath, true, true, false, true);
+        if (glbWritten) glbBytes = std::filesystem::file_size(glbPath);
+    }
+    ~RigFixture() { if (glbWritten) std::filesystem::remove(glbPath); }
+
+    const tinygltf::Primitive& Primitive() const { return model.meshes[0].primitives[0]; }
+};
+
+static const RigFixture& GetRig(benchmark::State& state) {
+    static std::unique_ptr<RigFixture> rigs[std::size(kRigs)];
+    auto& rig = rigs[state.range(0)];
+    if (!rig) rig = std::make_unique<RigFixture>(kRigs[state.range(0)]);
+    state.SetLabel(rig->size.name);
+    state.counters["bones"] = double(rig->size.bones);
+    state.counters["vertices"] = double(rig->model.accessors[rig->Primitive().attributes.at("POSITION")].count);
+    return *rig;
+}
+
+static void BM_RigLoadGLB(benchmark::State& state) {
+    const RigFixture& rig = GetRig(state);
+    if (!rig.glbWritten) { state.SkipWithError("could not write the synthetic rig GLB"); return; }
+    for (auto _ : state) {
+        tinygltf::Model loaded;
+        LoadGLTF(rig.glbPath, loaded);
+        benchmark::DoNotOptimize(loaded.buffers.data());
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(rig.glbBytes));
+}
+BENCHMARK(BM_RigLoadGLB)->DenseRange(0, int(std::size(kRigs)) - 1)->Unit(benchmark::kMillisecond);
+
+static void BM_RigBuildSkin(benchmark::State& state) {
+    const RigFixture& rig = GetRig(state);
+    for (auto _ : state) {
+        Skin skin = BuildSkin(rig.model, 0);
+        benchmark::DoNotOptimize(skin.bones.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(rig.size.bones));
+}
+BENCHMARK(BM_RigBuildSkin)->DenseRange(0, int(std::size(kRigs)) - 1)->Unit(benchmark::kMicrosecond);
+
+static void BM_RigValidatePrimitiveSkin(benchmark::State& state) {
+    const RigFixture& rig = GetRig(state);
+    SkinValidationOptions options; options.fix = false;
+    PrimitiveSkinReport report;
+    for (auto _ : state) {
+        report = ValidatePrimitiveSkin(rig.model, rig.model.skins[0], rig.Primitive(), options);
+        benchmark::DoNotOptimize(report);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(report.counts.vertices));
+}
+BENCHMARK(BM_RigValidatePrimitiveSkin)->DenseRange(0, int(std::size(kRigs)) - 1)->Unit(benchmark::kMicrosecond);
+
+static void BM_RigMeshletize(benchmark::State& state) {
+    const RigFixture& rig = GetRig(state);
+    std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    MeshletMesh mesh;
+    for (auto _ : state) {
+        ReadPrimitiveVertices(rig.model, rig.Primitive(), verts, indices);
+        mesh = BuildMeshlets(verts, indices);
+        benchmark::DoNotOptimize(mesh.meshlets.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(indices.size() / 3));
+    state.counters["meshlets"] = double(mesh.meshlets.size());
+}
+BENCHMARK(BM_RigMeshletize)->DenseRange(0, int(std::size(kRigs)) - 1)->Unit(benchmark::kMillisecond);
+
+static void BM_RigSkinning(benchmark::State& state) {
+    const RigFixture& rig = GetRig(state);
+    std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    ReadPrimitiveVertices(rig.model, rig.Primitive(), verts, indices);
+
+    // rest pose plus a small random rotation per bone, evaluated through the skeleton
+    const Skin skin = BuildSkin(rig.model, 0);
+    SkeletonLayout layout = BuildSkeletonLayout(skin);
+    ReadRestPose(rig.model, layout);
+    BenchRng rng;
+    const std::vector<float> sway = MakeRandomPalette(uint32_t(layout.BoneCount()), rng);
+    std::vector<float> local(layout.BoneCount() * 16), global(local.size()), palette(local.size());
+    for (size_t s = 0; s < layout.BoneCount(); ++s) {
+        float r[16]; memcpy(r, &sway[s * 16], sizeof(r)); r[12] = r[13] = r[14] = 0.0f;
+        Mat4Mul(&layout.restLocal[s * 16], r, &local[s * 16]);
+    }
+    EvaluateSkeleton(layout, local.data(), global.data(), palette.data());
+
+    const SkinningStreams streams = MakeSkinningStreams(verts.data(), verts.size(), uint32_t(layout.BoneCount()));
+    SkinnedVertices out;
+    for (auto _ : state) {
+        SkinVertices(streams, palette.data(), out);
+        benchmark::DoNotOptimize(out.px.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(streams.count));
+}
+BENCHMARK(BM_RigSkinning)->DenseRange(0, int(std::size(kRigs)) - 1)->Unit(benchmark::kMicrosecond);
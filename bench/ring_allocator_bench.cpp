@@ -0,0 +1,83 @@
+// Ring allocator under contention: every iteration is one "frame" in which all pool threads
+// allocate constant/palette-sized blocks and write them, then the frame is finished and the
+// frame two behind it (the simulated GPU) is reclaimed.
+
+#include "ring_allocator.h"
+#include "thread_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static constexpr size_t kAllocsPerFrame = 8192;
+static constexpr uint64_t kFrameLag = 2;
+
+// Alternates 256 B (a constant buffer) and 4 KB (a 64-bone palette) requests.
+static uint64_t RequestSize(size_t i) { return (i & 1) ? 4096 : 256; }
+
+static void BM_RingAllocatorFrames(benchmark::State& state) {
+    const int threads = int(state.range(0));
+    ThreadPool pool(threads - 1);
+    // room for kFrameLag + 1 frames
+    uint64_t frameBytes = 0;
+    for (size_t i = 0; i < kAllocsPerFrame; ++i) frameBytes += RequestSize(i);
+    std::vector<uint8_t> block(frameBytes * (kFrameLag + 1) + 4096);
+    RingAllocator ring(block.data(), block.size());
+    uint64_t frame = 0;
+    std::atomic<size_t> failures{0};
+    for (auto _ : state) {
+        ++frame;
+        ring.Reclaim(frame > kFrameLag ? frame - kFrameLag : 0);
+        pool.ParallelFor(0, kAllocsPerFrame, 64, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                const RingAllocator::Allocation a = ring.Allocate(RequestSize(i));
+                if (!a) { failures++; continue; }
+                memset(a.cpu, int(i), 64); // touch the block like a constant upload would
+            }
+        });
+        ring.FinishFrame(frame);
+    }
+    if (failures) state.SkipWithError("ring ran out of space");
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(kAllocsPerFrame));
+    state.counters["threads"] = threads;
+}
+BENCHMARK(BM_RingAllocatorFrames)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+        const int hw = int(std::max(1u, std::thread::hardware_concurrency()));
+        for (int t = 1; t < hw; t *= 2) b->Arg(t);
+        b->Arg(hw);
+    })
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+// Raw Allocate() cost with every benchmark thread hammering one 16 MiB ring. The ring fills
+// every 65536 allocations; the first thread to find it full then recycles all of it at once
+// (outside the frame protocol, as nothing reads the blocks) while other calls may still fail.
+// Only successful allocations count as items; `failures` is the number of calls that found the
+// ring full.
+static void BM_RingAllocateContended(benchmark::State& state) {
+    static std::vector<uint8_t> block;
+    static RingAllocator ring;
+    static std::atomic<bool> recycling{false};
+    static uint64_t frame = 0; // only touched while holding `recycling`
+    if (state.thread_index() == 0) { block.assign(size_t(16) << 20, 0); ring.Reset(block.data(), block.size()); frame = 0; }
+    int64_t successes = 0, failures = 0;
+    for (auto _ : state) {
+        RingAllocator::Allocation a = ring.Allocate(256);
+        if (a) ++successes;
+        else {
+            ++failures;
+            if (!recycling.exchange(true, std::memory_order_acquire)) {
+                ring.FinishFrame(++frame); ring.Reclaim(frame); // recycle everything
+                recycling.store(false, std::memory_order_release);
+            }
+        }
+        benchmark::DoNotOptimize(a);
+    }
+    state.SetItemsProcessed(successes);
+    state.counters["failures"] = double(failures);
+}
+BENCHMARK(BM_RingAllocateContended)->ThreadRange(1, 8)->UseRealTime();
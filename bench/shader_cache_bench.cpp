@@ -0,0 +1,56 @@
+// Shader cache: warm lookups (hash source + includes, read the entry) and cold starts where
+// misses compile in parallel. DXC is replaced by a deterministic fake compiler that costs a fixed
+// time per shader, so this measures the cache itself.
+
+#include "shader_cache.h"
+#include "shader_tree.h"
+#include "thread_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+static const ShaderTree& GetTree() {
+    static const ShaderTree tree("grfx_bench_shader_cache");
+    return tree;
+}
+
+static void BM_ShaderCacheWarm(benchmark::State& state) {
+    const ShaderTree& tree = GetTree();
+    ThreadPool pool(int(state.range(0)) - 1);
+    { ShaderCache fill(tree.CacheDir(), "fake 1.0", FakeCompile); fill.GetAll(pool, tree.descs); }
+    for (auto _ : state) {
+        ShaderCache cache(tree.CacheDir(), "fake 1.0", FakeCompile);
+        std::vector<ShaderBinary> binaries = cache.GetAll(pool, tree.descs);
+        benchmark::DoNotOptimize(binaries.data());
+        if (cache.Stats().misses) { state.SkipWithError("warm run missed"); return; }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(kShaders));
+}
+BENCHMARK(BM_ShaderCacheWarm)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+static void BM_ShaderCacheCold(benchmark::State& state) {
+    const ShaderTree& tree = GetTree();
+    ThreadPool pool(int(state.range(0)) - 1);
+    for (auto _ : state) {
+        state.PauseTiming();
+        fs::remove_all(tree.CacheDir());
+        state.ResumeTiming();
+        ShaderCache cache(tree.CacheDir(), "fake 1.0", FakeCompile);
+        std::vector<ShaderBinary> binaries = cache.GetAll(pool, tree.descs);
+        benchmark::DoNotOptimize(binaries.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(kShaders));
+    state.counters["fake_compile_ms"] = double(kFakeCompileTime.count());
+}
+BENCHMARK(BM_ShaderCacheCold)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+        const int hw = int(std::max(1u, std::thread::hardware_concurrency()));
+        for (int t = 1; t < hw; t *= 2) b->Arg(t);
+        b->Arg(std::max(hw, 4));
+    })
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
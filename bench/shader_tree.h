@@ -0,0 +1,53 @@
+#pragma once
+// Shader source tree and fake compiler shared by shader_cache_bench and the shader cache tests.
+
+#include "shader_cache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+constexpr size_t kShaders = 16;
+constexpr auto kFakeCompileTime = std::chrono::milliseconds(4);
+
+inline void WriteText(const std::filesystem::path& path, const std::string& text) {
+    FILE* f = fopen(path.string().c_str(), "wb"); fwrite(text.data(), 1, text.size(), f); fclose(f);
+}
+
+// Object bytes derived from the desc so every shader gets distinct, checkable output.
+inline ShaderBinary FakeCompile(const ShaderDesc& d) {
+    std::this_thread::sleep_for(kFakeCompileTime);
+    ShaderBinary b;
+    const std::string seed = d.file + d.entry + d.target;
+    b.object.resize(24 * 1024);
+    for (size_t i = 0; i < b.object.size(); ++i) b.object[i] = uint8_t(seed[i % seed.size()] + i);
+    b.pdb.assign(8 * 1024, 0xAB); b.reflection.assign(1024, 0xCD); b.pdbName = "fake.pdb";
+    return b;
+}
+
+// kShaders sources; even ones include shared.hlsli (which includes leaf.hlsli), odd ones only
+// their own header.
+struct ShaderTree {
+    std::filesystem::path root;
+    std::vector<ShaderDesc> descs;
+    explicit ShaderTree(const char* name) {
+        root = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(root); std::filesystem::create_directories(root / "src" / "inc");
+        WriteText(root / "src" / "inc" / "leaf.hlsli", "#define LEAF 1\n");
+        WriteText(root / "src" / "shared.hlsli", "#pragma once\n#include \"leaf.hlsli\"\nstruct Shared { float4 v; };\n");
+        for (size_t i = 0; i < kShaders; ++i) {
+            const std::string name = "s" + std::to_string(i);
+            WriteText(root / "src" / (name + ".hlsli"), "static const uint kId = " + std::to_string(i) + ";\n");
+            std::string text = "#include \"" + name + ".hlsli\"\n";
+            if (i % 2 == 0) text += "  #  include <shared.hlsli>\n";
+            text += "[numthreads(64,1,1)] void Main() {}\n" + std::string(16 * 1024, ' ') + "\n";
+            WriteText(root / "src" / (name + ".hlsl"), text);
+            descs.push_back({ (root / "src" / (name + ".hlsl")).string(), "Main", "cs_6_5", { "ID=" + std::to_string(i) },
+                              { (root / "src").string(), (root / "src" / "inc").string() }, { "-O3" } });
+        }
+    }
+    ~ShaderTree() { std::error_code ec; std::filesystem::remove_all(root, ec); }
+    std::string CacheDir() const { return (root / "cache").string(); }
+};
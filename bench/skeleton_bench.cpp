@@ -0,0 +1,36 @@
+// Hierarchy evaluation: local -> global -> skinning palettes for batches of skeleton instances.
+
+#include "bench_common.h"
+#include "skeleton.h"
+#include "thread_pool.h"
+#include "tinygltf.h"
+
+#include <benchmark/benchmark.h>
+
+static void BM_BuildSkeletonLayout(benchmark::State& state) {
+    BenchRng rng;
+    const Skin skin = MakeRandomSkin<Skin>(uint32_t(state.range(0)), rng);
+    for (auto _ : state) benchmark::DoNotOptimize(BuildSkeletonLayout(skin));
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_BuildSkeletonLayout)->Arg(64)->Arg(512)->Arg(4096);
+
+static void BM_EvaluateSkeletons(benchmark::State& state) {
+    BenchRng rng;
+    const uint32_t bones = uint32_t(state.range(0));
+    const size_t instances = size_t(state.range(1));
+    const SkeletonLayout layout = BuildSkeletonLayout(MakeRandomSkin<Skin>(bones, rng));
+    const auto pose = MakeRandomPalette(bones, rng); // any rigid local transforms will do
+    std::vector<float> locals(instances * bones * 16), globals(locals.size()), skinning(locals.size());
+    for (size_t i = 0; i < instances; ++i) memcpy(&locals[i * bones * 16], pose.data(), pose.size() * sizeof(float));
+    ThreadPool pool;
+    for (auto _ : state) {
+        EvaluateSkeletonInstances(pool, layout, instances, locals.data(), globals.data(), skinning.data());
+        benchmark::DoNotOptimize(skinning.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(instances));
+    state.counters["skeletons/ms"] = benchmark::Counter(double(instances) / 1000.0, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_EvaluateSkeletons)
+    ->ArgsProduct({ { 64, 512 }, { 1, 256, 4096 } })
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
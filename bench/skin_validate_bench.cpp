@@ -0,0 +1,60 @@
+// Skin validation throughput in MB/s of JOINTS_0 + WEIGHTS_0 scanned (report-only, so every
+// iteration sees the same data), single stream per format and whole models across threads.
+
+#include "skin_validate.h"
+#include "synthetic_rig.h"
+#include "thread_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+static const int kJointTypes[]  = { TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT };
+static const int kWeightTypes[] = { TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT };
+
+static void BM_ValidateSkinStreams(benchmark::State& state) {
+    BenchRng rng;
+    const int jointType = kJointTypes[state.range(0)], weightType = kWeightTypes[state.range(1)];
+    const float dirty = state.range(2) / 1000.0f;
+    const tinygltf::Model model = MakeSkinnedModel(1, 1 << 20, jointType, weightType, dirty, 200, rng);
+    const VertexSkinView view = GetSkinStreams(model, model.meshes[0].primitives[0]);
+    SkinValidationOptions options; options.fix = false;
+    SkinIssueCounts c;
+    for (auto _ : state) {
+        c = ValidateSkinStreams(view, 200, options);
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(view.count) * 4 *
+                            (tinygltf::GetComponentSizeInBytes(jointType) + tinygltf::GetComponentSizeInBytes(weightType)));
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(view.count));
+    state.counters["bad_vertices"] = double(c.modified);
+    static const char* jn[] = { "u8", "u16" }; static const char* wn[] = { "f32", "unorm8", "unorm16" };
+    state.SetLabel(std::string("joints ") + jn[state.range(0)] + " weights " + wn[state.range(1)]);
+}
+BENCHMARK(BM_ValidateSkinStreams)->ArgsProduct({ { 0, 1 }, { 0, 1, 2 }, { 0, 10 } })->Unit(benchmark::kMicrosecond);
+
+static void BM_ValidateModelSkins(benchmark::State& state) {
+    BenchRng rng;
+    tinygltf::Model model = MakeSkinnedModel(64, 32 * 1024, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT,
+                                             TINYGLTF_COMPONENT_TYPE_FLOAT, 0.01f, 200, rng);
+    const int threads = int(state.range(0));
+    ThreadPool pool(threads - 1);
+    SkinValidationOptions options; options.fix = false;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        const SkinValidationReport r = ValidateModelSkins(pool, model, options);
+        bytes = r.bytesScanned;
+        benchmark::DoNotOptimize(r.total.modified);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(bytes));
+    state.counters["threads"] = threads;
+}
+BENCHMARK(BM_ValidateModelSkins)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+        const int hw = int(std::max(1u, std::thread::hardware_concurrency()));
+        for (int t = 1; t < hw; t *= 2) b->Arg(t);
+        b->Arg(hw);
+    })
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,61 @@
+// CPU skinning throughput: per-backend kernels and thread scaling of the parallel path.
+// items_per_second is skinned vertices per second.
+
+#include "bench_common.h"
+#include "cpu_skinning.h"
+#include "thread_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <thread>
+
+static constexpr uint32_t kBones = 128;
+
+struct SkinningFixture {
+    SkinningStreams streams; std::vector<float> palette;
+    explicit SkinningFixture(size_t count) {
+        BenchRng rng;
+        auto verts = MakeRandomSkinnedVertices(count, kBones, rng);
+        streams = MakeSkinningStreams(verts.data(), verts.size(), kBones);
+        palette = MakeRandomPalette(kBones, rng);
+    }
+};
+
+static void BM_SkinningKernel(benchmark::State& state) {
+    SkinningFixture f(size_t(state.range(0)));
+    const auto backend = SkinningBackend(state.range(1));
+    SkinnedVertices out;
+    PrepareSkinnedVertices(f.streams, out);
+    for (auto _ : state) {
+        SkinVertexRange(f.streams, f.palette.data(), 0, f.streams.count, out, backend);
+        benchmark::DoNotOptimize(out.px.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(f.streams.count));
+    state.SetLabel(SkinningBackendName(backend == SkinningBackend::Auto ? BestSkinningBackend() : backend));
+}
+BENCHMARK(BM_SkinningKernel)
+    ->ArgsProduct({ { 1 << 14, 1 << 20 },
+                    { int(SkinningBackend::Scalar), int(SkinningBackend::SSE), int(SkinningBackend::AVX2) } })
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_SkinningThreads(benchmark::State& state) {
+    SkinningFixture f(size_t(1) << 20);
+    const int threads = int(state.range(0));
+    ThreadPool pool(threads - 1); // the calling thread runs chunks too
+    SkinnedVertices out;
+    PrepareSkinnedVertices(f.streams, out);
+    for (auto _ : state) {
+        SkinVerticesParallel(pool, f.streams, f.palette.data(), out);
+        benchmark::DoNotOptimize(out.px.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(f.streams.count));
+    state.counters["threads"] = threads;
+}
+BENCHMARK(BM_SkinningThreads)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+        const int hw = int(std::max(1u, std::thread::hardware_concurrency()));
+        for (int t = 1; t < hw; t *= 2) b->Arg(t);
+        b->Arg(hw);
+    })
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,56 @@
+#pragma once
+// On-disk assets for AssetStreamer, shared by asset_streamer_bench and the streamer tests:
+// kStreamAssetCount synthetic rigs in four sizes, each written as a GLB (where tinygltf can
+// write one) and as its raw buffer, which RawDecoder() attaches to the prebuilt model.
+
+#include "asset_streamer.h"
+#include "synthetic_rig.h"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+constexpr uint32_t kStreamAssetCount = 256;
+inline const RigSize kStreamVariants[] = {
+    { "tiny", 8, 1 << 10 }, { "small", 16, 2 << 10 }, { "medium", 32, 4 << 10 }, { "large", 64, 8 << 10 },
+};
+
+struct StreamFixture {
+    std::filesystem::path dir;
+    std::vector<tinygltf::Model> variants;       // buffers[0] holds the raw file contents
+    std::vector<std::string> glbPaths, rawPaths; // asset i is variant i % 4
+    std::map<std::string, uint32_t> variantOfRaw;
+    bool glbWritten = true;
+
+    explicit StreamFixture(const char* name) {
+        dir = std::filesystem::temp_directory_path() / name;
+        std::filesystem::create_directories(dir);
+        BenchRng rng;
+        for (const RigSize& v : kStreamVariants) variants.push_back(MakeSyntheticRig(v, rng));
+        tinygltf::TinyGLTF writer;
+        for (uint32_t i = 0; i < kStreamAssetCount; ++i) {
+            const uint32_t v = i % uint32_t(std::size(kStreamVariants));
+            const std::string base = (dir / ("asset" + std::to_string(i))).string();
+            rawPaths.push_back(base + ".bin");
+            variantOfRaw[rawPaths.back()] = v;
+            const auto& data = variants[v].buffers[0].data;
+            std::ofstream(rawPaths.back(), std::ios::binary).write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+            glbPaths.push_back(base + ".glb");
+            glbWritten = glbWritten && writer.WriteGltfSceneToFile(&variants[v], glbPaths.back(), true, true, false, true);
+        }
+    }
+    ~StreamFixture() { std::error_code ec; std::filesystem::remove_all(dir, ec); }
+
+    AssetDecoder RawDecoder() const {
+        return [this](const std::vector<uint8_t>& bytes, const std::string& path, tinygltf::Model& model, std::string& error) {
+            auto it = variantOfRaw.find(path);
+            if (it == variantOfRaw.end()) { error = "unknown raw asset"; return false; }
+            const tinygltf::Model& v = variants[it->second];
+            if (bytes.size() != v.buffers[0].data.size()) { error = "raw buffer size mismatch"; return false; }
+            model.accessors = v.accessors; model.bufferViews = v.bufferViews; model.meshes = v.meshes;
+            model.nodes = v.nodes; model.skins = v.skins; model.scenes = v.scenes; model.defaultScene = v.defaultScene;
+            model.buffers.resize(1); model.buffers[0].data = bytes;
+            return true;
+        };
+    }
+};
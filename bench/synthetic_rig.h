@@ -0,0 +1,158 @@
+#pragma once
+// Synthetic skinned glTF models shared by the benchmarks and tests.
+
+#include "bench_common.h"
+#include "mat4.h"
+#include "tinygltf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+
+struct RigSize { const char* name; uint32_t bones, vertices; };
+
+// A 4-ary bone tree; each bone owns a (k+1)^2 vertex patch around its bind position, blended
+// between the bone and its parent across the patch. Joints are u8 up to 256 bones, u16 above.
+inline tinygltf::Model MakeSyntheticRig(const RigSize& size, BenchRng& rng) {
+    const uint32_t B = size.bones;
+    uint32_t k = 1; while ((k + 2) * (k + 2) * B <= size.vertices) ++k;
+    const uint32_t patch = (k + 1) * (k + 1), V = patch * B, T = k * k * 2;
+    const bool wideJoints = B > 256;
+    const size_t jsize = wideJoints ? 8 : 4;
+
+    std::vector<float> bind(size_t(B) * 3); // global bind positions (translation-only skeleton)
+    tinygltf::Model model;
+    model.asset.version = "2.0"; model.asset.generator = "grfx_bench";
+    model.nodes.resize(B + 1);
+    for (uint32_t b = 0; b < B; ++b) {
+        tinygltf::Node& n = model.nodes[b];
+        n.name = "bone" + std::to_string(b);
+        const float t[3] = { rng.Uniform(-0.5f, 0.5f), b ? rng.Uniform(0.2f, 0.6f) : 0.0f, rng.Uniform(-0.5f, 0.5f) };
+        n.translation = { t[0], t[1], t[2] };
+        const uint32_t parent = b ? (b - 1) / 4 : 0;
+        if (b) model.nodes[parent].children.push_back(int(b));
+        for (int c = 0; c < 3; ++c) bind[b * 3 + c] = t[c] + (b ? bind[parent * 3 + c] : 0.0f);
+    }
+    model.nodes[B].name = "body"; model.nodes[B].mesh = 0; model.nodes[B].skin = 0;
+    model.scenes.resize(1); model.scenes[0].nodes = { 0, int(B) }; model.defaultScene = 0;
+
+    // one buffer: positions | normals | joints | weights | indices | inverse binds
+    const size_t oPos = 0, oNrm = oPos + size_t(V) * 12, oJnt = oNrm + size_t(V) * 12, oWgt = oJnt + size_t(V) * jsize;
+    const size_t oIdx = oWgt + size_t(V) * 16, oIbm = oIdx + size_t(T) * B * 12, total = oIbm + size_t(B) * 64;
+    tinygltf::Buffer buf; buf.data.resize(total);
+    uint8_t* d = buf.data.data();
+    double lo[3] = { 1e30, 1e30, 1e30 }, hi[3] = { -1e30, -1e30, -1e30 };
+    for (uint32_t b = 0; b < B; ++b) {
+        const uint32_t parent = b ? (b - 1) / 4 : 0;
+        for (uint32_t y = 0; y <= k; ++y)
+            for (uint32_t x = 0; x <= k; ++x) {
+                const size_t v = size_t(b) * patch + y * (k + 1) + x;
+                const float f = float(y) / k;
+                const float p[3] = { bind[b * 3] + 0.2f * (float(x) / k - 0.5f), bind[b * 3 + 1] + 0.2f * (f - 0.5f), bind[b * 3 + 2] + 0.02f * rng.Uniform(-1, 1) };
+                const float n[3] = { 0, 0, 1 };
+                const float w[4] = { 0.5f + 0.5f * f, 0.5f - 0.5f * f, 0, 0 };
+                const uint32_t j[4] = { b, parent, 0, 0 };
+                memcpy(d + oPos + v * 12, p, 12); memcpy(d + oNrm + v * 12, n, 12); memcpy(d + oWgt + v * 16, w, 16);
+                for (int c = 0; c < 4; ++c) {
+                    if (wideJoints) { const uint16_t s = uint16_t(j[c]); memcpy(d + oJnt + v * 8 + c * 2, &s, 2); }
+                    else d[oJnt + v * 4 + c] = uint8_t(j[c]);
+                }
+                for (int c = 0; c < 3; ++c) { lo[c] = std::min(lo[c], double(p[c])); hi[c] = std::max(hi[c], double(p[c])); }
+            }
+        uint32_t* idx = reinterpret_cast<uint32_t*>(d + oIdx) + size_t(b) * T * 3;
+        for (uint32_t y = 0; y < k; ++y)
+            for (uint32_t x = 0; x < k; ++x) {
+                const uint32_t i = b * patch + y * (k + 1) + x, r = k + 1;
+                const uint32_t q[6] = { i, i + 1, i + r, i + 1, i + r + 1, i + r };
+                memcpy(idx, q, sizeof(q)); idx += 6;
+            }
+        float ibm[16]; Mat4Identity(ibm);
+        ibm[12] = -bind[b * 3]; ibm[13] = -bind[b * 3 + 1]; ibm[14] = -bind[b * 3 + 2];
+        memcpy(d + oIbm + size_t(b) * 64, ibm, 64);
+    }
+    model.buffers.push_back(std::move(buf));
+
+    auto addAccessor = [&](size_t offset, size_t count, int componentType, int type, int target) {
+        tinygltf::BufferView view; view.buffer = 0; view.byteOffset = offset; view.target = target;
+        view.byteLength = count * size_t(tinygltf::GetComponentSizeInBytes(componentType) * tinygltf::GetNumComponentsInType(type));
+        model.bufferViews.push_back(view);
+        tinygltf::Accessor acc; acc.bufferView = int(model.bufferViews.size() - 1);
+        acc.componentType = componentType; acc.count = count; acc.type = type;
+        model.accessors.push_back(acc);
+        return int(model.accessors.size() - 1);
+    };
+    tinygltf::Primitive prim; prim.mode = TINYGLTF_MODE_TRIANGLES;
+    prim.attributes["POSITION"] = addAccessor(oPos, V, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, TINYGLTF_TARGET_ARRAY_BUFFER);
+    model.accessors.back().minValues.assign(lo, lo + 3); model.accessors.back().maxValues.assign(hi, hi + 3);
+    prim.attributes["NORMAL"] = addAccessor(oNrm, V, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, TINYGLTF_TARGET_ARRAY_BUFFER);
+    prim.attributes["JOINTS_0"] = addAccessor(oJnt, V, wideJoints ? TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT : TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE,
+                                              TINYGLTF_TYPE_VEC4, TINYGLTF_TARGET_ARRAY_BUFFER);
+    prim.attributes["WEIGHTS_0"] = addAccessor(oWgt, V, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC4, TINYGLTF_TARGET_ARRAY_BUFFER);
+    prim.indices = addAccessor(oIdx, size_t(T) * B * 3, TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT, TINYGLTF_TYPE_SCALAR, TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER);
+    model.meshes.resize(1); model.meshes[0].name = "body"; model.meshes[0].primitives.push_back(prim);
+
+    model.skins.resize(1); model.skins[0].name = "rig"; model.skins[0].skeleton = 0;
+    model.skins[0].inverseBindMatrices = addAccessor(oIbm, B, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_MAT4, 0);
+    for (uint32_t b = 0; b < B; ++b) model.skins[0].joints.push_back(int(b));
+    return model;
+}
+
+// `primitives` skinned primitives of `vertices` each, one buffer per primitive. A `dirty`
+// fraction of vertices gets one of: drifted sum, negative weight, NaN, out-of-range joint.
+inline tinygltf::Model MakeSkinnedModel(size_t primitives, size_t vertices, int jointType, int weightType,
+                                        float dirty, uint32_t jointCount, BenchRng& rng) {
+    tinygltf::Model model;
+    model.skins.resize(1); model.skins[0].joints.resize(jointCount);
+    for (uint32_t j = 0; j < jointCount; ++j) model.skins[0].joints[j] = int(j);
+    model.meshes.resize(primitives);
+    const size_t jsize = size_t(tinygltf::GetComponentSizeInBytes(jointType)) * 4;
+    const size_t wsize = size_t(tinygltf::GetComponentSizeInBytes(weightType)) * 4;
+    for (size_t p = 0; p < primitives; ++p) {
+        tinygltf::Buffer buf; buf.data.resize(vertices * (jsize + wsize));
+        uint8_t* J = buf.data.data(); uint8_t* W = J + vertices * jsize;
+        for (size_t i = 0; i < vertices; ++i) {
+            float w[4], sum = 0; uint32_t j[4];
+            for (int k = 0; k < 4; ++k) { w[k] = rng.Uniform(0.05f, 1.0f); sum += w[k]; j[k] = rng.Next() % jointCount; }
+            for (float& x : w) x /= sum;
+            if (rng.Uniform() < dirty) {
+                switch (rng.Next() % 4) {
+                case 0: w[0] *= 1.5f; break;
+                case 1: w[1] = -w[1]; break;
+                case 2: w[2] = std::numeric_limits<float>::quiet_NaN(); break;
+                default: j[3] = jointCount + 1; break;
+                }
+            }
+            // unorm weights are quantized so clean vertices sum to exactly 255 / 65535, as a compliant exporter writes them
+            const float one = weightType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ? 255.0f : 65535.0f;
+            uint32_t q[4]; int64_t rest = int64_t(one);
+            for (int k = 0; k < 3; ++k) { q[k] = uint32_t(std::lround(std::clamp(w[k], 0.0f, 1.0f) * one)); rest -= q[k]; }
+            q[3] = uint32_t(std::max<int64_t>(rest, 0));
+            for (int k = 0; k < 4; ++k) {
+                if (jointType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) J[i*4 + k] = uint8_t(std::min(j[k], 255u));
+                else { const uint16_t s = uint16_t(std::min(j[k], 65535u)); memcpy(J + i*8 + k*2, &s, 2); }
+                if (weightType == TINYGLTF_COMPONENT_TYPE_FLOAT) memcpy(W + i*16 + k*4, &w[k], 4);
+                else if (weightType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) W[i*4 + k] = uint8_t(q[k]);
+                else { const uint16_t s = uint16_t(q[k]); memcpy(W + i*8 + k*2, &s, 2); }
+            }
+        }
+        const int b = int(model.buffers.size());
+        model.buffers.push_back(std::move(buf));
+        auto addAccessor = [&](size_t offset, size_t size, int componentType, bool normalized) {
+            tinygltf::BufferView view; view.buffer = b; view.byteOffset = offset; view.byteLength = size;
+            model.bufferViews.push_back(view);
+            tinygltf::Accessor acc; acc.bufferView = int(model.bufferViews.size() - 1); acc.componentType = componentType;
+            acc.normalized = normalized; acc.count = vertices; acc.type = TINYGLTF_TYPE_VEC4;
+            model.accessors.push_back(acc);
+            return int(model.accessors.size() - 1);
+        };
+        tinygltf::Primitive prim;
+        prim.attributes["JOINTS_0"] = addAccessor(0, vertices * jsize, jointType, false);
+        prim.attributes["WEIGHTS_0"] = addAccessor(vertices * jsize, vertices * wsize, weightType, weightType != TINYGLTF_COMPONENT_TYPE_FLOAT);
+        model.meshes[p].primitives.push_back(prim);
+        tinygltf::Node node; node.mesh = int(p); node.skin = 0;
+        model.nodes.push_back(node);
+    }
+    return model;
+}
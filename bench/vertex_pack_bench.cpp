@@ -0,0 +1,56 @@
+// Packed vertex encode/decode throughput plus the round-trip report: bytes/vertex and the
+// measured position/normal/weight error of the packed layout.
+
+#include "vertex_pack.h"
+#include "bench_common.h"
+
+#include <benchmark/benchmark.h>
+
+struct PackFixture {
+    MeshletMesh mesh;
+    explicit PackFixture(uint32_t gridSize, uint32_t boneCount) {
+        BenchRng rng; std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+        MakeRandomSkinnedGrid(gridSize, boneCount, rng, verts, indices);
+        mesh = BuildMeshlets(verts, indices);
+    }
+};
+
+static void ReportPackError(benchmark::State& state, const PackFixture& f, const PackedVertices& packed) {
+    const VertexPackError e = MeasureVertexPackError(f.mesh, packed);
+    state.counters["bytes_per_vertex"] = double(packed.BytesPerVertex());
+    state.counters["raw_bytes_per_vertex"] = double(sizeof(VertexIn));
+    state.counters["pos_err"] = e.position;
+    state.counters["pos_bound"] = e.positionBound;
+    state.counters["nrm_err_deg"] = e.normalDegrees;
+    state.counters["wgt_err"] = e.weight;
+}
+
+static void BM_PackVertices(benchmark::State& state) {
+    const PackFixture f(256, 64);
+    const JointFormat joints = state.range(0) ? JointFormat::U16 : JointFormat::U8;
+    PackedVertices packed = PackMeshletVertices(f.mesh, joints);
+    ReportPackError(state, f, packed);
+    for (auto _ : state) {
+        packed = PackMeshletVertices(f.mesh, joints);
+        benchmark::DoNotOptimize(packed.words.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(f.mesh.vertices.size()));
+    state.SetLabel(joints == JointFormat::U16 ? "u16 joints" : "u8 joints");
+}
+BENCHMARK(BM_PackVertices)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void BM_UnpackVertices(benchmark::State& state) {
+    const PackFixture f(256, 64);
+    const JointFormat joints = state.range(0) ? JointFormat::U16 : JointFormat::U8;
+    const PackedVertices packed = PackMeshletVertices(f.mesh, joints);
+    ReportPackError(state, f, packed);
+    std::vector<VertexIn> decoded;
+    for (auto _ : state) {
+        UnpackMeshletVertices(packed, f.mesh.meshlets, decoded);
+        benchmark::DoNotOptimize(decoded.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(f.mesh.vertices.size()));
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(packed.words.size() * sizeof(uint32_t)));
+    state.SetLabel(joints == JointFormat::U16 ? "u16 joints" : "u8 joints");
+}
+BENCHMARK(BM_UnpackVertices)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Compare two grfx_bench JSON results (--benchmark_out_format=json) and flag regressions.
+
+    python scripts/bench_compare.py before.json after.json [--threshold 0.10] [--metric real_time]
+                                     [--allow-missing]
+
+Benchmarks are matched by name. With --benchmark_repetitions the median aggregate is used.
+Exits with 1 when any benchmark slowed down by more than the threshold, errored in the new
+run but not in the old one, or is missing from the new run (unless --allow-missing), so it can
+gate CI.
+"""
+import argparse
+import json
+import sys
+
+UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    with open(path, encoding="utf-8") as f:
+        doc = json.load(f)
+    results, errors, medians = {}, set(), {}
+    for b in doc.get("benchmarks", []):
+        name = b.get("run_name", b["name"])
+        if b.get("error_occurred"):
+            errors.add(name)
+            continue
+        value = b[metric] * UNITS[b.get("time_unit", "ns")]
+        if b.get("run_type") == "aggregate":
+            if b.get("aggregate_name") == "median":
+                medians[name] = value
+        else:
+            results.setdefault(name, value)  # first repetition unless a median exists
+    results.update(medians)
+    return results, errors, doc.get("context", {})
+
+
+def fmt(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.3g} {unit}"
+    return f"{ns:.3g} ns"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("before")
+    ap.add_argument("after")
+    ap.add_argument("--threshold", type=float, default=0.10, help="relative slowdown that fails (default 0.10)")
+    ap.add_argument("--metric", choices=("real_time", "cpu_time"), default="real_time")
+    ap.add_argument("--filter", default="", help="only compare benchmarks whose name contains this")
+    ap.add_argument("--allow-missing", action="store_true",
+                    help="do not fail on benchmarks that are in before but not in after")
+    args = ap.parse_args()
+
+    old, oldErrors, oldCtx = load(args.before, args.metric)
+    new, newErrors, newCtx = load(args.after, args.metric)
+    if oldCtx.get("library_build_type") != newCtx.get("library_build_type") or oldCtx.get("num_cpus") != newCtx.get("num_cpus"):
+        print("warning: runs come from different machines or benchmark builds", file=sys.stderr)
+
+    names = sorted(n for n in set(old) | oldErrors | set(new) | newErrors if args.filter in n)
+    width = max([len(n) for n in names] + [9])
+    print(f"{'benchmark':<{width}}  {'before':>10}  {'after':>10}  {'change':>8}")
+    failures = 0
+    for name in names:
+        if name in newErrors and name not in oldErrors:
+            print(f"{name:<{width}}  {'':>10}  {'ERROR':>10}  {'':>8}  <-- new error")
+            failures += 1
+            continue
+        if name in newErrors:
+            print(f"{name:<{width}}  error in both runs")
+            continue
+        if name not in new:
+            if args.allow_missing:
+                print(f"{name:<{width}}  only in before")
+            else:
+                print(f"{name:<{width}}  {'':>10}  {'MISSING':>10}  {'':>8}  <-- missing")
+                failures += 1
+            continue
+        if name not in old:
+            print(f"{name:<{width}}  only in after")
+            continue
+        change = new[name] / old[name] - 1.0 if old[name] > 0 else 0.0
+        mark = ""
+        if change > args.threshold:
+            mark = "  <-- regression"
+            failures += 1
+        elif change < -args.threshold:
+            mark = "  (faster)"
+        print(f"{name:<{width}}  {fmt(old[name]):>10}  {fmt(new[name]):>10}  {change:>+7.1%}{mark}")
+
+    print(f"\n{failures} failure(s), regression threshold {args.threshold:.0%} in {args.metric}")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
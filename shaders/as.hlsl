@@ -1,7 +1,54 @@
-﻿struct ASPayload { uint dummy; };
+﻿#include "common.hlsli"
 
-[numthreads(1,1,1)]
-void ASMain(in uint gtid : SV_GroupThreadID, out ASPayload payload)
+StructuredBuffer<MeshletData>   gMeshlets      : register(t2);
+StructuredBuffer<uint>          gBoneRemap     : register(t4);
+StructuredBuffer<InstanceData>  gInstances     : register(t6);
+StructuredBuffer<MeshletBounds> gMeshletBounds : register(t7);
+
+groupshared Payload sPayload;
+groupshared uint sCount;
+
+// Mirrors CullMeshlet in src/crowd.cpp: bounds follow the meshlet's dominant bone.
+bool IsVisible(uint instance, uint meshlet)
+{
+    InstanceData inst = gInstances[instance];
+    MeshletBounds b = gMeshletBounds[meshlet];
+    MeshletData m = gMeshlets[meshlet];
+    float4x4 toWorld = mul(inst.world, BoneMatrix(inst.paletteOffset + gBoneRemap[m.boneBase + b.dominantBone]));
+
+    if (gCullFlags & CULL_FRUSTUM)
+    {
+        float3 c = mul(toWorld, float4(b.center, 1)).xyz;
+        float scale = sqrt(max(dot(toWorld._11_21_31, toWorld._11_21_31),
+                           max(dot(toWorld._12_22_32, toWorld._12_22_32), dot(toWorld._13_23_33, toWorld._13_23_33))));
+        float r = b.radius * scale + inst.boundsPadding;
+        [unroll] for (uint p = 0; p < 6; ++p)
+            if (dot(gFrustum[p].xyz, c) + gFrustum[p].w < -r) return false;
+    }
+    if ((gCullFlags & CULL_CONES) && b.coneCutoff < 1)
+    {
+        float3 apex = mul(toWorld, float4(b.coneApex, 1)).xyz;
+        float3 axis = normalize(mul((float3x3)toWorld, b.coneAxis));
+        if (dot(normalize(apex - gCameraPos), axis) >= b.coneCutoff) return false;
+    }
+    return true;
+}
+
+// One thread per (instance, meshlet) pair; survivors are compacted into the payload and
+// launch one mesh group each.
+[numthreads(AS_GROUP_SIZE,1,1)]
+void ASMain(in uint gtid : SV_GroupThreadID, in uint dtid : SV_DispatchThreadID)
 {
-    DispatchMesh(1,1,1, payload);
+    if (gtid == 0) sCount = 0;
+    GroupMemoryBarrierWithGroupSync();
+
+    uint instance = dtid / gMeshletCount, meshlet = dtid % gMeshletCount;
+    if (instance < gInstanceCount && IsVisible(instance, meshlet))
+    {
+        uint slot; InterlockedAdd(sCount, 1, slot);
+        sPayload.instance[slot] = instance; sPayload.meshlet[slot] = meshlet;
+    }
+
+    GroupMemoryBarrierWithGroupSync();
+    DispatchMesh(sCount, 1, 1, sPayload);
 }
@@ -0,0 +1,58 @@
+﻿// Declarations shared by the amplification and mesh shaders. CPU mirrors live in src/mesh_types.h.
+
+struct VertexIn { float3 pos; float3 nrm; uint4 boneIdx; float4 boneWgt; };
+struct MeshletData { uint vCount, pCount; uint vOffset, pOffset; uint boneBase; };
+struct MeshletQuant { float3 boundsMin; float3 boundsScale; };
+
+struct MeshletBounds { float3 center; float radius; float3 coneAxis; float coneCutoff; float3 coneApex; uint dominantBone; };
+struct InstanceData { float4x4 world; uint paletteOffset; float boundsPadding; uint2 _pad; };
+
+#define AS_GROUP_SIZE 64 // (instance, meshlet) pairs tested per amplification group
+struct Payload { uint instance[AS_GROUP_SIZE]; uint meshlet[AS_GROUP_SIZE]; };
+
+#define CULL_FRUSTUM 1
+#define CULL_CONES   2
+
+// gBones encoding (src/bone_palette.h PaletteFormat): float4x4, three affine float4 rows, or a
+// unit dual quaternion (real, dual) for rigid bones.
+#define PALETTE_MAT4X4   0
+#define PALETTE_MAT3X4   1
+#define PALETTE_DUALQUAT 2
+#ifndef PALETTE_FORMAT
+#define PALETTE_FORMAT PALETTE_MAT4X4
+#endif
+
+#if PALETTE_FORMAT == PALETTE_MAT4X4
+StructuredBuffer<float4x4> gBones : register(t3);
+#else
+StructuredBuffer<float4>   gBones : register(t3); // 3 (rows) or 2 (dual quaternion) per bone
+#endif
+
+float3 QuatRotate(float4 r, float3 v) { return v + 2 * cross(r.xyz, cross(r.xyz, v) + r.w * v); }
+float3 DualQuatTranslation(float4 r, float4 d) { return 2 * (r.w * d.xyz - d.w * r.xyz + cross(r.xyz, d.xyz)); }
+
+// Skinning matrix of palette entry i.
+float4x4 BoneMatrix(uint i)
+{
+#if PALETTE_FORMAT == PALETTE_MAT4X4
+    return gBones[i];
+#elif PALETTE_FORMAT == PALETTE_MAT3X4
+    return float4x4(gBones[i * 3], gBones[i * 3 + 1], gBones[i * 3 + 2], float4(0, 0, 0, 1));
+#else
+    float4 r = gBones[i * 2];
+    float3 t = DualQuatTranslation(r, gBones[i * 2 + 1]);
+    float3 c0 = QuatRotate(r, float3(1, 0, 0)), c1 = QuatRotate(r, float3(0, 1, 0)), c2 = QuatRotate(r, float3(0, 0, 1));
+    return float4x4(c0.x, c1.x, c2.x, t.x,
+                    c0.y, c1.y, c2.y, t.y,
+                    c0.z, c1.z, c2.z, t.z,
+                    0,    0,    0,    1);
+#endif
+}
+
+cbuffer Globals : register(b0)
+{
+    float4x4 gViewProj;
+    float4   gFrustum[6];   // world-space planes, inside: dot(xyz, p) + w >= 0
+    float3   gCameraPos; float gTime;
+    uint     gMeshletCount; uint gInstanceCount; uint gCullFlags; uint _pad;
+}
@@ -1,47 +1,130 @@
-﻿struct VertexIn { float3 pos; float3 nrm; uint4 boneIdx; float4 boneWgt; };
-struct MeshletData { uint vCount, pCount; uint vOffset, pOffset; uint boneBase; };
+﻿#include "common.hlsli"
 
-StructuredBuffer<VertexIn>      gVertices : register(t0);
-StructuredBuffer(uint3)         gTris     : register(t1);
-StructuredBuffer<MeshletData>   gMeshlets : register(t2);
-StructuredBuffer(float4x4)      gBones    : register(t3);
+#ifndef PACKED_VERTICES
+#define PACKED_VERTICES 0
+#endif
+#ifndef PACKED_JOINTS16
+#define PACKED_JOINTS16 0
+#endif
 
-cbuffer Globals : register(b0) { float4x4 gMVP; float gTime; float3 _pad; }
+#if PACKED_VERTICES
+// src/vertex_pack.h layout: 5 words per vertex (u8 joints) or 6 (u16 joints)
+ByteAddressBuffer               gVertices  : register(t0);
+StructuredBuffer<MeshletQuant>  gQuant     : register(t5);
+#define PACKED_STRIDE (PACKED_JOINTS16 ? 24 : 20)
+#else
+StructuredBuffer<VertexIn>      gVertices  : register(t0);
+#endif
+StructuredBuffer<uint3>         gTris      : register(t1);
+StructuredBuffer<MeshletData>   gMeshlets  : register(t2);
+StructuredBuffer<uint>          gBoneRemap : register(t4); // meshlet-local bone -> palette index
+StructuredBuffer<InstanceData>  gInstances : register(t6);
 
 struct VSOut { float4 posH : SV_Position; float3 nrmW : NORMAL; float3 col : COLOR0; };
 
+uint PaletteIndex(InstanceData inst, MeshletData m, uint localBone) { return inst.paletteOffset + gBoneRemap[m.boneBase + localBone]; }
+
+// Bone-space position and normal of a vertex; mirrors SkinVertexReference in src/bone_palette.cpp.
+void SkinVertex(InstanceData inst, MeshletData m, VertexIn vin, out float3 p, out float3 n)
+{
+    uint4 b = uint4(PaletteIndex(inst, m, vin.boneIdx.x), PaletteIndex(inst, m, vin.boneIdx.y),
+                    PaletteIndex(inst, m, vin.boneIdx.z), PaletteIndex(inst, m, vin.boneIdx.w));
+#if PALETTE_FORMAT == PALETTE_DUALQUAT
+    // dual-quaternion linear blending, every influence flipped into the first one's hemisphere
+    float4 r0 = gBones[b.x * 2], br = 0, bd = 0;
+    [unroll] for (uint k = 0; k < 4; ++k)
+    {
+        float4 r = gBones[b[k] * 2], d = gBones[b[k] * 2 + 1];
+        float w = dot(r, r0) < 0 ? -vin.boneWgt[k] : vin.boneWgt[k];
+        br += w * r; bd += w * d;
+    }
+    float inv = rsqrt(dot(br, br)); br *= inv; bd *= inv;
+    p = QuatRotate(br, vin.pos) + DualQuatTranslation(br, bd);
+    n = QuatRotate(br, vin.nrm);
+#elif PALETTE_FORMAT == PALETTE_MAT3X4
+    // 4-influence LBS over the affine rows
+    float4 r0 = 0, r1 = 0, r2 = 0;
+    [unroll] for (uint k = 0; k < 4; ++k)
+    {
+        r0 += vin.boneWgt[k] * gBones[b[k] * 3]; r1 += vin.boneWgt[k] * gBones[b[k] * 3 + 1]; r2 += vin.boneWgt[k] * gBones[b[k] * 3 + 2];
+    }
+    p = float3(dot(r0, float4(vin.pos, 1)), dot(r1, float4(vin.pos, 1)), dot(r2, float4(vin.pos, 1)));
+    n = normalize(float3(dot(r0.xyz, vin.nrm), dot(r1.xyz, vin.nrm), dot(r2.xyz, vin.nrm)));
+#else
+    // 4-influence LBS
+    float4x4 B = vin.boneWgt.x * gBones[b.x] + vin.boneWgt.y * gBones[b.y] + vin.boneWgt.z * gBones[b.z] + vin.boneWgt.w * gBones[b.w];
+    p = mul(B, float4(vin.pos, 1)).xyz;
+    n = normalize(mul((float3x3)B, vin.nrm));
+#endif
+}
+
+#if PACKED_VERTICES
+float3 OctDecode(float2 e)
+{
+    float3 n = float3(e, 1 - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.xy -= t * (2 * step(0, n.xy) - 1);
+    return normalize(n);
+}
+
+float2 Snorm16(uint2 v) { return max(float2(int2(v << 16) >> 16) / 32767.0, -1.0); }
+
+VertexIn LoadVertex(uint meshlet, uint index)
+{
+    uint addr = index * PACKED_STRIDE;
+    uint4 w = gVertices.Load4(addr);
+    MeshletQuant q = gQuant[meshlet];
+    VertexIn v;
+    v.pos = q.boundsMin + float3(w.x & 0xFFFF, w.x >> 16, w.y & 0xFFFF) * q.boundsScale;
+    v.nrm = OctDecode(Snorm16(uint2(w.y >> 16, w.z)));
+    v.boneWgt = float4(w.w & 0xFF, (w.w >> 8) & 0xFF, (w.w >> 16) & 0xFF, w.w >> 24) / 255.0;
+#if PACKED_JOINTS16
+    uint2 j = gVertices.Load2(addr + 16);
+    v.boneIdx = uint4(j.x & 0xFFFF, j.x >> 16, j.y & 0xFFFF, j.y >> 16);
+#else
+    uint j = gVertices.Load(addr + 16);
+    v.boneIdx = uint4(j & 0xFF, (j >> 8) & 0xFF, (j >> 16) & 0xFF, j >> 24);
+#endif
+    return v;
+}
+#else
+VertexIn LoadVertex(uint meshlet, uint index) { return gVertices[index]; }
+#endif
+
 [outputtopology("triangle")]
 [numthreads(64,1,1)]
 void MSMain(in uint gtid : SV_GroupThreadID,
+            in uint gid  : SV_GroupID,
+            in payload Payload payload,
             out vertices VSOut vOut[256],
             out indices  uint3  pOut[256])
 {
-    MeshletData m = gMeshlets[0];
+    // each group draws one (instance, meshlet) pair that survived ASMain's cull
+    uint meshlet = payload.meshlet[gid];
+    InstanceData inst = gInstances[payload.instance[gid]];
+    MeshletData m = gMeshlets[meshlet];
     if (gtid == 0) SetMeshOutputCounts(m.vCount, m.pCount);
     GroupMemoryBarrierWithGroupSync();
 
-    if (gtid < m.vCount)
+    // meshlets may hold up to 256 vertices/primitives: each thread covers every 64th one
+    for (uint v = gtid; v < m.vCount; v += 64)
     {
-        VertexIn vin = gVertices[m.vOffset + gtid];
-        // 2-bone LBS for demo. For real content, use the vin.boneIdx to index gBones.
-        float4x4 B0 = gBones[0];
-        float4x4 B1 = gBones[1];
-
-        float4 p = float4(vin.pos, 1);
-        float3 n = vin.nrm;
+        VertexIn vin = LoadVertex(meshlet, m.vOffset + v);
+        // boneIdx is local to the meshlet's slice of gBoneRemap
+        float3 p, n; SkinVertex(inst, m, vin, p, n);
 
-        float4 skP = vin.boneWgt.x * mul(B0, p) + vin.boneWgt.y * mul(B1, p);
-        float3 skN = normalize(vin.boneWgt.x * mul((float3x3)B0, n) + vin.boneWgt.y * mul((float3x3)B1, n));
+        float4 skP = mul(inst.world, float4(p, 1));
+        float3 skN = normalize(mul((float3x3)inst.world, n));
 
-        VSOut o; o.posH = mul(gMVP, skP); o.nrmW = skN; o.col = 0.5 + 0.5*skN;
-        vOut[gtid] = o;
+        VSOut o; o.posH = mul(gViewProj, skP); o.nrmW = skN; o.col = 0.5 + 0.5*skN;
+        vOut[v] = o;
     }
 
     GroupMemoryBarrierWithGroupSync();
 
-    if (gtid < m.pCount)
+    for (uint p = gtid; p < m.pCount; p += 64)
     {
-        uint3 tri = gTris[m.pOffset + gtid];
-        pOut[gtid] = tri;
+        uint3 tri = gTris[m.pOffset + p];
+        pOut[p] = tri;
     }
 }
@@ -0,0 +1,256 @@
+#include "animation.h"
+#include "skeleton.h"
+#include "tinygltf.h"
+#include "mat4.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+ClipView ViewOf(const AnimationClip& clip) {
+    ClipView v;
+    v.tracks = clip.tracks.data(); v.trackCount = clip.tracks.size();
+    v.times = clip.times.data(); v.values = clip.values.data(); v.qvalues = clip.qvalues.data();
+    v.duration = clip.duration; v.boneCount = clip.boneCount;
+    return v;
+}
+
+static void RestTRS(const tinygltf::Node& node, float t[3], float q[4], float s[3]) {
+    t[0] = t[1] = t[2] = 0; q[0] = q[1] = q[2] = 0; q[3] = 1; s[0] = s[1] = s[2] = 1;
+    if (node.matrix.size() == 16) {
+        float m[16]; for (int i = 0; i < 16; ++i) m[i] = float(node.matrix[i]);
+        for (int c = 0; c < 3; ++c) {
+            t[c] = m[12 + c];
+            s[c] = std::sqrt(m[c*4]*m[c*4] + m[c*4 + 1]*m[c*4 + 1] + m[c*4 + 2]*m[c*4 + 2]);
+            if (s[c] > 0) for (int r = 0; r < 3; ++r) m[c*4 + r] /= s[c];
+        }
+        Mat3ToQuat(m, q);
+        return;
+    }
+    if (node.translation.size() == 3) for (int i = 0; i < 3; ++i) t[i] = float(node.translation[i]);
+    if (node.rotation.size() == 4)    for (int i = 0; i < 4; ++i) q[i] = float(node.rotation[i]);
+    if (node.scale.size() == 3)       for (int i = 0; i < 3; ++i) s[i] = float(node.scale[i]);
+}
+
+static void AppendConstantTrack(AnimationClip& clip, uint32_t slot, AnimPath path, const float* v, int comps) {
+    AnimTrack tr{};
+    tr.slot = slot; tr.path = uint8_t(path); tr.interp = uint8_t(AnimInterp::Step);
+    tr.encoding = uint8_t(TrackEncoding::Constant); tr.comps = uint8_t(comps); tr.keyCount = 1;
+    tr.valueOffset = uint32_t(clip.values.size());
+    clip.values.insert(clip.values.end(), v, v + comps);
+    clip.tracks.push_back(tr);
+}
+
+AnimationClip BuildAnimationClip(const tinygltf::Model& model, int animationIndex, const SkeletonLayout& layout) {
+    const auto& anim = model.animations[animationIndex];
+    AnimationClip clip; clip.name = anim.name; clip.boneCount = uint32_t(layout.BoneCount());
+
+    std::unordered_map<int, uint32_t> nodeToSlot, timeOffsets; // node -> slot, input accessor -> times offset
+    for (size_t s = 0; s < layout.BoneCount(); ++s) nodeToSlot[layout.node[s]] = uint32_t(s);
+    std::vector<uint8_t> covered(layout.BoneCount() * 3, 0);
+    std::vector<float> scratch;
+
+    for (const auto& ch : anim.channels) {
+        auto slot = nodeToSlot.find(ch.target_node);
+        if (slot == nodeToSlot.end()) continue;
+        AnimPath path; int comps;
+        if      (ch.target_path == "translation") { path = AnimPath::Translation; comps = 3; }
+        else if (ch.target_path == "rotation")    { path = AnimPath::Rotation;    comps = 4; }
+        else if (ch.target_path == "scale")       { path = AnimPath::Scale;       comps = 3; }
+        else continue; // morph weights are not bone animation
+        const auto& smp = anim.samplers.at(ch.sampler);
+        const AnimInterp interp = smp.interpolation == "STEP" ? AnimInterp::Step
+                                : smp.interpolation == "CUBICSPLINE" ? AnimInterp::CubicSpline : AnimInterp::Linear;
+
+        auto times = timeOffsets.find(smp.input);
+        if (times == timeOffsets.end()) {
+            ReadAccessorFloats(model, smp.input, 1, scratch);
+            times = timeOffsets.emplace(smp.input, uint32_t(clip.times.size())).first;
+            clip.times.insert(clip.times.end(), scratch.begin(), scratch.end());
+        }
+        const uint32_t keyCount = uint32_t(model.accessors[smp.input].count);
+        const size_t expected = size_t(keyCount) * comps * (interp == AnimInterp::CubicSpline ? 3 : 1);
+        ReadAccessorFloats(model, smp.output, comps, scratch);
+        if (keyCount == 0 || scratch.size() < expected) throw std::runtime_error("Animation sampler output/input count mismatch");
+
+        AnimTrack tr{};
+        tr.slot = slot->second; tr.path = uint8_t(path); tr.interp = uint8_t(interp);
+        tr.encoding = uint8_t(TrackEncoding::Float); tr.comps = uint8_t(comps); tr.keyCount = keyCount;
+        tr.timeOffset = times->second; tr.valueOffset = uint32_t(clip.values.size());
+        clip.values.insert(clip.values.end(), scratch.begin(), scratch.begin() + expected);
+        clip.tracks.push_back(tr);
+        clip.duration = std::max(clip.duration, clip.times[tr.timeOffset + keyCount - 1]);
+        covered[tr.slot * 3 + uint32_t(path)] = 1;
+    }
+
+    // bones/paths without a channel hold their rest value
+    for (uint32_t s = 0; s < clip.boneCount; ++s) {
+        if (covered[s*3] && covered[s*3 + 1] && covered[s*3 + 2]) continue;
+        float t[3], q[4], sc[3];
+        if (layout.node[s] >= 0 && layout.node[s] < (int)model.nodes.size()) RestTRS(model.nodes[layout.node[s]], t, q, sc);
+        else { t[0] = t[1] = t[2] = 0; q[0] = q[1] = q[2] = 0; q[3] = 1; sc[0] = sc[1] = sc[2] = 1; }
+        if (!covered[s*3])     AppendConstantTrack(clip, s, AnimPath::Translation, t, 3);
+        if (!covered[s*3 + 1]) AppendConstantTrack(clip, s, AnimPath::Rotation, q, 4);
+        if (!covered[s*3 + 2]) AppendConstantTrack(clip, s, AnimPath::Scale, sc, 3);
+    }
+    return clip;
+}
+
+AnimationClip CompressClip(const AnimationClip& clip, const ClipCompression& options) {
+    AnimationClip out; out.name = clip.name; out.duration = clip.duration; out.boneCount = clip.boneCount;
+    std::unordered_map<uint32_t, uint32_t> timeRemap;
+    auto remapTimes = [&](const AnimTrack& tr) {
+        auto it = timeRemap.find(tr.timeOffset);
+        if (it != timeRemap.end()) return it->second;
+        const uint32_t offset = uint32_t(out.times.size());
+        out.times.insert(out.times.end(), clip.times.begin() + tr.timeOffset, clip.times.begin() + tr.timeOffset + tr.keyCount);
+        return timeRemap[tr.timeOffset] = offset;
+    };
+
+    for (const AnimTrack& src : clip.tracks) {
+        AnimTrack tr = src;
+        const TrackEncoding enc = TrackEncoding(src.encoding);
+        if (enc == TrackEncoding::Quant16) { // already compressed
+            tr.timeOffset = remapTimes(src); tr.valueOffset = uint32_t(out.qvalues.size());
+            const size_t n = size_t(src.keyCount) * src.comps * (src.interp == uint8_t(AnimInterp::CubicSpline) ? 3 : 1);
+            out.qvalues.insert(out.qvalues.end(), clip.qvalues.begin() + src.valueOffset, clip.qvalues.begin() + src.valueOffset + n);
+            out.tracks.push_back(tr); continue;
+        }
+        if (enc == TrackEncoding::Constant) {
+            tr.valueOffset = uint32_t(out.values.size());
+            out.values.insert(out.values.end(), clip.values.begin() + src.valueOffset, clip.values.begin() + src.valueOffset + src.comps);
+            out.tracks.push_back(tr); continue;
+        }
+
+        const bool cubic = src.interp == uint8_t(AnimInterp::CubicSpline);
+        const uint32_t perKey = cubic ? 3 : 1, comps = src.comps;
+        const float* v = &clip.values[src.valueOffset];
+        const size_t elements = size_t(src.keyCount) * perKey;
+
+        // constant elision: every key equals key 0 and (cubic) every tangent is zero
+        const float* first = v + (cubic ? comps : 0);
+        bool constant = true;
+        for (size_t e = 0; e < elements && constant; ++e) {
+            const bool tangent = cubic && e % 3 != 1;
+            for (uint32_t c = 0; c < comps; ++c)
+                if (std::abs(v[e*comps + c] - (tangent ? 0.0f : first[c])) > options.constantTolerance) { constant = false; break; }
+        }
+        if (constant) {
+            tr.encoding = uint8_t(TrackEncoding::Constant); tr.interp = uint8_t(AnimInterp::Step);
+            tr.keyCount = 1; tr.timeOffset = 0; tr.valueOffset = uint32_t(out.values.size());
+            out.values.insert(out.values.end(), first, first + comps);
+        } else if (options.quantize) {
+            tr.encoding = uint8_t(TrackEncoding::Quant16);
+            tr.timeOffset = remapTimes(src); tr.valueOffset = uint32_t(out.qvalues.size());
+            for (uint32_t c = 0; c < comps; ++c) {
+                float lo = v[c], hi = v[c];
+                for (size_t e = 1; e < elements; ++e) { lo = std::min(lo, v[e*comps + c]); hi = std::max(hi, v[e*comps + c]); }
+                tr.rangeMin[c] = lo; tr.rangeExtent[c] = hi - lo;
+            }
+            for (size_t e = 0; e < elements; ++e)
+                for (uint32_t c = 0; c < comps; ++c) {
+                    const float ext = tr.rangeExtent[c];
+                    const float n = ext > 0 ? (v[e*comps + c] - tr.rangeMin[c]) / ext : 0.0f;
+                    out.qvalues.push_back(uint16_t(std::lround(std::clamp(n, 0.0f, 1.0f) * 65535.0f)));
+                }
+        } else {
+            tr.timeOffset = remapTimes(src); tr.valueOffset = uint32_t(out.values.size());
+            out.values.insert(out.values.end(), v, v + elements * comps);
+        }
+        out.tracks.push_back(tr);
+    }
+    return out;
+}
+
+size_t ClipMemoryBytes(const AnimationClip& clip) {
+    return clip.tracks.size() * sizeof(AnimTrack) + clip.times.size() * sizeof(float)
+         + clip.values.size() * sizeof(float) + clip.qvalues.size() * sizeof(uint16_t);
+}
+
+void ResetSampler(ClipSampler& sampler, const ClipView& clip) {
+    sampler.cursor.assign(clip.trackCount, 0);
+    sampler.translation.assign(size_t(clip.boneCount) * 3, 0.0f);
+    sampler.scale.assign(size_t(clip.boneCount) * 3, 1.0f);
+    sampler.rotation.assign(size_t(clip.boneCount) * 4, 0.0f);
+    for (uint32_t s = 0; s < clip.boneCount; ++s) sampler.rotation[s*4 + 3] = 1.0f;
+}
+
+static void FetchKey(const ClipView& clip, const AnimTrack& tr, uint32_t element, float out[4]) {
+    const size_t base = tr.valueOffset + size_t(element) * tr.comps;
+    if (tr.encoding == uint8_t(TrackEncoding::Quant16))
+        for (int c = 0; c < tr.comps; ++c) out[c] = tr.rangeMin[c] + clip.qvalues[base + c] * (tr.rangeExtent[c] * (1.0f / 65535.0f));
+    else
+        for (int c = 0; c < tr.comps; ++c) out[c] = clip.values[base + c];
+}
+
+// Key k with times[k] <= t < times[k+1], clamped to [0, n-2]. Forward playback moves the cached
+// cursor by a key or two; anything else is a binary search.
+static uint32_t FindKey(const float* times, uint32_t n, float t, uint32_t& cursor) {
+    uint32_t k = std::min(cursor, n - 2);
+    if (t >= times[k]) {
+        for (int step = 0; step < 4 && k + 2 < n && t >= times[k + 1]; ++step) ++k;
+        if (k + 2 >= n || t < times[k + 1]) return cursor = k;
+    }
+    const uint32_t ub = uint32_t(std::upper_bound(times, times + n, t) - times);
+    return cursor = std::min(ub ? ub - 1 : 0u, n - 2);
+}
+
+static void Slerp(const float a[4], const float bIn[4], float u, float out[4]) {
+    float b[4] = { bIn[0], bIn[1], bIn[2], bIn[3] };
+    float d = a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3];
+    if (d < 0) { d = -d; for (float& c : b) c = -c; } // shortest arc
+    float wa = 1 - u, wb = u;
+    if (d < 0.9995f) {
+        const float theta = std::acos(d), s = std::sin(theta);
+        wa = std::sin(wa * theta) / s; wb = std::sin(wb * theta) / s;
+    }
+    for (int c = 0; c < 4; ++c) out[c] = wa * a[c] + wb * b[c];
+}
+
+void SampleClip(const ClipView& clip, float time, ClipSampler& sampler, float* localMatrices) {
+    if (sampler.cursor.size() != clip.trackCount) ResetSampler(sampler, clip);
+    for (size_t i = 0; i < clip.trackCount; ++i) {
+        const AnimTrack& tr = clip.tracks[i];
+        const bool cubic = tr.interp == uint8_t(AnimInterp::CubicSpline);
+        float v[4] = { 0, 0, 0, 1 };
+        if (tr.keyCount <= 1) FetchKey(clip, tr, (cubic && tr.encoding != uint8_t(TrackEncoding::Constant)) ? 1 : 0, v);
+        else {
+            const float* times = clip.times + tr.timeOffset;
+            const uint32_t k = FindKey(times, tr.keyCount, time, sampler.cursor[i]);
+            const float td = times[k + 1] - times[k];
+            const float u = td > 0 ? std::clamp((time - times[k]) / td, 0.0f, 1.0f) : 0.0f;
+            float a[4], b[4];
+            switch (AnimInterp(tr.interp)) {
+            case AnimInterp::Step:
+                FetchKey(clip, tr, u >= 1.0f ? k + 1 : k, v);
+                break;
+            case AnimInterp::Linear:
+                FetchKey(clip, tr, k, a); FetchKey(clip, tr, k + 1, b);
+                if (tr.path == uint8_t(AnimPath::Rotation)) Slerp(a, b, u, v);
+                else for (int c = 0; c < tr.comps; ++c) v[c] = a[c] + (b[c] - a[c]) * u;
+                break;
+            case AnimInterp::CubicSpline: {
+                float outTangent[4], inTangent[4];
+                FetchKey(clip, tr, 3*k + 1, a); FetchKey(clip, tr, 3*k + 2, outTangent);
+                FetchKey(clip, tr, 3*(k + 1), inTangent); FetchKey(clip, tr, 3*(k + 1) + 1, b);
+                const float u2 = u*u, u3 = u2*u;
+                const float h00 = 2*u3 - 3*u2 + 1, h10 = (u3 - 2*u2 + u) * td, h01 = -2*u3 + 3*u2, h11 = (u3 - u2) * td;
+                for (int c = 0; c < tr.comps; ++c) v[c] = h00*a[c] + h10*outTangent[c] + h01*b[c] + h11*inTangent[c];
+                break;
+            }
+            }
+        }
+        float* dst = tr.path == uint8_t(AnimPath::Translation) ? &sampler.translation[tr.slot * 3]
+                   : tr.path == uint8_t(AnimPath::Rotation)    ? &sampler.rotation[tr.slot * 4]
+                                                                : &sampler.scale[tr.slot * 3];
+        for (int c = 0; c < tr.comps; ++c) dst[c] = v[c];
+    }
+
+    for (uint32_t s = 0; s < clip.boneCount; ++s) {
+        float* q = &sampler.rotation[s * 4];
+        const float len = std::sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+        if (len > 0) for (int c = 0; c < 4; ++c) q[c] /= len; // slerp/cubic/quantization drift
+        ComposeTRS(&sampler.translation[s * 3], q, &sampler.scale[s * 3], localMatrices + size_t(s) * 16);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+// Animation clips sampled into local bone matrices for a SkeletonLayout.
+//
+// A clip stores one track per (bone slot, path). Keyframe data lives in clip-wide flat arrays
+// and tracks refer to it by offset, so a clip can also be viewed straight out of a cooked pack
+// (see ClipView). Tracks are Float (raw glTF keys), Quant16 (16-bit per component over the
+// track's range) or Constant (a single key; also used for bones/paths without a channel).
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tinygltf { class Model; }
+struct SkeletonLayout;
+
+enum class AnimPath : uint8_t { Translation, Rotation, Scale };
+enum class AnimInterp : uint8_t { Step, Linear, CubicSpline };
+enum class TrackEncoding : uint8_t { Float, Quant16, Constant };
+
+struct AnimTrack {
+    uint32_t slot;           // SkeletonLayout slot
+    uint8_t  path, interp, encoding, comps; // AnimPath, AnimInterp, TrackEncoding, 3 or 4
+    uint32_t keyCount;
+    uint32_t timeOffset;     // into times (keyCount floats)
+    uint32_t valueOffset;    // into values (Float/Constant) or qvalues (Quant16), in components
+    float    rangeMin[4];    // Quant16: value = rangeMin + q * rangeExtent / 65535
+    float    rangeExtent[4];
+};
+
+struct AnimationClip {
+    std::string name;
+    float duration = 0.0f;
+    uint32_t boneCount = 0;
+    std::vector<AnimTrack> tracks;
+    std::vector<float> times;
+    std::vector<float> values;     // CUBICSPLINE keys store (in-tangent, value, out-tangent)
+    std::vector<uint16_t> qvalues;
+};
+
+struct ClipView {
+    const AnimTrack* tracks = nullptr; size_t trackCount = 0;
+    const float* times = nullptr;
+    const float* values = nullptr;
+    const uint16_t* qvalues = nullptr;
+    float duration = 0.0f;
+    uint32_t boneCount = 0;
+};
+
+ClipView ViewOf(const AnimationClip& clip);
+
+AnimationClip BuildAnimationClip(const tinygltf::Model& model, int animationIndex, const SkeletonLayout& layout);
+
+// Quant16 keys round to the nearest of 65536 steps over each component's range, so every key is
+// within rangeExtent / 131070 of the source (plus float rounding); linear blends of them stay
+// within that bound, rotations until renormalization.
+struct ClipCompression {
+    float constantTolerance = 1e-5f; // tracks whose keys all match within this collapse to Constant
+    bool  quantize = true;           // remaining Float tracks become Quant16
+};
+AnimationClip CompressClip(const AnimationClip& clip, const ClipCompression& options = {});
+size_t ClipMemoryBytes(const AnimationClip& clip);
+
+// Per-instance playback state: a cached key cursor per track makes forward playback O(1);
+// jumps (seeks, loops) fall back to a binary search.
+struct ClipSampler {
+    std::vector<uint32_t> cursor;
+    std::vector<float> translation, rotation, scale; // 3/4/3 floats per slot
+};
+void ResetSampler(ClipSampler& sampler, const ClipView& clip);
+
+// Samples the clip at `time` (clamped to the key range) into 16 floats per slot.
+void SampleClip(const ClipView& clip, float time, ClipSampler& sampler, float* localMatrices);
@@ -0,0 +1,364 @@
+#include "asset_streamer.h"
+#include "crowd.h"
+#include "profiler.h"
+#include "thread_pool.h"
+#include "tinygltf.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+const char* StreamStageName(StreamStage stage) {
+    switch (stage) {
+    case StreamStage::Read:       return "Stream read";
+    case StreamStage::Decode:     return "Stream decode";
+    case StreamStage::Skin:       return "Stream skin";
+    case StreamStage::Meshletize: return "Stream meshletize";
+    case StreamStage::Stage:      return "Stream stage";
+    default:                      return "Stream ?";
+    }
+}
+
+struct AssetStreamer::Job {
+    AssetId id = 0;
+    int32_t priority = 0;
+    uint64_t sequence = 0;
+    StreamStage stage = StreamStage::Read;
+    bool cancelled = false;          // under the streamer lock
+    uint64_t stagingSize = 0;        // known after Meshletize, reserved before Stage
+    bool reserved = false;
+    // products of the finished stages, each dropped once the next one has consumed it
+    std::vector<uint8_t> bytes;
+    std::unique_ptr<tinygltf::Model> model;
+    int skin = -1;
+    std::vector<VertexIn> vertices;
+    std::vector<uint32_t> indices;
+    MeshletMesh mesh;
+    std::vector<MeshletBounds> bounds;
+    PackedVertices packed;
+    StreamedAsset out;
+};
+
+AssetStreamer::AssetStreamer(ThreadPool& pool, AssetStreamerOptions options) : pool_(pool), options_(std::move(options)) {
+    options_.maxInFlight = std::max(options_.maxInFlight, 1u);
+    if (!options_.decode)
+        options_.decode = [](const std::vector<uint8_t>& bytes, const std::string& path, tinygltf::Model& model, std::string& error) {
+            return LoadGLTFFromMemory(bytes.data(), bytes.size(), std::filesystem::path(path).parent_path().string(), model, error);
+        };
+}
+
+AssetStreamer::~AssetStreamer() {
+    CancelAll();
+    // queued pool tasks still reference this streamer
+    while (running_.load(std::memory_order_acquire) > 0)
+        if (!pool_.RunPendingTask()) std::this_thread::yield();
+}
+
+// Job heaps: highest priority on top, then the earliest request.
+struct RunsAfter {
+    template <class P> bool operator()(const P& a, const P& b) const {
+        return a->priority != b->priority ? a->priority < b->priority : a->sequence > b->sequence;
+    }
+};
+template <class T> static void PushHeap(std::vector<T>& heap, T job) { heap.push_back(std::move(job)); std::push_heap(heap.begin(), heap.end(), RunsAfter{}); }
+template <class T> static T PopHeap(std::vector<T>& heap) { std::pop_heap(heap.begin(), heap.end(), RunsAfter{}); T job = std::move(heap.back()); heap.pop_back(); return job; }
+template <class T> static bool EraseFromHeap(std::vector<T>& heap, const T& job) {
+    auto it = std::find(heap.begin(), heap.end(), job);
+    if (it == heap.end()) return false;
+    heap.erase(it); std::make_heap(heap.begin(), heap.end(), RunsAfter{});
+    return true;
+}
+
+AssetId AssetStreamer::Load(const std::string& path, int32_t priority) {
+    return Load(std::vector<Request>{ { path, priority } })[0];
+}
+
+std::vector<AssetId> AssetStreamer::Load(const std::vector<Request>& requests) {
+    std::vector<AssetId> ids;
+    ids.reserve(requests.size());
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (const Request& r : requests) {
+        auto job = std::make_shared<Job>();
+        job->id = nextId_++; job->priority = r.priority; job->sequence = sequence_++;
+        job->out.id = job->id; job->out.path = r.path; job->out.priority = r.priority;
+        PushHeap(pending_, job);
+        all_.push_back(job);
+        ids.push_back(job->id);
+    }
+    stats_.requested += requests.size();
+    Schedule(lock, Admit());
+    return ids;
+}
+
+size_t AssetStreamer::Admit() {
+    size_t admitted = 0;
+    while (stats_.inFlight < options_.maxInFlight && !pending_.empty()) {
+        PushHeap(ready_, PopHeap(pending_));
+        ++stats_.inFlight; ++admitted;
+    }
+    return admitted;
+}
+
+// Parked assets resume in priority order while they fit; the first that does not fit blocks the
+// rest so a large asset is not starved by smaller ones behind it.
+size_t AssetStreamer::Unpark() {
+    size_t resumed = 0;
+    while (!waiting_.empty() && FitsStaging(waiting_.front()->stagingSize)) {
+        JobPtr job = PopHeap(waiting_);
+        Reserve(*job);
+        PushHeap(ready_, std::move(job));
+        ++resumed;
+    }
+    return resumed;
+}
+
+bool AssetStreamer::FitsStaging(uint64_t size) const {
+    return stats_.stagingBytes == 0 || stats_.stagingBytes + size <= options_.stagingBudget;
+}
+
+void AssetStreamer::Reserve(Job& job) {
+    job.reserved = true;
+    stats_.stagingBytes += job.stagingSize;
+    stats_.peakStagingBytes = std::max(stats_.peakStagingBytes, stats_.stagingBytes);
+}
+
+void AssetStreamer::Unreserve(uint64_t size) {
+    stats_.stagingBytes -= size;
+}
+
+void AssetStreamer::Schedule(std::unique_lock<std::mutex>& lock, size_t tasks) {
+    if (pool_.WorkerCount() == 0) {
+        // inline pool: drain from the outermost call instead of recursing once per stage
+        if (draining_) return;
+        draining_ = true;
+        while (!ready_.empty()) { lock.unlock(); RunOne(); lock.lock(); }
+        draining_ = false;
+        return;
+    }
+    if (!tasks) return;
+    running_.fetch_add(uint32_t(tasks), std::memory_order_acq_rel);
+    lock.unlock();
+    for (size_t i = 0; i < tasks; ++i)
+        pool_.Submit([this] { RunOne(); running_.fetch_sub(1, std::memory_order_acq_rel); });
+    lock.lock();
+}
+
+// One pool task runs one stage of the highest-priority ready asset.
+void AssetStreamer::RunOne() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (ready_.empty()) return;
+    JobPtr job = PopHeap(ready_);
+    if (job->cancelled) { Finish(job, lock); return; }
+    if (job->stage == StreamStage::Stage && !job->reserved) {
+        if (!waiting_.empty() || !FitsStaging(job->stagingSize)) {
+            PushHeap(waiting_, std::move(job));
+            Schedule(lock, Unpark()); // it may outrank every parked asset and fit after all
+            return;
+        }
+        Reserve(*job);
+    }
+    ++runningStages_;
+    lock.unlock();
+
+    const StreamStage stage = job->stage;
+    const uint64_t t0 = ProfileNow();
+    bool more = false;
+    try {
+        GRFX_PROFILE_ZONE(StreamStageName(stage));
+        more = RunStage(*job);
+    } catch (const std::exception& e) {
+        job->out.error = std::string(StreamStageName(stage)) + ": " + e.what();
+    }
+    const uint64_t ns = ProfileNow() - t0;
+
+    lock.lock();
+    --runningStages_;
+    stats_.stageNs[size_t(stage)] += ns;
+    if (stage == StreamStage::Read) stats_.bytesRead += job->bytes.size();
+    if (more && !job->cancelled) { PushHeap(ready_, std::move(job)); Schedule(lock, 1); }
+    else Finish(job, lock);
+    idle_.notify_all();
+}
+
+bool AssetStreamer::RunStage(Job& job) {
+    StreamedAsset& out = job.out;
+    switch (job.stage) {
+    case StreamStage::Read: {
+        std::ifstream file(out.path, std::ios::binary | std::ios::ate);
+        if (!file) throw std::runtime_error("cannot open " + out.path);
+        job.bytes.resize(size_t(file.tellg()));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(job.bytes.data()), std::streamsize(job.bytes.size())))
+            throw std::runtime_error("cannot read " + out.path);
+        job.stage = StreamStage::Decode;
+        return true;
+    }
+    case StreamStage::Decode: {
+        job.model = std::make_unique<tinygltf::Model>();
+        std::string error;
+        if (!options_.decode(job.bytes, out.path, *job.model, error))
+            throw std::runtime_error(error.empty() ? "not a glTF file" : error);
+        std::vector<uint8_t>().swap(job.bytes);
+        // the first skinned mesh node, else the first mesh; all of its triangle primitives
+        const tinygltf::Model& model = *job.model;
+        int mesh = -1;
+        for (const auto& node : model.nodes)
+            if (node.mesh >= 0 && node.mesh < int(model.meshes.size()) && node.skin >= 0 && node.skin < int(model.skins.size())) {
+                mesh = node.mesh; job.skin = node.skin; break;
+            }
+        if (mesh < 0 && !model.meshes.empty()) mesh = 0;
+        if (mesh < 0) throw std::runtime_error("no mesh");
+        std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+        for (const auto& prim : model.meshes[mesh].primitives) {
+            if (prim.mode != TINYGLTF_MODE_TRIANGLES && prim.mode != -1) continue;
+            ReadPrimitiveVertices(model, prim, verts, indices);
+            const uint32_t base = uint32_t(job.vertices.size());
+            for (uint32_t& i : indices) i += base;
+            job.vertices.insert(job.vertices.end(), verts.begin(), verts.end());
+            job.indices.insert(job.indices.end(), indices.begin(), indices.end());
+        }
+        if (job.indices.empty()) throw std::runtime_error("no triangles");
+        job.stage = StreamStage::Skin;
+        return true;
+    }
+    case StreamStage::Skin: {
+        if (job.skin >= 0) {
+            const Skin skin = BuildSkin(*job.model, job.skin);
+            out.skeleton = BuildSkeletonLayout(skin);
+            ReadRestPose(*job.model, out.skeleton);
+        }
+        job.model.reset();
+        const size_t bones = std::max<size_t>(out.skeleton.BoneCount(), 1);
+        for (const VertexIn& v : job.vertices)
+            for (int k = 0; k < 4; ++k)
+                if (v.boneWgt[k] != 0.0f && v.boneIdx[k] >= bones) throw std::runtime_error("joint index outside the skin");
+        job.stage = StreamStage::Meshletize;
+        return true;
+    }
+    case StreamStage::Meshletize: {
+        job.mesh = BuildMeshlets(job.vertices, job.indices, options_.meshlet);
+        std::vector<VertexIn>().swap(job.vertices); std::vector<uint32_t>().swap(job.indices);
+        job.bounds = ComputeMeshletBounds(job.mesh);
+        if (options_.packVertices) job.packed = PackMeshletVertices(job.mesh);
+        out.meshletCount = uint32_t(job.mesh.meshlets.size());
+        out.packed = options_.packVertices; out.joints = job.packed.joints; out.strideWords = job.packed.strideWords;
+        auto bytesOf = [](const auto& v) { return uint64_t(v.size() * sizeof(v[0])); };
+        const uint64_t sizes[size_t(StagedBuffer::Count)] = {
+            options_.packVertices ? bytesOf(job.packed.words) : bytesOf(job.mesh.vertices), bytesOf(job.packed.quant),
+            bytesOf(job.mesh.triangles), bytesOf(job.mesh.meshlets), bytesOf(job.mesh.boneRemap), bytesOf(job.bounds) };
+        uint64_t offset = 0;
+        for (size_t b = 0; b < size_t(StagedBuffer::Count); ++b) {
+            out.ranges[b] = { offset, sizes[b] };
+            offset += (sizes[b] + kStagingAlignment - 1) & ~(kStagingAlignment - 1);
+        }
+        job.stagingSize = offset;
+        job.stage = StreamStage::Stage;
+        return true;
+    }
+    case StreamStage::Stage: {
+        out.staging.resize(size_t(job.stagingSize));
+        const void* src[size_t(StagedBuffer::Count)] = {
+            options_.packVertices ? static_cast<const void*>(job.packed.words.data()) : job.mesh.vertices.data(), job.packed.quant.data(),
+            job.mesh.triangles.data(), job.mesh.meshlets.data(), job.mesh.boneRemap.data(), job.bounds.data() };
+        for (size_t b = 0; b < size_t(StagedBuffer::Count); ++b)
+            if (out.ranges[b].size) memcpy(out.staging.data() + out.ranges[b].offset, src[b], size_t(out.ranges[b].size));
+        job.mesh = {}; job.bounds = {}; job.packed = {};
+        return false;
+    }
+    default: return false;
+    }
+}
+
+void AssetStreamer::Finish(const JobPtr& job, std::unique_lock<std::mutex>& lock) {
+    --stats_.inFlight;
+    if (job->cancelled) {
+        if (job->reserved) Unreserve(job->stagingSize);
+        ++stats_.cancelled;
+        all_.erase(std::find(all_.begin(), all_.end(), job));
+    } else {
+        if (!job->out.error.empty()) {
+            ++stats_.failed;
+            if (job->reserved) { Unreserve(job->stagingSize); job->reserved = false; }
+            job->out.staging.clear(); for (auto& r : job->out.ranges) r = {};
+        } else {
+            ++stats_.completed;
+        }
+        PushHeap(completed_, job);
+    }
+    Schedule(lock, Admit() + Unpark());
+    idle_.notify_all();
+}
+
+bool AssetStreamer::Cancel(AssetId id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = std::find_if(all_.begin(), all_.end(), [&](const JobPtr& j) { return j->id == id; });
+    if (it == all_.end()) return false;
+    JobPtr job = *it;
+    if (job->cancelled) return true;
+    job->cancelled = true;
+    // running or ready: dropped by RunOne at its next stage boundary
+    if (EraseFromHeap(pending_, job)) {
+        ++stats_.cancelled; all_.erase(it);
+    } else if (EraseFromHeap(waiting_, job)) {
+        Finish(job, lock);
+    } else if (EraseFromHeap(completed_, job)) {
+        if (job->reserved) Unreserve(job->stagingSize);
+        --(job->out.error.empty() ? stats_.completed : stats_.failed);
+        ++stats_.cancelled; all_.erase(it);
+        Schedule(lock, Unpark());
+    }
+    idle_.notify_all();
+    return true;
+}
+
+void AssetStreamer::CancelAll() {
+    std::vector<AssetId> ids;
+    { std::lock_guard<std::mutex> lock(mutex_); for (const JobPtr& j : all_) ids.push_back(j->id); }
+    for (AssetId id : ids) Cancel(id);
+}
+
+std::vector<StreamedAsset> AssetStreamer::TakeCompleted(uint64_t maxBytes, uint32_t maxAssets) {
+    std::vector<StreamedAsset> taken;
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t bytes = 0;
+    while (!completed_.empty() && taken.size() < maxAssets) {
+        const uint64_t size = completed_.front()->out.staging.size();
+        if (!taken.empty() && bytes + size > maxBytes) break;
+        JobPtr job = PopHeap(completed_);
+        all_.erase(std::find(all_.begin(), all_.end(), job));
+        bytes += size;
+        taken.push_back(std::move(job->out));
+    }
+    return taken;
+}
+
+void AssetStreamer::Release(StreamedAsset& asset) {
+    if (asset.id == 0) return; // already released
+    asset.id = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    Unreserve(asset.staging.size());
+    ++stats_.released;
+    std::vector<uint8_t>().swap(asset.staging);
+    Schedule(lock, Unpark());
+}
+
+void AssetStreamer::WaitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!ready_.empty() || runningStages_ > 0) {
+        lock.unlock();
+        const bool ran = pool_.RunPendingTask();
+        lock.lock();
+        if (!ran) idle_.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+
+AssetStreamerStats AssetStreamer::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AssetStreamerStats s = stats_;
+    s.queued = uint32_t(pending_.size());
+    s.waitingForStaging = uint32_t(waiting_.size());
+    return s;
+}
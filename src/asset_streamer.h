@@ -0,0 +1,146 @@
+#pragma once
+// Asynchronous skinned-asset loading on a ThreadPool. Every requested asset runs the stages
+//   read (file bytes) -> decode (glTF model, flattened primitives) -> skin (BuildSkin and
+//   SkeletonLayout) -> meshletize (meshlets and bounds, optionally packed) -> stage
+// as separate pool tasks, and ends as one upload-ready blob in CPU staging memory.
+//
+// Bounded: at most maxInFlight assets are between read and stage at once, admitted
+// highest priority first (ties in request order). Ready stages also run highest priority first.
+// Staging memory is capped by stagingBudget: an asset whose blob does not fit waits, holding no
+// thread, until Release() frees room. The only exception is an asset larger than the whole
+// budget, which is staged once nothing else is.
+//
+// Frame protocol (render thread):
+//   for (StreamedAsset& a : streamer.TakeCompleted(bytesPerFrame)) {
+//       ... copy a.staging into the upload heap / record the copies ...
+//       streamer.Release(a);  // returns its staging bytes to the budget
+//   }
+//
+// The ThreadPool must outlive the streamer. With a 0-worker pool every stage runs inline
+// inside Load().
+
+#include "meshlet.h"
+#include "skeleton.h"
+#include "vertex_pack.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tinygltf { class Model; }
+class ThreadPool;
+
+using AssetId = uint64_t; // 0 is never a valid id
+
+enum class StreamStage : uint32_t { Read, Decode, Skin, Meshletize, Stage, Count };
+const char* StreamStageName(StreamStage stage);
+
+// Byte ranges of the staging blob, each kStagingAlignment-aligned. Quant is empty unless the
+// vertices are packed; Vertices then holds PackedVertices::words.
+enum class StagedBuffer : uint32_t { Vertices, Quant, Triangles, Meshlets, BoneRemap, Bounds, Count };
+constexpr uint64_t kStagingAlignment = 256;
+
+struct StagingRange { uint64_t offset = 0, size = 0; };
+
+struct StreamedAsset {
+    AssetId id = 0;
+    std::string path;
+    int32_t priority = 0;
+    std::string error;            // non-empty: the asset failed at some stage; nothing is staged
+    SkeletonLayout skeleton;      // empty when the asset has no skin (every vertex on joint 0)
+    uint32_t meshletCount = 0;
+    bool packed = false; JointFormat joints = JointFormat::U8; uint32_t strideWords = 0;
+    std::vector<uint8_t> staging;
+    StagingRange ranges[size_t(StagedBuffer::Count)];
+
+    const StagingRange& Range(StagedBuffer b) const { return ranges[size_t(b)]; }
+};
+
+// Decodes a file's bytes into a glTF model; returns false and sets `error` on failure.
+using AssetDecoder = std::function<bool(const std::vector<uint8_t>& bytes, const std::string& path,
+                                        tinygltf::Model& model, std::string& error)>;
+
+struct AssetStreamerOptions {
+    uint32_t maxInFlight   = 16;
+    uint64_t stagingBudget = 256ull << 20;
+    MeshletLimits meshlet;
+    bool packVertices = true;   // vertex_pack.h words instead of raw VertexIn
+    AssetDecoder decode;        // empty: LoadGLTFFromMemory
+};
+
+struct AssetStreamerStats {
+    uint64_t requested = 0, completed = 0, failed = 0, cancelled = 0, released = 0; // outcomes are exclusive
+    uint64_t bytesRead = 0;
+    uint64_t stagingBytes = 0, peakStagingBytes = 0; // staged and not yet released
+    uint32_t inFlight = 0, queued = 0, waitingForStaging = 0;
+    uint64_t stageNs[size_t(StreamStage::Count)] = {}; // summed over workers
+};
+
+class AssetStreamer {
+public:
+    AssetStreamer(ThreadPool& pool, AssetStreamerOptions options = {});
+    ~AssetStreamer(); // cancels everything and waits for running stages
+    AssetStreamer(const AssetStreamer&) = delete;
+    AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+    struct Request { std::string path; int32_t priority = 0; };
+
+    // Higher priority runs first. A batch is queued atomically, so its priorities are honoured
+    // even when the first admitted asset would otherwise start before the rest are queued.
+    AssetId Load(const std::string& path, int32_t priority = 0);
+    std::vector<AssetId> Load(const std::vector<Request>& requests);
+
+    // Queued assets are dropped at once; running ones at their next stage boundary; completed
+    // ones release their staging. Returns false if the id is unknown or already handed off.
+    bool Cancel(AssetId id);
+    void CancelAll();
+
+    // Completed (or failed) assets, highest priority first, until their staging bytes reach
+    // maxBytes or maxAssets are taken; always at least one if any is ready.
+    std::vector<StreamedAsset> TakeCompleted(uint64_t maxBytes = ~0ull, uint32_t maxAssets = ~0u);
+    // Frees the staging and clears asset.id; releasing the same asset again does nothing.
+    void Release(StreamedAsset& asset);
+
+    // Blocks until no stage is ready or running: every asset is completed, cancelled, or parked
+    // on the staging budget (which only Release() unblocks). Runs pool tasks meanwhile.
+    void WaitIdle();
+
+    AssetStreamerStats Stats() const;
+
+private:
+    struct Job;
+    using JobPtr = std::shared_ptr<Job>;
+
+    // lock held; Admit and Unpark move jobs to ready_ and return how many
+    size_t Admit();
+    size_t Unpark();
+    bool FitsStaging(uint64_t size) const;
+    void Reserve(Job& job);
+    void Unreserve(uint64_t size);
+    void Schedule(std::unique_lock<std::mutex>& lock, size_t tasks); // one RunOne per ready job
+    void Finish(const JobPtr& job, std::unique_lock<std::mutex>& lock);
+
+    void RunOne();
+    bool RunStage(Job& job);             // unlocked; false once the asset is staged
+
+    ThreadPool& pool_;
+    AssetStreamerOptions options_;
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    AssetId nextId_ = 1;
+    uint64_t sequence_ = 0;
+    std::vector<JobPtr> pending_;        // requested, not admitted; heap by (priority, sequence)
+    std::vector<JobPtr> ready_;          // admitted, next stage runnable; same heap order
+    std::vector<JobPtr> waiting_;        // blocked on the staging budget
+    std::vector<JobPtr> completed_;
+    std::vector<JobPtr> all_;            // unfinished or not yet handed off, for Cancel
+    uint32_t runningStages_ = 0;
+    bool draining_ = false;              // 0-worker pool: a Schedule call is running ready jobs
+    std::atomic<uint32_t> running_{0};   // pool tasks that may touch `this`
+    AssetStreamerStats stats_;
+};
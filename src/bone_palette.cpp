@@ -0,0 +1,134 @@
+#include "bone_palette.h"
+#include "mat4.h"
+#include "thread_pool.h"
+#include "tinygltf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+const char* PaletteFormatName(PaletteFormat format) {
+    switch (format) {
+    case PaletteFormat::Mat4x4:   return "4x4";
+    case PaletteFormat::Mat3x4:   return "3x4";
+    case PaletteFormat::DualQuat: return "dual quaternion";
+    default:                      return "?";
+    }
+}
+
+// Rows of the upper 3x4: out[r*4 + c] = m[c*4 + r] (float4 rows in HLSL, dot(row, float4(p, 1))).
+static void EncodeMat3x4(const float* m, float* out) {
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 4; ++c) out[r * 4 + c] = m[c * 4 + r];
+}
+
+// Real part: rotation of the normalized columns, in the w >= 0 hemisphere. Dual part: 0.5 * t * real.
+static void EncodeDualQuat(const float* m, float* out) {
+    float rot[16];
+    for (int c = 0; c < 3; ++c) {
+        const float len = std::sqrt(m[c*4]*m[c*4] + m[c*4 + 1]*m[c*4 + 1] + m[c*4 + 2]*m[c*4 + 2]);
+        const float inv = len > 0.0f ? 1.0f / len : 0.0f;
+        for (int r = 0; r < 3; ++r) rot[c * 4 + r] = m[c * 4 + r] * inv;
+    }
+    float q[4]; Mat3ToQuat(rot, q);
+    const float qlen = std::sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+    const float s = (q[3] < 0.0f ? -1.0f : 1.0f) / qlen;
+    for (float& x : q) x *= s;
+    const float t[3] = { m[12], m[13], m[14] };
+    out[0] = q[0]; out[1] = q[1]; out[2] = q[2]; out[3] = q[3];
+    out[4] = 0.5f * ( t[0]*q[3] + t[1]*q[2] - t[2]*q[1]);
+    out[5] = 0.5f * (-t[0]*q[2] + t[1]*q[3] + t[2]*q[0]);
+    out[6] = 0.5f * ( t[0]*q[1] - t[1]*q[0] + t[2]*q[3]);
+    out[7] = -0.5f * (t[0]*q[0] + t[1]*q[1] + t[2]*q[2]);
+}
+
+void EncodePalette(PaletteFormat format, const float* skinning, size_t count, float* out) {
+    switch (format) {
+    case PaletteFormat::Mat4x4:   memcpy(out, skinning, count * 16 * sizeof(float)); break;
+    case PaletteFormat::Mat3x4:   for (size_t i = 0; i < count; ++i) EncodeMat3x4(skinning + i * 16, out + i * 12); break;
+    case PaletteFormat::DualQuat: for (size_t i = 0; i < count; ++i) EncodeDualQuat(skinning + i * 16, out + i * 8); break;
+    }
+}
+
+void EncodePaletteParallel(ThreadPool& pool, PaletteFormat format, const float* skinning, size_t count, float* out, size_t grain) {
+    const size_t stride = PaletteFloats(format);
+    pool.ParallelFor(0, count, std::max<size_t>(grain, 1), [&](size_t b, size_t e) {
+        EncodePalette(format, skinning + b * 16, e - b, out + b * stride);
+    });
+}
+
+void EncodeSkinPalette(const Skin& skin, PaletteFormat format, float* out) {
+    const size_t stride = PaletteFloats(format);
+    for (size_t i = 0; i < skin.bones.size(); ++i) {
+        float m[16]; Mat4Mul(skin.bones[i].globalMatrix, skin.bones[i].inverseBind, m);
+        EncodePalette(format, m, 1, out + i * stride);
+    }
+}
+
+// Rotation of unit quaternion r applied to v: v + 2 r.xyz x (r.xyz x v + r.w v).
+static void QuatRotate(const float r[4], const float v[3], float out[3]) {
+    const float c[3] = { r[1]*v[2] - r[2]*v[1] + r[3]*v[0], r[2]*v[0] - r[0]*v[2] + r[3]*v[1], r[0]*v[1] - r[1]*v[0] + r[3]*v[2] };
+    out[0] = v[0] + 2.0f * (r[1]*c[2] - r[2]*c[1]);
+    out[1] = v[1] + 2.0f * (r[2]*c[0] - r[0]*c[2]);
+    out[2] = v[2] + 2.0f * (r[0]*c[1] - r[1]*c[0]);
+}
+
+// Translation of a unit dual quaternion: 2 (r.w d.xyz - d.w r.xyz + r.xyz x d.xyz).
+static void DualQuatTranslation(const float r[4], const float d[4], float t[3]) {
+    t[0] = 2.0f * (r[3]*d[0] - d[3]*r[0] + r[1]*d[2] - r[2]*d[1]);
+    t[1] = 2.0f * (r[3]*d[1] - d[3]*r[1] + r[2]*d[0] - r[0]*d[2]);
+    t[2] = 2.0f * (r[3]*d[2] - d[3]*r[2] + r[0]*d[1] - r[1]*d[0]);
+}
+
+void DecodePaletteEntry(PaletteFormat format, const float* e, float m[16]) {
+    if (format == PaletteFormat::Mat4x4) { memcpy(m, e, 16 * sizeof(float)); return; }
+    Mat4Identity(m);
+    if (format == PaletteFormat::Mat3x4) {
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 4; ++c) m[c * 4 + r] = e[r * 4 + c];
+        return;
+    }
+    const float t[3] = { 0, 0, 0 }, one[3] = { 1, 1, 1 };
+    ComposeTRS(t, e, one, m);
+    DualQuatTranslation(e, e + 4, &m[12]);
+}
+
+void SkinVertexReference(PaletteFormat format, const float* palette, const VertexIn& v, float pos[3], float nrm[3]) {
+    const uint32_t stride = PaletteFloats(format);
+    if (format == PaletteFormat::DualQuat) {
+        // blend in the hemisphere of the first influence, then normalize by the real part
+        float br[4] = {}, bd[4] = {};
+        const float* r0 = palette + size_t(v.boneIdx[0]) * stride;
+        for (int k = 0; k < 4; ++k) {
+            if (v.boneWgt[k] == 0.0f) continue;
+            const float* dq = palette + size_t(v.boneIdx[k]) * stride;
+            const float w = (dq[0]*r0[0] + dq[1]*r0[1] + dq[2]*r0[2] + dq[3]*r0[3]) < 0.0f ? -v.boneWgt[k] : v.boneWgt[k];
+            for (int i = 0; i < 4; ++i) { br[i] += w * dq[i]; bd[i] += w * dq[4 + i]; }
+        }
+        const float len = std::sqrt(br[0]*br[0] + br[1]*br[1] + br[2]*br[2] + br[3]*br[3]);
+        const float inv = len > 0.0f ? 1.0f / len : 0.0f;
+        for (int i = 0; i < 4; ++i) { br[i] *= inv; bd[i] *= inv; }
+        float t[3]; DualQuatTranslation(br, bd, t);
+        QuatRotate(br, v.pos, pos);
+        for (int i = 0; i < 3; ++i) pos[i] += t[i];
+        QuatRotate(br, v.nrm, nrm);
+        return;
+    }
+    // linear blend of the affine rows; normals through the blended 3x3, renormalized
+    float rows[12] = {};
+    for (int k = 0; k < 4; ++k) {
+        if (v.boneWgt[k] == 0.0f) continue;
+        float r[12];
+        const float* e = palette + size_t(v.boneIdx[k]) * stride;
+        if (format == PaletteFormat::Mat4x4) EncodeMat3x4(e, r); else memcpy(r, e, sizeof(r));
+        for (int i = 0; i < 12; ++i) rows[i] += v.boneWgt[k] * r[i];
+    }
+    float n[3];
+    for (int r = 0; r < 3; ++r) {
+        const float* row = &rows[r * 4];
+        pos[r] = row[0]*v.pos[0] + row[1]*v.pos[1] + row[2]*v.pos[2] + row[3];
+        n[r] = row[0]*v.nrm[0] + row[1]*v.nrm[1] + row[2]*v.nrm[2];
+    }
+    const float len = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+    for (int r = 0; r < 3; ++r) nrm[r] = len > 0.0f ? n[r] / len : 0.0f;
+}
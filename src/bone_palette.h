@@ -0,0 +1,37 @@
+#pragma once
+// Bone palette encodings for gBones, selected by PALETTE_FORMAT in shaders/common.hlsli:
+//   Mat4x4   - column-major float4x4 (64 B/bone), linear blend skinning
+//   Mat3x4   - the three affine rows of the same matrix (48 B/bone), linear blend skinning
+//   DualQuat - unit dual quaternion, real then dual part (32 B/bone), dual-quaternion linear
+//              blending (Kavan et al. 2007): no candy-wrapper collapse on twisting joints.
+//              Rigid bones only; scale and shear are dropped.
+// Encoders take skinning matrices (global * inverseBind, 16 floats each, as EvaluateSkeleton writes them).
+
+#include "mesh_types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+struct Skin;
+class ThreadPool;
+
+enum class PaletteFormat : uint32_t { Mat4x4 = 0, Mat3x4 = 1, DualQuat = 2 }; // PALETTE_FORMAT values
+
+constexpr uint32_t PaletteFloats(PaletteFormat format) {
+    return format == PaletteFormat::Mat4x4 ? 16 : format == PaletteFormat::Mat3x4 ? 12 : 8;
+}
+const char* PaletteFormatName(PaletteFormat format);
+
+// `out` holds count * PaletteFloats(format) floats.
+void EncodePalette(PaletteFormat format, const float* skinning, size_t count, float* out);
+void EncodePaletteParallel(ThreadPool& pool, PaletteFormat format, const float* skinning, size_t count, float* out,
+                           size_t grain = 4096);
+
+// Encodes Bone::globalMatrix * Bone::inverseBind of every bone, in bone order.
+void EncodeSkinPalette(const Skin& skin, PaletteFormat format, float* out);
+
+// Column-major matrix of one encoded entry (BoneMatrix() in common.hlsli).
+void DecodePaletteEntry(PaletteFormat format, const float* entry, float m[16]);
+
+// Scalar reference of MSMain's bone blending, indexing `palette` with v.boneIdx directly.
+void SkinVertexReference(PaletteFormat format, const float* palette, const VertexIn& v, float pos[3], float nrm[3]);
@@ -0,0 +1,187 @@
+#include "cpu_skinning.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define GRFX_SKIN_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRFX_SKIN_SSE 1
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif
+
+// Rows 0..2 of each column of a column-major 4x4: blended matrix element e = column e/3, row e%3.
+static const int kAffineOffsets[12] = { 0,1,2, 4,5,6, 8,9,10, 12,13,14 };
+
+static size_t RoundUp8(size_t n) { return (n + 7) & ~size_t(7); }
+
+SkinningStreams MakeSkinningStreams(const VertexIn* vertices, size_t count, uint32_t boneCount) {
+    SkinningStreams s; s.count = count;
+    const size_t padded = RoundUp8(count);
+    for (auto* v : { &s.px, &s.py, &s.pz, &s.nx, &s.ny, &s.nz }) v->assign(padded, 0.0f);
+    for (int k = 0; k < 4; ++k) { s.idx[k].assign(padded, 0); s.wgt[k].assign(padded, 0.0f); }
+    for (size_t i = 0; i < count; ++i) {
+        const VertexIn& v = vertices[i];
+        s.px[i] = v.pos[0]; s.py[i] = v.pos[1]; s.pz[i] = v.pos[2];
+        s.nx[i] = v.nrm[0]; s.ny[i] = v.nrm[1]; s.nz[i] = v.nrm[2];
+        for (int k = 0; k < 4; ++k) {
+            s.wgt[k][i] = v.boneWgt[k];
+            s.idx[k][i] = (v.boneWgt[k] != 0.0f && v.boneIdx[k] < boneCount) ? int32_t(v.boneIdx[k]) : 0;
+        }
+    }
+    return s;
+}
+
+SkinningBackend BestSkinningBackend() {
+#if GRFX_SKIN_AVX2
+    return SkinningBackend::AVX2;
+#elif GRFX_SKIN_SSE
+    return SkinningBackend::SSE;
+#else
+    return SkinningBackend::Scalar;
+#endif
+}
+
+const char* SkinningBackendName(SkinningBackend backend) {
+    switch (backend) {
+    case SkinningBackend::Scalar: return "scalar";
+    case SkinningBackend::SSE:    return "sse";
+    case SkinningBackend::AVX2:   return "avx2";
+    default:                      return "auto";
+    }
+}
+
+static void SkinScalar(const SkinningStreams& in, const float* palette, size_t begin, size_t end, SkinnedVertices& out) {
+    for (size_t i = begin; i < end; ++i) {
+        float m[12] = {};
+        for (int k = 0; k < 4; ++k) {
+            const float w = in.wgt[k][i]; const float* B = palette + size_t(in.idx[k][i]) * 16;
+            for (int e = 0; e < 12; ++e) m[e] += w * B[kAffineOffsets[e]];
+        }
+        const float x = in.px[i], y = in.py[i], z = in.pz[i];
+        out.px[i] = m[0]*x + m[3]*y + m[6]*z + m[9];
+        out.py[i] = m[1]*x + m[4]*y + m[7]*z + m[10];
+        out.pz[i] = m[2]*x + m[5]*y + m[8]*z + m[11];
+        const float a = in.nx[i], b = in.ny[i], c = in.nz[i];
+        const float nx = m[0]*a + m[3]*b + m[6]*c, ny = m[1]*a + m[4]*b + m[7]*c, nz = m[2]*a + m[5]*b + m[8]*c;
+        const float len2 = nx*nx + ny*ny + nz*nz, inv = len2 > 0.0f ? 1.0f / std::sqrt(len2) : 0.0f;
+        out.nx[i] = nx * inv; out.ny[i] = ny * inv; out.nz[i] = nz * inv;
+    }
+}
+
+#if GRFX_SKIN_SSE
+static void SkinSSE(const SkinningStreams& in, const float* palette, size_t begin, size_t end, SkinnedVertices& out) {
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    for (size_t i = begin; i < end; i += 4) {
+        __m128 m[12]; for (auto& e : m) e = zero;
+        for (int k = 0; k < 4; ++k) {
+            const __m128 w = _mm_loadu_ps(&in.wgt[k][i]);
+            const float* B[4]; for (int l = 0; l < 4; ++l) B[l] = palette + size_t(in.idx[k][i + l]) * 16;
+            for (int c = 0; c < 4; ++c) {
+                // transpose column c of four matrices into per-row lanes
+                __m128 r0 = _mm_loadu_ps(B[0] + c*4), r1 = _mm_loadu_ps(B[1] + c*4), r2 = _mm_loadu_ps(B[2] + c*4), r3 = _mm_loadu_ps(B[3] + c*4);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                m[c*3 + 0] = _mm_add_ps(m[c*3 + 0], _mm_mul_ps(w, r0));
+                m[c*3 + 1] = _mm_add_ps(m[c*3 + 1], _mm_mul_ps(w, r1));
+                m[c*3 + 2] = _mm_add_ps(m[c*3 + 2], _mm_mul_ps(w, r2));
+            }
+        }
+        auto xform = [&](__m128 x, __m128 y, __m128 z, int r) {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[r], x), _mm_mul_ps(m[3 + r], y)), _mm_mul_ps(m[6 + r], z));
+        };
+        const __m128 x = _mm_loadu_ps(&in.px[i]), y = _mm_loadu_ps(&in.py[i]), z = _mm_loadu_ps(&in.pz[i]);
+        _mm_storeu_ps(&out.px[i], _mm_add_ps(xform(x, y, z, 0), m[9]));
+        _mm_storeu_ps(&out.py[i], _mm_add_ps(xform(x, y, z, 1), m[10]));
+        _mm_storeu_ps(&out.pz[i], _mm_add_ps(xform(x, y, z, 2), m[11]));
+        const __m128 a = _mm_loadu_ps(&in.nx[i]), b = _mm_loadu_ps(&in.ny[i]), c = _mm_loadu_ps(&in.nz[i]);
+        const __m128 nx = xform(a, b, c, 0), ny = xform(a, b, c, 1), nz = xform(a, b, c, 2);
+        const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz));
+        const __m128 inv = _mm_and_ps(_mm_cmpgt_ps(len2, zero), _mm_div_ps(one, _mm_sqrt_ps(len2)));
+        _mm_storeu_ps(&out.nx[i], _mm_mul_ps(nx, inv));
+        _mm_storeu_ps(&out.ny[i], _mm_mul_ps(ny, inv));
+        _mm_storeu_ps(&out.nz[i], _mm_mul_ps(nz, inv));
+    }
+}
+#endif
+
+#if GRFX_SKIN_AVX2
+static void SkinAVX2(const SkinningStreams& in, const float* palette, size_t begin, size_t end, SkinnedVertices& out) {
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    auto load2 = [](const float* lo, const float* hi) { return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1); };
+    for (size_t i = begin; i < end; i += 8) {
+        __m256 m[12]; for (auto& e : m) e = zero;
+        for (int k = 0; k < 4; ++k) {
+            const __m256 w = _mm256_loadu_ps(&in.wgt[k][i]);
+            const float* B[8]; for (int l = 0; l < 8; ++l) B[l] = palette + size_t(in.idx[k][i + l]) * 16;
+            for (int c = 0; c < 4; ++c) {
+                // vertices l and l+4 share a register; transpose within 128-bit halves (cheaper than gathers)
+                const __m256 r0 = load2(B[0] + c*4, B[4] + c*4), r1 = load2(B[1] + c*4, B[5] + c*4);
+                const __m256 r2 = load2(B[2] + c*4, B[6] + c*4), r3 = load2(B[3] + c*4, B[7] + c*4);
+                const __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpacklo_ps(r2, r3);
+                const __m256 t2 = _mm256_unpackhi_ps(r0, r1), t3 = _mm256_unpackhi_ps(r2, r3);
+                m[c*3 + 0] = _mm256_fmadd_ps(w, _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1,0,1,0)), m[c*3 + 0]);
+                m[c*3 + 1] = _mm256_fmadd_ps(w, _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3,2,3,2)), m[c*3 + 1]);
+                m[c*3 + 2] = _mm256_fmadd_ps(w, _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1,0,1,0)), m[c*3 + 2]);
+            }
+        }
+        auto xform = [&](__m256 x, __m256 y, __m256 z, int r) {
+            return _mm256_fmadd_ps(m[r], x, _mm256_fmadd_ps(m[3 + r], y, _mm256_mul_ps(m[6 + r], z)));
+        };
+        const __m256 x = _mm256_loadu_ps(&in.px[i]), y = _mm256_loadu_ps(&in.py[i]), z = _mm256_loadu_ps(&in.pz[i]);
+        _mm256_storeu_ps(&out.px[i], _mm256_add_ps(xform(x, y, z, 0), m[9]));
+        _mm256_storeu_ps(&out.py[i], _mm256_add_ps(xform(x, y, z, 1), m[10]));
+        _mm256_storeu_ps(&out.pz[i], _mm256_add_ps(xform(x, y, z, 2), m[11]));
+        const __m256 a = _mm256_loadu_ps(&in.nx[i]), b = _mm256_loadu_ps(&in.ny[i]), c = _mm256_loadu_ps(&in.nz[i]);
+        const __m256 nx = xform(a, b, c, 0), ny = xform(a, b, c, 1), nz = xform(a, b, c, 2);
+        const __m256 len2 = _mm256_fmadd_ps(nx, nx, _mm256_fmadd_ps(ny, ny, _mm256_mul_ps(nz, nz)));
+        const __m256 inv = _mm256_and_ps(_mm256_cmp_ps(len2, zero, _CMP_GT_OQ), _mm256_div_ps(one, _mm256_sqrt_ps(len2)));
+        _mm256_storeu_ps(&out.nx[i], _mm256_mul_ps(nx, inv));
+        _mm256_storeu_ps(&out.ny[i], _mm256_mul_ps(ny, inv));
+        _mm256_storeu_ps(&out.nz[i], _mm256_mul_ps(nz, inv));
+    }
+}
+#endif
+
+void PrepareSkinnedVertices(const SkinningStreams& in, SkinnedVertices& out) {
+    for (auto* v : { &out.px, &out.py, &out.pz, &out.nx, &out.ny, &out.nz }) v->resize(in.px.size());
+}
+
+void SkinVertexRange(const SkinningStreams& in, const float* palette, size_t begin, size_t end,
+                     SkinnedVertices& out, SkinningBackend backend) {
+    end = std::min(RoundUp8(end), in.px.size()); // streams are padded, finish the last batch
+    if (begin >= end) return;
+    if (backend == SkinningBackend::Auto) backend = BestSkinningBackend();
+#if GRFX_SKIN_AVX2
+    if (backend == SkinningBackend::AVX2) { SkinAVX2(in, palette, begin, end, out); return; }
+#endif
+#if GRFX_SKIN_SSE
+    if (backend != SkinningBackend::Scalar) { SkinSSE(in, palette, begin, end, out); return; }
+#endif
+    SkinScalar(in, palette, begin, end, out);
+}
+
+void SkinVertices(const SkinningStreams& in, const float* palette, SkinnedVertices& out, SkinningBackend backend) {
+    PrepareSkinnedVertices(in, out);
+    SkinVertexRange(in, palette, 0, in.count, out, backend);
+}
+
+void SkinVerticesParallel(ThreadPool& pool, const SkinningStreams& in, const float* palette, SkinnedVertices& out,
+                          SkinningBackend backend, size_t grain) {
+    PrepareSkinnedVertices(in, out);
+    pool.ParallelFor(0, in.count, RoundUp8(std::max<size_t>(grain, 8)), [&](size_t b, size_t e) {
+        SkinVertexRange(in, palette, b, e, out, backend);
+    });
+}
+
+float MaxSkinningError(const SkinnedVertices& a, const SkinnedVertices& b, size_t count) {
+    float err = 0.0f;
+    const std::vector<float>* sa[] = { &a.px, &a.py, &a.pz, &a.nx, &a.ny, &a.nz };
+    const std::vector<float>* sb[] = { &b.px, &b.py, &b.pz, &b.nx, &b.ny, &b.nz };
+    for (int s = 0; s < 6; ++s)
+        for (size_t i = 0; i < count; ++i) err = std::max(err, std::abs((*sa[s])[i] - (*sb[s])[i]));
+    return err;
+}
@@ -0,0 +1,46 @@
+#pragma once
+// CPU linear blend skinning: reference/fallback for the MSMain skinning path. Positions and
+// normals are blended with 4 influences against a palette of column-major float4x4 (the
+// gBones layout). Kernels run over an SoA copy of the bind pose: scalar, SSE (4 vertices)
+// and AVX2+FMA (8 vertices).
+
+#include "mesh_types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+enum class SkinningBackend { Auto, Scalar, SSE, AVX2 };
+
+// Bind-pose streams, padded to a multiple of 8 vertices with zero-weight entries.
+struct SkinningStreams {
+    size_t count = 0;
+    std::vector<float>   px, py, pz, nx, ny, nz;
+    std::vector<int32_t> idx[4]; // palette indices, zero for unused/out-of-range influences
+    std::vector<float>   wgt[4];
+};
+
+struct SkinnedVertices {
+    std::vector<float> px, py, pz, nx, ny, nz; // sized like the padded input
+};
+
+SkinningStreams MakeSkinningStreams(const VertexIn* vertices, size_t count, uint32_t boneCount);
+
+SkinningBackend BestSkinningBackend();            // widest kernel compiled in
+const char* SkinningBackendName(SkinningBackend backend);
+
+// Skins [begin, end) into `out`, which must already be sized for `in` (see PrepareSkinnedVertices).
+// begin must be a multiple of 8 so SIMD batches never straddle ranges.
+void PrepareSkinnedVertices(const SkinningStreams& in, SkinnedVertices& out);
+void SkinVertexRange(const SkinningStreams& in, const float* palette, size_t begin, size_t end,
+                     SkinnedVertices& out, SkinningBackend backend = SkinningBackend::Auto);
+
+void SkinVertices(const SkinningStreams& in, const float* palette, SkinnedVertices& out,
+                  SkinningBackend backend = SkinningBackend::Auto);
+void SkinVerticesParallel(ThreadPool& pool, const SkinningStreams& in, const float* palette, SkinnedVertices& out,
+                          SkinningBackend backend = SkinningBackend::Auto, size_t grain = 4096);
+
+// Largest absolute component difference between two skinned results over the first `count` vertices.
+float MaxSkinningError(const SkinnedVertices& a, const SkinnedVertices& b, size_t count);
@@ -0,0 +1,186 @@
+#include "crowd.h"
+#include "mat4.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+static float Dot3(const float* a, const float* b) { return a[0]*b[0] + a[1]*b[1] + a[2]*b[2]; }
+static void TransformPoint(const float m[16], const float p[3], float out[3]) {
+    for (int r = 0; r < 3; ++r) out[r] = m[r] * p[0] + m[4 + r] * p[1] + m[8 + r] * p[2] + m[12 + r];
+}
+static void TransformVector(const float m[16], const float v[3], float out[3]) {
+    for (int r = 0; r < 3; ++r) out[r] = m[r] * v[0] + m[4 + r] * v[1] + m[8 + r] * v[2];
+}
+
+// Ritter's bounding sphere: start from the most separated pair along the axes, then grow.
+static void BoundingSphere(const VertexIn* verts, uint32_t count, float center[3], float& radius) {
+    uint32_t lo[3] = {}, hi[3] = {};
+    for (uint32_t i = 1; i < count; ++i)
+        for (int a = 0; a < 3; ++a) {
+            if (verts[i].pos[a] < verts[lo[a]].pos[a]) lo[a] = i;
+            if (verts[i].pos[a] > verts[hi[a]].pos[a]) hi[a] = i;
+        }
+    int axis = 0; float best = -1;
+    for (int a = 0; a < 3; ++a) {
+        float d[3]; for (int k = 0; k < 3; ++k) d[k] = verts[hi[a]].pos[k] - verts[lo[a]].pos[k];
+        if (Dot3(d, d) > best) { best = Dot3(d, d); axis = a; }
+    }
+    const float* p0 = verts[lo[axis]].pos; const float* p1 = verts[hi[axis]].pos;
+    for (int k = 0; k < 3; ++k) center[k] = 0.5f * (p0[k] + p1[k]);
+    radius = 0.5f * std::sqrt(best);
+    for (uint32_t i = 0; i < count; ++i) {
+        float d[3]; for (int k = 0; k < 3; ++k) d[k] = verts[i].pos[k] - center[k];
+        const float dist = std::sqrt(Dot3(d, d));
+        if (dist > radius) {
+            const float grow = 0.5f * (dist - radius);
+            radius += grow;
+            for (int k = 0; k < 3; ++k) center[k] += d[k] / dist * grow;
+        }
+    }
+}
+
+std::vector<MeshletBounds> ComputeMeshletBounds(const MeshletMesh& mesh) {
+    std::vector<MeshletBounds> out(mesh.meshlets.size());
+    std::vector<float> normals;
+    for (size_t mi = 0; mi < mesh.meshlets.size(); ++mi) {
+        const MeshletData& m = mesh.meshlets[mi];
+        MeshletBounds& b = out[mi];
+        const VertexIn* verts = &mesh.vertices[m.vOffset];
+        BoundingSphere(verts, m.vCount, b.center, b.radius);
+
+        // dominant bone: largest total weight; the meshlet is rigid if it is the only one used
+        float boneWeight[kMaxMeshletBones] = {};
+        uint32_t usedBones = 0;
+        for (uint32_t v = 0; v < m.vCount; ++v)
+            for (int k = 0; k < 4; ++k)
+                if (verts[v].boneWgt[k] > 0.0f && verts[v].boneIdx[k] < kMaxMeshletBones) {
+                    usedBones += boneWeight[verts[v].boneIdx[k]] == 0.0f;
+                    boneWeight[verts[v].boneIdx[k]] += verts[v].boneWgt[k];
+                }
+        b.dominantBone = uint32_t(std::max_element(boneWeight, boneWeight + kMaxMeshletBones) - boneWeight);
+
+        // normal cone over the unit triangle normals
+        normals.clear();
+        float axis[3] = {};
+        for (uint32_t t = 0; t < m.pCount; ++t) {
+            const MeshletTriangle& tri = mesh.triangles[m.pOffset + t];
+            const float* a = verts[tri.x].pos; const float* p1 = verts[tri.y].pos; const float* p2 = verts[tri.z].pos;
+            const float e1[3] = { p1[0] - a[0], p1[1] - a[1], p1[2] - a[2] }, e2[3] = { p2[0] - a[0], p2[1] - a[1], p2[2] - a[2] };
+            float n[3] = { e1[1]*e2[2] - e1[2]*e2[1], e1[2]*e2[0] - e1[0]*e2[2], e1[0]*e2[1] - e1[1]*e2[0] };
+            const float len = std::sqrt(Dot3(n, n));
+            if (len == 0.0f) continue; // degenerate: never visible, does not constrain the cone
+            for (float& c : n) c /= len;
+            normals.insert(normals.end(), n, n + 3);
+            for (int k = 0; k < 3; ++k) axis[k] += n[k];
+        }
+        const float axisLen = std::sqrt(Dot3(axis, axis));
+        b.coneCutoff = 1.0f; b.coneAxis[0] = b.coneAxis[1] = 0; b.coneAxis[2] = 1;
+        memcpy(b.coneApex, b.center, sizeof(b.coneApex));
+        if (usedBones > 1 || normals.empty() || axisLen == 0.0f) continue;
+        for (float& c : axis) c /= axisLen;
+        float minDot = 1.0f;
+        for (size_t i = 0; i < normals.size(); i += 3) minDot = std::min(minDot, Dot3(&normals[i], axis));
+        if (minDot <= 0.1f) continue; // cone wider than ~84 degrees: practically never culls
+        // apex: move back along the axis until every triangle plane is in front of it
+        float maxT = 0.0f;
+        for (uint32_t t = 0, i = 0; t < m.pCount; ++t) {
+            const MeshletTriangle& tri = mesh.triangles[m.pOffset + t];
+            const float* a = verts[tri.x].pos; const float* p1 = verts[tri.y].pos; const float* p2 = verts[tri.z].pos;
+            const float e1[3] = { p1[0] - a[0], p1[1] - a[1], p1[2] - a[2] }, e2[3] = { p2[0] - a[0], p2[1] - a[1], p2[2] - a[2] };
+            const float n[3] = { e1[1]*e2[2] - e1[2]*e2[1], e1[2]*e2[0] - e1[0]*e2[2], e1[0]*e2[1] - e1[1]*e2[0] };
+            if (Dot3(n, n) == 0.0f) continue;
+            const float* un = &normals[i]; i += 3;
+            const float d[3] = { b.center[0] - a[0], b.center[1] - a[1], b.center[2] - a[2] };
+            maxT = std::max(maxT, Dot3(d, un) / Dot3(axis, un));
+        }
+        for (int k = 0; k < 3; ++k) { b.coneAxis[k] = axis[k]; b.coneApex[k] = b.center[k] - axis[k] * maxT; }
+        b.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+    return out;
+}
+
+void ExtractFrustumPlanes(const float vp[16], float planes[6][4]) {
+    // rows of the column-major matrix: row r = (m[r], m[4+r], m[8+r], m[12+r])
+    auto row = [&](int r, float out[4]) { for (int c = 0; c < 4; ++c) out[c] = vp[c*4 + r]; };
+    float r0[4], r1[4], r2[4], r3[4];
+    row(0, r0); row(1, r1); row(2, r2); row(3, r3);
+    for (int c = 0; c < 4; ++c) {
+        planes[0][c] = r3[c] + r0[c]; planes[1][c] = r3[c] - r0[c]; // left, right
+        planes[2][c] = r3[c] + r1[c]; planes[3][c] = r3[c] - r1[c]; // bottom, top
+        planes[4][c] = r2[c];         planes[5][c] = r3[c] - r2[c]; // near (z >= 0), far
+    }
+    for (int p = 0; p < 6; ++p) {
+        const float len = std::sqrt(Dot3(planes[p], planes[p]));
+        if (len > 0) for (float& c : planes[p]) c /= len;
+    }
+}
+
+CullResult CullMeshlet(const CullView& view, const MeshletBounds& b, const float m[16], float padding) {
+    if (view.flags & kCullFrustum) {
+        float c[3]; TransformPoint(m, b.center, c);
+        const float scale = std::sqrt(std::max({ Dot3(m, m), Dot3(m + 4, m + 4), Dot3(m + 8, m + 8) }));
+        const float r = b.radius * scale + padding;
+        for (int p = 0; p < 6; ++p)
+            if (Dot3(view.frustum[p], c) + view.frustum[p][3] < -r) return CullResult::Frustum;
+    }
+    if ((view.flags & kCullCones) && b.coneCutoff < 1.0f) {
+        float apex[3], axis[3]; TransformPoint(m, b.coneApex, apex); TransformVector(m, b.coneAxis, axis);
+        const float d[3] = { apex[0] - view.cameraPos[0], apex[1] - view.cameraPos[1], apex[2] - view.cameraPos[2] };
+        const float dl = std::sqrt(Dot3(d, d)), al = std::sqrt(Dot3(axis, axis));
+        if (dl > 0 && al > 0 && Dot3(d, axis) >= b.coneCutoff * dl * al) return CullResult::Cone;
+    }
+    return CullResult::Visible;
+}
+
+CullStats CullCrowd(ThreadPool& pool, const MeshletMesh& mesh, const std::vector<MeshletBounds>& bounds,
+                    const std::vector<InstanceData>& instances, const float* palettes, const CullView& view,
+                    std::vector<CrowdDraw>* survivors) {
+    const size_t meshletCount = mesh.meshlets.size();
+    const size_t total = meshletCount * instances.size();
+    const size_t groups = (total + kAmplificationGroupSize - 1) / kAmplificationGroupSize;
+    if (survivors) survivors->assign(total, CrowdDraw{});
+    std::vector<uint32_t> groupCount(groups, 0);
+    std::mutex statsMutex;
+    CullStats stats;
+
+    pool.ParallelFor(0, groups, 64, [&](size_t gb, size_t ge) {
+        CullStats local;
+        float toWorld[16];
+        for (size_t g = gb; g < ge; ++g) {
+            uint32_t count = 0;
+            const size_t end = std::min(total, (g + 1) * kAmplificationGroupSize);
+            for (size_t i = g * kAmplificationGroupSize; i < end; ++i) {
+                const uint32_t instance = uint32_t(i / meshletCount), meshlet = uint32_t(i % meshletCount);
+                const InstanceData& inst = instances[instance];
+                const MeshletBounds& b = bounds[meshlet];
+                const uint32_t bone = inst.paletteOffset + mesh.boneRemap[mesh.meshlets[meshlet].boneBase + b.dominantBone];
+                Mat4Mul(inst.world, palettes + size_t(bone) * 16, toWorld);
+                local.tested++;
+                switch (CullMeshlet(view, b, toWorld, inst.boundsPadding)) {
+                case CullResult::Frustum: local.frustumCulled++; break;
+                case CullResult::Cone:    local.coneCulled++; break;
+                case CullResult::Visible:
+                    local.visible++;
+                    if (survivors) (*survivors)[g * kAmplificationGroupSize + count] = { instance, meshlet };
+                    count++;
+                    break;
+                }
+            }
+            groupCount[g] = count;
+        }
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.tested += local.tested; stats.frustumCulled += local.frustumCulled;
+        stats.coneCulled += local.coneCulled; stats.visible += local.visible;
+    });
+
+    if (survivors) { // squeeze the per-group payloads together, like consecutive mesh dispatches
+        size_t out = 0;
+        for (size_t g = 0; g < groups; ++g)
+            for (uint32_t k = 0; k < groupCount[g]; ++k) (*survivors)[out++] = (*survivors)[g * kAmplificationGroupSize + k];
+        survivors->resize(out);
+    }
+    return stats;
+}
@@ -0,0 +1,53 @@
+#pragma once
+// Crowd rendering support: per-meshlet culling bounds and a CPU emulation of ASMain's
+// frustum / normal-cone cull over (instance, meshlet) pairs.
+//
+// Bounds live in bind-pose mesh space and follow the meshlet's dominant bone: at cull time the
+// sphere and cone are moved by world * palette[dominant bone]. That is exact for rigid meshlets
+// (one bone); for blended meshlets InstanceData::boundsPadding absorbs the difference and the
+// cone test is disabled, since blending can turn triangles past the cone.
+
+#include "mesh_types.h"
+#include "meshlet.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+constexpr uint32_t kAmplificationGroupSize = 64; // AS_GROUP_SIZE in shaders/common.hlsli
+
+enum CullFlags : uint32_t { kCullFrustum = 1, kCullCones = 2 }; // CULL_* in common.hlsli
+
+// Ritter sphere + meshoptimizer-style normal cone (apex/axis/cutoff) per meshlet.
+std::vector<MeshletBounds> ComputeMeshletBounds(const MeshletMesh& mesh);
+
+struct CullView {
+    float frustum[6][4];   // world-space planes, inside when dot(n, p) + d >= 0
+    float cameraPos[3];
+    uint32_t flags = kCullFrustum | kCullCones;
+};
+// Planes of a column-major view-projection matrix with D3D clip space (0 <= z <= w).
+void ExtractFrustumPlanes(const float viewProj[16], float planes[6][4]);
+
+enum class CullResult : uint8_t { Visible, Frustum, Cone };
+
+// `toWorld` = instance world * skinning matrix of the meshlet's dominant bone.
+CullResult CullMeshlet(const CullView& view, const MeshletBounds& bounds, const float toWorld[16], float padding);
+
+struct CullStats {
+    size_t tested = 0, frustumCulled = 0, coneCulled = 0, visible = 0;
+    double CulledFraction() const { return tested ? double(frustumCulled + coneCulled) / double(tested) : 0.0; }
+};
+
+struct CrowdDraw { uint32_t instance, meshlet; }; // one Payload entry / mesh shader group
+
+// Emulates the crowd dispatch: thread i of the flattened (instance, meshlet) grid tests
+// instance i / meshletCount, meshlet i % meshletCount; every group of kAmplificationGroupSize
+// compacts its survivors in order. `survivors` (optional) receives the visible pairs in the
+// order the mesh shader groups would run. palettes: 16 floats per bone, indexed by
+// InstanceData::paletteOffset + boneRemap entry.
+CullStats CullCrowd(ThreadPool& pool, const MeshletMesh& mesh, const std::vector<MeshletBounds>& bounds,
+                    const std::vector<InstanceData>& instances, const float* palettes, const CullView& view,
+                    std::vector<CrowdDraw>* survivors = nullptr);
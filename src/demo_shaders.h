@@ -0,0 +1,46 @@
+#pragma once
+// Shader permutations of DX12MeshSkinningMinimal. The demo picks its descs from here and
+// tools/shaderc precompiles all of them, so both produce the same cache keys.
+
+#include "bone_palette.h"
+#include "shader_cache.h"
+
+#include <string>
+#include <vector>
+
+// Debug info and reflection are stripped from the DXIL and kept as cache side data.
+inline const std::vector<std::string> kDemoShaderArgs = { "-O3", "-Zi", "-Qstrip_debug", "-Qstrip_reflect", "-enable-16bit-types" };
+
+inline ShaderDesc DemoShader(const std::string& root, const char* file, const char* entry, const char* target,
+                             std::vector<std::string> defines = {}) {
+    return { root + "/" + file, entry, target, std::move(defines), { root }, kDemoShaderArgs };
+}
+
+inline std::string PaletteDefine(PaletteFormat format) { return "PALETTE_FORMAT=" + std::to_string(uint32_t(format)); }
+
+// ASMain reads gBones for its cone culling, so it follows the palette format too.
+inline ShaderDesc DemoAmplificationShader(const std::string& root, PaletteFormat format = PaletteFormat::Mat4x4) {
+    if (format == PaletteFormat::Mat4x4) return DemoShader(root, "as.hlsl", "ASMain", "as_6_5");
+    return DemoShader(root, "as.hlsl", "ASMain", "as_6_5", { PaletteDefine(format) });
+}
+
+// MSMain vertex-format permutation: raw VertexIn or vertex_pack.h words with u8/u16 joints,
+// times the bone palette format.
+inline ShaderDesc DemoMeshShader(const std::string& root, bool packed, bool joints16, PaletteFormat format = PaletteFormat::Mat4x4) {
+    std::vector<std::string> defines;
+    if (packed) defines = { "PACKED_VERTICES=1", joints16 ? "PACKED_JOINTS16=1" : "PACKED_JOINTS16=0" };
+    if (format != PaletteFormat::Mat4x4) defines.push_back(PaletteDefine(format));
+    return DemoShader(root, "ms.hlsl", "MSMain", "ms_6_5", std::move(defines));
+}
+
+inline std::vector<ShaderDesc> DemoShaderPermutations(const std::string& root = "shaders") {
+    std::vector<ShaderDesc> descs;
+    for (PaletteFormat f : { PaletteFormat::Mat4x4, PaletteFormat::Mat3x4, PaletteFormat::DualQuat }) {
+        descs.push_back(DemoAmplificationShader(root, f));
+        descs.push_back(DemoMeshShader(root, false, false, f));
+        descs.push_back(DemoMeshShader(root, true, false, f));
+        descs.push_back(DemoMeshShader(root, true, true, f));
+    }
+    descs.push_back(DemoShader(root, "ps.hlsl", "PSMain", "ps_6_6"));
+    return descs;
+}
@@ -0,0 +1,99 @@
+#include "dxc_compiler.h"
+
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+// Minimal COM reference holder; WRL is Windows-only and WinAdapter's CComPtr Linux-only.
+template <class T> struct DxcRef {
+    T* p = nullptr;
+    DxcRef() = default;
+    DxcRef(const DxcRef&) = delete;
+    DxcRef& operator=(const DxcRef&) = delete;
+    ~DxcRef() { if (p) p->Release(); }
+    T** operator&() { return &p; }
+    T* operator->() const { return p; }
+    T* Get() const { return p; }
+};
+
+// Shader paths, names and defines are ASCII in this repo.
+static std::wstring Widen(const std::string& s) { return std::wstring(s.begin(), s.end()); }
+static std::string Narrow(const wchar_t* s, size_t n) {
+    std::string out(n, '\0');
+    for (size_t i = 0; i < n; ++i) out[i] = char(s[i]);
+    return out;
+}
+
+static std::vector<uint8_t> BlobBytes(IDxcBlob* blob) {
+    if (!blob) return {};
+    const uint8_t* p = static_cast<const uint8_t*>(blob->GetBufferPointer());
+    return std::vector<uint8_t>(p, p + blob->GetBufferSize());
+}
+
+std::string DxcCompilerId(DxcCreateInstanceProc createInstance) {
+    DxcRef<IDxcCompiler3> compiler; DxcRef<IDxcVersionInfo> version;
+    if (FAILED(createInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler))) ||
+        FAILED(compiler->QueryInterface(IID_PPV_ARGS(&version))))
+        return "dxc unknown";
+    UINT32 major = 0, minor = 0; version->GetVersion(&major, &minor);
+    std::string id = "dxc " + std::to_string(major) + "." + std::to_string(minor);
+    DxcRef<IDxcVersionInfo2> version2;
+    if (SUCCEEDED(compiler->QueryInterface(IID_PPV_ARGS(&version2)))) {
+        UINT32 commits = 0; char* hash = nullptr;
+        if (SUCCEEDED(version2->GetCommitInfo(&commits, &hash)) && hash) {
+            id += " " + std::to_string(commits) + "-" + hash;
+            CoTaskMemFree(hash);
+        }
+    }
+    return id;
+}
+
+ShaderBinary CompileWithDxc(DxcCreateInstanceProc createInstance, const ShaderDesc& desc) {
+    DxcRef<IDxcUtils> utils; DxcRef<IDxcCompiler3> compiler; DxcRef<IDxcIncludeHandler> includeHandler;
+    if (FAILED(createInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils))) || FAILED(createInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler))))
+        throw std::runtime_error("DxcCreateInstance failed");
+    utils->CreateDefaultIncludeHandler(&includeHandler);
+
+    const std::wstring file = Widen(desc.file);
+    DxcRef<IDxcBlobEncoding> source;
+    if (FAILED(utils->LoadFile(file.c_str(), nullptr, &source))) throw std::runtime_error("Failed to load shader file: " + desc.file);
+    BOOL known = FALSE; UINT32 codePage = DXC_CP_ACP; source->GetEncoding(&known, &codePage);
+    DxcBuffer buffer{ source->GetBufferPointer(), source->GetBufferSize(), known ? codePage : DXC_CP_ACP };
+
+    std::vector<std::wstring> storage = { file, L"-E", Widen(desc.entry), L"-T", Widen(desc.target) };
+    for (const std::string& d : desc.defines)     { storage.push_back(L"-D"); storage.push_back(Widen(d)); }
+    for (const std::string& i : desc.includeDirs) { storage.push_back(L"-I"); storage.push_back(Widen(i)); }
+    for (const std::string& a : desc.args) storage.push_back(Widen(a));
+    std::vector<LPCWSTR> args;
+    for (const std::wstring& s : storage) args.push_back(s.c_str());
+
+    DxcRef<IDxcResult> result;
+    if (FAILED(compiler->Compile(&buffer, args.data(), UINT32(args.size()), includeHandler.Get(), IID_PPV_ARGS(&result))))
+        throw std::runtime_error("DXC compile failed: " + desc.file);
+    DxcRef<IDxcBlobUtf8> errors; result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr);
+    const std::string log = errors.Get() && errors->GetStringLength() ? std::string(errors->GetStringPointer(), errors->GetStringLength()) : std::string();
+    if (!log.empty()) {
+        fprintf(stderr, "%s", log.c_str());
+#ifdef _WIN32
+        OutputDebugStringA(log.c_str());
+#endif
+    }
+    HRESULT status = E_FAIL; result->GetStatus(&status);
+    if (FAILED(status)) throw std::runtime_error("Shader compile error in " + desc.file + " (" + desc.entry + "):\n" + log);
+
+    ShaderBinary out;
+    DxcRef<IDxcBlob> object; result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&object), nullptr);
+    out.object = BlobBytes(object.Get());
+    if (result->HasOutput(DXC_OUT_PDB)) {
+        DxcRef<IDxcBlob> pdb; DxcRef<IDxcBlobUtf16> pdbName;
+        result->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(&pdb), &pdbName);
+        out.pdb = BlobBytes(pdb.Get());
+        if (pdbName.Get()) out.pdbName = Narrow(pdbName->GetStringPointer(), pdbName->GetStringLength());
+    }
+    if (result->HasOutput(DXC_OUT_REFLECTION)) {
+        DxcRef<IDxcBlob> reflection; result->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(&reflection), nullptr);
+        out.reflection = BlobBytes(reflection.Get());
+    }
+    if (out.object.empty()) throw std::runtime_error("DXC produced no object for " + desc.file);
+    return out;
+}
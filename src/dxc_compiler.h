@@ -0,0 +1,20 @@
+#pragma once
+// ShaderCompileFn backed by DXC (IDxcCompiler3). Works with the Windows dxcompiler.dll and the
+// Linux libdxcompiler.so; the caller provides DxcCreateInstance (LoadLibrary'd or linked).
+// Every call creates its own compiler objects, so it can run on several threads at once.
+
+#include "shader_cache.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <dxcapi.h>
+
+#include <string>
+
+// "dxc <major>.<minor> <commit count>-<hash>"; part of every shader cache key.
+std::string DxcCompilerId(DxcCreateInstanceProc createInstance);
+
+// -E entry -T target -D defines -I includeDirs, then desc.args. Compiler messages go to stderr
+// (and the debugger on Windows); throws std::runtime_error with the log on failure.
+ShaderBinary CompileWithDxc(DxcCreateInstanceProc createInstance, const ShaderDesc& desc);
@@ -0,0 +1,359 @@
+#include "lod.h"
+#include "tinygltf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+static constexpr uint32_t kNone = ~0u;
+
+// Sum of squared distances to a set of area-weighted planes; Eval divides by the total area,
+// so costs are squared lengths whatever the tessellation density.
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0, b0 = 0, b1 = 0, b2 = 0, c = 0, w = 0;
+    void AddPlane(const double n[3], double d, double weight) {
+        a00 += weight * n[0] * n[0]; a01 += weight * n[0] * n[1]; a02 += weight * n[0] * n[2];
+        a11 += weight * n[1] * n[1]; a12 += weight * n[1] * n[2]; a22 += weight * n[2] * n[2];
+        b0 += weight * n[0] * d; b1 += weight * n[1] * d; b2 += weight * n[2] * d; c += weight * d * d; w += weight;
+    }
+    void Add(const Quadric& q) {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2; c += q.c; w += q.w;
+    }
+    double Eval(const float p[3]) const {
+        const double x = p[0], y = p[1], z = p[2];
+        const double e = a00*x*x + a11*y*y + a22*z*z + 2 * (a01*x*y + a02*x*z + a12*y*z) + 2 * (b0*x + b1*y + b2*z) + c;
+        return w > 0 ? std::max(e, 0.0) / w : 0.0;
+    }
+};
+
+static float Distance(const float a[3], const float b[3]) {
+    const float d[3] = { a[0] - b[0], a[1] - b[1], a[2] - b[2] };
+    return std::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+}
+
+// Closest point by Voronoi region (Ericson, Real-Time Collision Detection 5.1.5).
+float PointTriangleDistance(const float p[3], const float a[3], const float b[3], const float c[3]) {
+    auto sub = [](const float* x, const float* y, float* o) { for (int i = 0; i < 3; ++i) o[i] = x[i] - y[i]; };
+    auto dot = [](const float* x, const float* y) { return x[0]*y[0] + x[1]*y[1] + x[2]*y[2]; };
+    float ab[3], ac[3], ap[3], bp[3], cp[3], q[3];
+    sub(b, a, ab); sub(c, a, ac); sub(p, a, ap); sub(p, b, bp); sub(p, c, cp);
+    const float d1 = dot(ab, ap), d2 = dot(ac, ap), d3 = dot(ab, bp), d4 = dot(ac, bp), d5 = dot(ab, cp), d6 = dot(ac, cp);
+    const float va = d3 * d6 - d5 * d4, vb = d5 * d2 - d1 * d6, vc = d1 * d4 - d3 * d2;
+    if (d1 <= 0 && d2 <= 0) return Distance(p, a);
+    if (d3 >= 0 && d4 <= d3) return Distance(p, b);
+    if (d6 >= 0 && d5 <= d6) return Distance(p, c);
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) { const float t = d1 / (d1 - d3); for (int i = 0; i < 3; ++i) q[i] = a[i] + t * ab[i]; }
+    else if (vb <= 0 && d2 >= 0 && d6 <= 0) { const float t = d2 / (d2 - d6); for (int i = 0; i < 3; ++i) q[i] = a[i] + t * ac[i]; }
+    else if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0) {
+        const float t = (d4 - d3) / ((d4 - d3) + (d5 - d6)); for (int i = 0; i < 3; ++i) q[i] = b[i] + t * (c[i] - b[i]);
+    } else {
+        const float denom = 1.0f / (va + vb + vc);
+        for (int i = 0; i < 3; ++i) q[i] = a[i] + vb * denom * ab[i] + vc * denom * ac[i];
+    }
+    return Distance(p, q);
+}
+
+static void TriangleNormal(const float* a, const float* b, const float* c, double n[3]) {
+    const double e1[3] = { double(b[0]) - a[0], double(b[1]) - a[1], double(b[2]) - a[2] };
+    const double e2[3] = { double(c[0]) - a[0], double(c[1]) - a[1], double(c[2]) - a[2] };
+    n[0] = e1[1]*e2[2] - e1[2]*e2[1]; n[1] = e1[2]*e2[0] - e1[0]*e2[2]; n[2] = e1[0]*e2[1] - e1[1]*e2[0];
+}
+
+static float JointWeight(const VertexIn& v, uint32_t joint) {
+    float w = 0;
+    for (int k = 0; k < 4; ++k) if (v.boneIdx[k] == joint) w += v.boneWgt[k];
+    return w;
+}
+
+// L1 distance between the joint weight vectors of two vertices (0..2 for normalized weights).
+static float SkinDistance(const VertexIn& a, const VertexIn& b) {
+    float d = 0;
+    for (int k = 0; k < 4; ++k) {
+        if (a.boneWgt[k] > 0.0f) d += std::abs(a.boneWgt[k] - JointWeight(b, a.boneIdx[k]));
+        if (b.boneWgt[k] > 0.0f && JointWeight(a, b.boneIdx[k]) == 0.0f) d += b.boneWgt[k];
+    }
+    return d;
+}
+
+struct Collapse { float cost; uint32_t from, to; };
+
+// Mutable simplification state; triangles are only ever removed, vertices only ever retired.
+struct Simplifier {
+    const std::vector<VertexIn>& src;
+    const LodOptions& opt;
+    std::vector<uint32_t> tris;                 // 3 per triangle, rewritten by collapses
+    std::vector<uint8_t> triAlive;
+    size_t liveTris = 0;
+    std::vector<std::vector<uint32_t>> vertTris; // may hold dead triangles
+    std::vector<Quadric> quadric;
+    std::vector<uint8_t> locked, alive;
+    std::vector<uint32_t> collapsedInto, touched, stamp;
+    std::vector<uint32_t> heavy;                // 4 per vertex, joints pinning it (kNone = unused)
+    std::vector<Collapse> edges;
+    uint32_t stampValue = 0, pass = 0;
+
+    Simplifier(const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices, const LodOptions& o)
+        : src(vertices), opt(o) {
+        const size_t V = vertices.size();
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            const uint32_t a = indices[t], b = indices[t + 1], c = indices[t + 2];
+            if (a >= V || b >= V || c >= V) throw std::runtime_error("Vertex index out of range");
+            if (a != b && b != c && a != c) tris.insert(tris.end(), { a, b, c });
+        }
+        liveTris = tris.size() / 3;
+        triAlive.assign(liveTris, 1);
+        vertTris.resize(V); quadric.resize(V); locked.assign(V, 0); alive.assign(V, 1);
+        collapsedInto.assign(V, kNone); touched.assign(V, 0); stamp.assign(V, 0); heavy.assign(V * 4, kNone);
+
+        for (uint32_t t = 0; t < liveTris; ++t) {
+            const uint32_t* tri = &tris[t * 3];
+            double n[3]; TriangleNormal(src[tri[0]].pos, src[tri[1]].pos, src[tri[2]].pos, n);
+            const double len = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+            for (int c = 0; c < 3; ++c) vertTris[tri[c]].push_back(t);
+            if (len == 0) continue;
+            for (double& x : n) x /= len;
+            const double d = -(n[0] * src[tri[0]].pos[0] + n[1] * src[tri[0]].pos[1] + n[2] * src[tri[0]].pos[2]);
+            for (int c = 0; c < 3; ++c) quadric[tri[c]].AddPlane(n, d, 0.5 * len);
+        }
+
+        // borders and non-manifold edges: every undirected edge must be used exactly twice
+        std::vector<uint64_t> edges; edges.reserve(tris.size());
+        for (size_t t = 0; t < tris.size(); t += 3)
+            for (int c = 0; c < 3; ++c) {
+                const uint32_t a = tris[t + c], b = tris[t + (c + 1) % 3];
+                edges.push_back(uint64_t(std::min(a, b)) << 32 | std::max(a, b));
+            }
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size();) {
+            size_t j = i; while (j < edges.size() && edges[j] == edges[i]) ++j;
+            if (j - i != 2) locked[edges[i] >> 32] = locked[uint32_t(edges[i])] = 1;
+            i = j;
+        }
+        // attribute seams: split vertices at one position stay where they are
+        std::vector<uint32_t> order(V);
+        for (uint32_t v = 0; v < V; ++v) order[v] = v;
+        auto samePos = [&](uint32_t a, uint32_t b) { return std::equal(src[a].pos, src[a].pos + 3, src[b].pos); };
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return std::lexicographical_compare(src[a].pos, src[a].pos + 3, src[b].pos, src[b].pos + 3);
+        });
+        for (size_t i = 1; i < V; ++i)
+            if (samePos(order[i - 1], order[i])) locked[order[i - 1]] = locked[order[i]] = 1;
+
+        for (uint32_t v = 0; v < V; ++v) {
+            int n = 0;
+            for (int k = 0; k < 4; ++k)
+                if (src[v].boneWgt[k] >= opt.heavyWeight && src[v].boneWgt[k] > 0.0f &&
+                    std::find(&heavy[v * 4], &heavy[v * 4] + n, src[v].boneIdx[k]) == &heavy[v * 4] + n)
+                    heavy[v * 4 + n++] = src[v].boneIdx[k];
+        }
+    }
+
+    bool HasTri(uint32_t t, uint32_t v) const { return tris[t * 3] == v || tris[t * 3 + 1] == v || tris[t * 3 + 2] == v; }
+
+    // Every joint pinning `from` (or anything merged into it) must influence `to`.
+    bool SkinCompatible(uint32_t from, uint32_t to) const {
+        for (int k = 0; k < 4; ++k) {
+            const uint32_t j = heavy[from * 4 + k];
+            if (j != kNone && JointWeight(src[to], j) == 0.0f) return false;
+        }
+        return true;
+    }
+
+    void AddCandidate(uint32_t from, uint32_t to) {
+        if (locked[from] || !SkinCompatible(from, to)) return;
+        Quadric q = quadric[from]; q.Add(quadric[to]);
+        const float len = Distance(src[from].pos, src[to].pos);
+        const float cost = float(q.Eval(src[to].pos)) + opt.skinWeight * SkinDistance(src[from], src[to]) * len * len;
+        edges.push_back({ cost, from, to });
+    }
+
+    // Marks the live neighbours of v with a fresh stamp and returns them.
+    void Neighbours(uint32_t v, std::vector<uint32_t>& out) {
+        out.clear(); ++stampValue;
+        for (uint32_t t : vertTris[v]) {
+            if (!triAlive[t]) continue;
+            for (int c = 0; c < 3; ++c) {
+                const uint32_t w = tris[t * 3 + c];
+                if (w != v && stamp[w] != stampValue) { stamp[w] = stampValue; out.push_back(w); }
+            }
+        }
+    }
+
+    bool Valid(uint32_t from, uint32_t to, std::vector<uint32_t>& scratch) {
+        // link condition: shared neighbours must be exactly the apexes of the shared triangles,
+        // otherwise the collapse pinches the surface into a non-manifold edge
+        Neighbours(to, scratch);
+        const uint32_t toStamp = stampValue;
+        size_t shared = 0, common = 0;
+        for (uint32_t t : vertTris[from]) if (triAlive[t] && HasTri(t, to)) ++shared;
+        ++stampValue;
+        for (uint32_t t : vertTris[from]) {
+            if (!triAlive[t]) continue;
+            for (int c = 0; c < 3; ++c) {
+                const uint32_t w = tris[t * 3 + c];
+                if (w == from || w == to || stamp[w] == stampValue) continue;
+                common += stamp[w] == toStamp;
+                stamp[w] = stampValue;
+            }
+        }
+        if (shared == 0 || common != shared) return false;
+        // no surviving triangle may flip or collapse to a sliver
+        for (uint32_t t : vertTris[from]) {
+            if (!triAlive[t] || HasTri(t, to)) continue;
+            const float* p[3]; const float* q[3];
+            for (int c = 0; c < 3; ++c) {
+                p[c] = src[tris[t * 3 + c]].pos;
+                q[c] = tris[t * 3 + c] == from ? src[to].pos : p[c];
+            }
+            double n0[3], n1[3]; TriangleNormal(p[0], p[1], p[2], n0); TriangleNormal(q[0], q[1], q[2], n1);
+            const double d = n0[0]*n1[0] + n0[1]*n1[1] + n0[2]*n1[2];
+            const double l0 = std::sqrt(n0[0]*n0[0] + n0[1]*n0[1] + n0[2]*n0[2]), l1 = std::sqrt(n1[0]*n1[0] + n1[1]*n1[1] + n1[2]*n1[2]);
+            if (d <= 0.01 * l0 * l1) return false;
+        }
+        return true;
+    }
+
+    void Apply(uint32_t from, uint32_t to) {
+        for (uint32_t t : vertTris[from]) {
+            if (!triAlive[t]) continue;
+            if (HasTri(t, to)) { triAlive[t] = 0; --liveTris; continue; }
+            for (int c = 0; c < 3; ++c) if (tris[t * 3 + c] == from) tris[t * 3 + c] = to;
+            vertTris[to].push_back(t);
+        }
+        vertTris[from].clear(); vertTris[from].shrink_to_fit();
+        auto& list = vertTris[to];
+        list.erase(std::remove_if(list.begin(), list.end(), [&](uint32_t t) { return !triAlive[t]; }), list.end());
+        quadric[to].Add(quadric[from]);
+        for (int k = 0; k < 4; ++k) {
+            const uint32_t j = heavy[from * 4 + k];
+            if (j == kNone) continue;
+            uint32_t* h = &heavy[to * 4];
+            if (std::find(h, h + 4, j) == h + 4) *std::find(h, h + 4, kNone) = j; // j influences `to`: at most 4
+        }
+        alive[from] = 0; collapsedInto[from] = to;
+    }
+
+    // Collapses cheap valid edges until at most `target` triangles are left. Works in passes: all
+    // candidate edges are costed once, then the cheapest are applied in order, skipping any that
+    // touch a vertex already changed this pass (its costs are stale until the next pass). Returns
+    // false when a pass can no longer collapse anything.
+    bool Simplify(size_t target) {
+        std::vector<uint32_t> scratch;
+        size_t widen = 1;
+        while (liveTris > target) {
+            // consistently wound manifold edges appear once in each direction
+            edges.clear();
+            for (uint32_t t = 0; t < triAlive.size(); ++t)
+                if (triAlive[t]) for (int c = 0; c < 3; ++c) AddCandidate(tris[t * 3 + c], tris[t * 3 + (c + 1) % 3]);
+            // each collapse removes about two triangles; look at a little more than that many edges,
+            // and further when none of those is valid
+            const size_t window = std::min(edges.size(), ((liveTris - target) / 2 * 3 / 2 + 1) * widen);
+            std::nth_element(edges.begin(), edges.begin() + (window - (window > 0)), edges.end(),
+                             [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+            std::sort(edges.begin(), edges.begin() + window, [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+            ++pass;
+            size_t applied = 0;
+            for (size_t i = 0; i < window && liveTris > target; ++i) {
+                const Collapse& c = edges[i];
+                if (touched[c.from] == pass || touched[c.to] == pass || !Valid(c.from, c.to, scratch)) continue;
+                Apply(c.from, c.to);
+                touched[c.from] = touched[c.to] = pass;
+                ++applied;
+            }
+            if (!applied && window == edges.size()) return false;
+            widen = applied ? 1 : widen * 4;
+        }
+        return true;
+    }
+
+    uint32_t Representative(uint32_t v) {
+        uint32_t r = v;
+        while (collapsedInto[r] != kNone) r = collapsedInto[r];
+        while (collapsedInto[v] != kNone && collapsedInto[v] != r) { const uint32_t next = collapsedInto[v]; collapsedInto[v] = r; v = next; }
+        return r;
+    }
+
+    LodLevel Snapshot(float previousError) {
+        LodLevel level;
+        std::vector<uint32_t> levelIndex(src.size(), kNone);
+        for (size_t t = 0; t < triAlive.size(); ++t)
+            if (triAlive[t]) for (int c = 0; c < 3; ++c) levelIndex[tris[t * 3 + c]] = 0;
+        for (uint32_t v = 0; v < src.size(); ++v)
+            if (levelIndex[v] != kNone) {
+                levelIndex[v] = uint32_t(level.vertices.size());
+                level.vertices.push_back(src[v]); level.sourceVertex.push_back(v);
+            }
+        level.indices.reserve(liveTris * 3);
+        for (size_t t = 0; t < triAlive.size(); ++t)
+            if (triAlive[t]) for (int c = 0; c < 3; ++c) level.indices.push_back(levelIndex[tris[t * 3 + c]]);
+
+        std::vector<float> vertexError(level.vertices.size(), 0.0f);
+        level.remap.assign(src.size(), kNone);
+        level.error = previousError;
+        for (uint32_t s = 0; s < src.size(); ++s) {
+            const uint32_t r = Representative(s);
+            if (levelIndex[r] == kNone) continue;
+            level.remap[s] = levelIndex[r];
+            float e = s == r ? 0.0f : Distance(src[s].pos, src[r].pos);
+            for (uint32_t t : vertTris[r])
+                if (triAlive[t] && e > 0.0f)
+                    e = std::min(e, PointTriangleDistance(src[s].pos, src[tris[t * 3]].pos, src[tris[t * 3 + 1]].pos, src[tris[t * 3 + 2]].pos));
+            vertexError[levelIndex[r]] = std::max(vertexError[levelIndex[r]], e);
+            level.error = std::max(level.error, e);
+        }
+
+        level.meshlets = BuildMeshlets(level.vertices, level.indices, opt.meshlet);
+        level.bounds = ComputeMeshletBounds(level.meshlets);
+        level.meshletError.assign(level.meshlets.meshlets.size(), 0.0f);
+        for (size_t m = 0; m < level.meshlets.meshlets.size(); ++m) {
+            const MeshletData& md = level.meshlets.meshlets[m];
+            for (uint32_t v = 0; v < md.vCount; ++v)
+                level.meshletError[m] = std::max(level.meshletError[m], vertexError[level.meshlets.sourceVertex[md.vOffset + v]]);
+        }
+        return level;
+    }
+};
+
+LodChain BuildLodChain(const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices, const LodOptions& options) {
+    Simplifier s(vertices, indices, options);
+    LodChain chain;
+    chain.levels.push_back(s.Snapshot(0.0f));
+
+    const std::vector<VertexIn>& base = chain.levels[0].vertices;
+    if (!base.empty()) {
+        float lo[3], hi[3];
+        for (int c = 0; c < 3; ++c) lo[c] = hi[c] = base[0].pos[c];
+        for (const VertexIn& v : base)
+            for (int c = 0; c < 3; ++c) { lo[c] = std::min(lo[c], v.pos[c]); hi[c] = std::max(hi[c], v.pos[c]); }
+        for (int c = 0; c < 3; ++c) chain.center[c] = 0.5f * (lo[c] + hi[c]);
+        for (const VertexIn& v : base) chain.radius = std::max(chain.radius, Distance(v.pos, chain.center));
+    }
+
+    while (chain.levels.size() < options.maxLevels && s.liveTris > options.minTriangles) {
+        const size_t before = s.liveTris;
+        const bool reached = s.Simplify(std::max(size_t(options.minTriangles), size_t(double(before) * options.reduction)));
+        if (s.liveTris == before) break;
+        chain.levels.push_back(s.Snapshot(chain.levels.back().error));
+        if (!reached) break;
+    }
+    return chain;
+}
+
+LodChain BuildLodChain(const tinygltf::Model& model, const tinygltf::Primitive& prim, const LodOptions& options) {
+    std::vector<VertexIn> vertices; std::vector<uint32_t> indices;
+    ReadPrimitiveVertices(model, prim, vertices, indices);
+    return BuildLodChain(vertices, indices, options);
+}
+
+float LodProjectionScale(float fovY, float viewportHeight) {
+    return viewportHeight / (2.0f * std::tan(0.5f * fovY));
+}
+
+uint32_t SelectLod(const LodChain& chain, float distance, float projScale, float maxPixelError, float scale) {
+    // error measured at the sphere's nearest point, so a level never pops in closer than promised
+    const float nearest = std::max(distance - chain.radius * scale, 1e-3f);
+    for (size_t i = chain.levels.size(); i-- > 1;)
+        if (chain.levels[i].error * scale * projScale / nearest <= maxPixelError) return uint32_t(i);
+    return 0;
+}
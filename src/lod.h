@@ -0,0 +1,63 @@
+#pragma once
+// Offline LOD chains for skinned primitives: progressive edge-collapse simplification
+// (Garland-Heckbert quadrics), each level meshletized with culling bounds and a geometric error
+// for distance-based selection.
+//
+// Collapses are half-edge: a vertex moves onto a neighbour, so every surviving vertex keeps its
+// own position, normal and joint weights. They are also skin-aware: a vertex only merges into
+// one skinned to every joint that it, or anything already merged into it, weights with at least
+// LodOptions::heavyWeight, so no collapse crosses a heavily-weighted joint boundary. Open
+// borders, non-manifold edges and attribute seams (split vertices sharing a position) are locked.
+
+#include "crowd.h"
+#include "meshlet.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace tinygltf { class Model; struct Primitive; }
+
+struct LodOptions {
+    uint32_t maxLevels    = 6;     // including the source level
+    float    reduction    = 0.5f;  // target triangle ratio between consecutive levels
+    uint32_t minTriangles = 64;    // no level is simplified below this
+    float    heavyWeight  = 0.25f; // joint weight that pins a vertex to its joint; > 1 disables the constraint
+    float    skinWeight   = 1.0f;  // collapse cost per unit of L1 joint weight difference, in squared edge lengths
+    MeshletLimits meshlet;
+};
+
+struct LodLevel {
+    std::vector<VertexIn> vertices;     // surviving source vertices, attributes unchanged
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> sourceVertex; // level vertex -> source vertex
+    std::vector<uint32_t> remap;        // source vertex -> level vertex it collapsed into
+    // Local error estimate: largest bind-pose distance from a source vertex to the triangles around
+    // the vertex it collapsed into; never below the previous level's. The distance to the whole
+    // level surface is never larger, but can be much smaller.
+    float error = 0.0f;
+    MeshletMesh meshlets;
+    std::vector<MeshletBounds> bounds;
+    std::vector<float> meshletError;    // same estimate over the source vertices each meshlet absorbed
+};
+
+struct LodChain {
+    std::vector<LodLevel> levels;       // levels[0] is the source mesh; triangles shrink, error grows
+    float center[3] = {}; float radius = 0.0f; // bind-pose bounding sphere
+};
+
+// Throws std::runtime_error on out-of-range indices. Stops early when a level can no longer
+// reach its triangle target (everything left is locked or would flip).
+LodChain BuildLodChain(const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices,
+                       const LodOptions& options = {});
+LodChain BuildLodChain(const tinygltf::Model& model, const tinygltf::Primitive& prim, const LodOptions& options = {});
+
+// Distance from p to the triangle abc.
+float PointTriangleDistance(const float p[3], const float a[3], const float b[3], const float c[3]);
+
+// Pixels per unit length at distance 1: viewportHeight / (2 tan(fovY / 2)).
+float LodProjectionScale(float fovY, float viewportHeight);
+
+// Coarsest level whose error, times `scale` (the instance's world scale), projects to at most
+// maxPixelError. `distance` is from the camera to the bounding sphere centre; the error is
+// projected at the sphere's nearest point.
+uint32_t SelectLod(const LodChain& chain, float distance, float projScale, float maxPixelError, float scale = 1.0f);
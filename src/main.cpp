@@ -9,10 +9,31 @@
 #include <chrono>
 #include <stdexcept>
 #include <cassert>
+#include "mesh_types.h"
+#include "meshlet.h"
+#include "vertex_pack.h"
+#include "ring_allocator.h"
+#include "crowd.h"
+#include "mat4.h"
+#include "demo_shaders.h"
+#include "dxc_compiler.h"
+#include "thread_pool.h"
+#include "profiler.h"
+#include "bone_palette.h"
 using Microsoft::WRL::ComPtr;
 
 static const UINT kWidth = 1280;
 static const UINT kHeight = 720;
+static const bool kPackedVertices = true; // vertex_pack.h layout instead of raw VertexIn
+static const PaletteFormat kPaletteFormat = PaletteFormat::DualQuat; // gBones encoding, see bone_palette.h
+static const UINT kFramesInFlight = 3;     // swap chain buffers == frame contexts
+static const UINT kCrowdSide = 48;         // kCrowdSide^2 skinned instances in one DispatchMesh
+static const UINT kBonesPerInstance = 2;
+static const float kCrowdSpacing = 1.5f;
+static const UINT64 kUploadRingSize = (UINT64(kCrowdSide) * kCrowdSide * kBonesPerInstance * PaletteFloats(kPaletteFormat) * 4 + 64 * 1024) * kFramesInFlight; // per-frame constants + bone palettes
+static const UINT kGpuTimestampsPerFrame = 4;   // clear begin/end, dispatch begin/end
+static const size_t kMaxTraceEvents = 1 << 20;    // frame_trace.json keeps the most recent events
+static_assert(kFramesInFlight >= 2 && kFramesInFlight <= RingAllocator::kMaxFramesInFlight);
 
 LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
@@ -24,29 +45,21 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     return 0;
 }
 
-struct VertexIn { float pos[3]; float nrm[3]; unsigned int boneIdx[4]; float boneWgt[4]; };
-struct MeshletData { UINT vCount, pCount; UINT vOffset, pOffset; UINT boneBase; };
-struct GlobalsCB { float mvp[16]; float time; float pad[3]; };
+struct GlobalsCB { float viewProj[16]; float frustum[6][4]; float cameraPos[3]; float time; UINT meshletCount, instanceCount, cullFlags, pad; };
 
 static void MakeIdentity(float m[16]) { memset(m,0,64); m[0]=m[5]=m[10]=m[15]=1.0f; }
-static void MakeOrtho(float m[16], float w, float h) { MakeIdentity(m); m[0]=2.0f/w; m[5]=-2.0f/h; m[10]=1.0f; m[12]=-1.0f; m[13]=1.0f; }
-
-ComPtr<IDxcBlob> CompileHLSL(ComPtr<IDxcCompiler3> compiler, ComPtr<IDxcUtils> utils,
-    const std::wstring& file, const wchar_t* entry, const wchar_t* target)
-{
-    ComPtr<IDxcIncludeHandler> includeHandler; utils->CreateDefaultIncludeHandler(&includeHandler);
-    DxcBuffer buffer{};
-    ComPtr<IDxcBlobEncoding> source;
-    if (FAILED(utils->LoadFile(file.c_str(), nullptr, &source))) throw std::runtime_error("Failed to load shader file");
-    buffer.Ptr = source->GetBufferPointer(); buffer.Size = source->GetBufferSize(); buffer.Encoding = DXC_CP_ACP;
-    const wchar_t* args[] = { L"-E", entry, L"-T", target, L"-Zi", L"-Qembed_debug", L"-O3", L"-enable-16bit-types" };
-    ComPtr<IDxcResult> result;
-    if (FAILED(compiler->Compile(&buffer, args, _countof(args), includeHandler.Get(), IID_PPV_ARGS(&result))))
-        throw std::runtime_error("DXC compile failed");
-    ComPtr<IDxcBlobUtf8> errors; result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr);
-    if (errors && errors->GetStringLength() > 0) OutputDebugStringA(errors->GetStringPointer());
-    HRESULT status; result->GetStatus(&status); if (FAILED(status)) throw std::runtime_error("Shader compile error");
-    ComPtr<IDxcBlob> blob; result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&blob), nullptr); return blob;
+// Right-handed, D3D clip space (0 <= z <= w), column-major like gBones.
+static void MakePerspective(float m[16], float fovY, float aspect, float zn, float zf) {
+    memset(m,0,64); const float f = 1.0f / tanf(fovY*0.5f);
+    m[0]=f/aspect; m[5]=f; m[10]=zf/(zn-zf); m[11]=-1.0f; m[14]=zn*zf/(zn-zf);
+}
+static void MakeLookAt(float m[16], const float eye[3], const float at[3]) {
+    float z[3] = { eye[0]-at[0], eye[1]-at[1], eye[2]-at[2] }; float zl = sqrtf(z[0]*z[0]+z[1]*z[1]+z[2]*z[2]); for (float& c : z) c /= zl;
+    float x[3] = { z[2], 0.0f, -z[0] }; float xl = sqrtf(x[0]*x[0]+x[2]*x[2]); for (float& c : x) c /= xl; // up = +Y
+    const float y[3] = { z[1]*x[2]-z[2]*x[1], z[2]*x[0]-z[0]*x[2], z[0]*x[1]-z[1]*x[0] };
+    MakeIdentity(m);
+    for (int i = 0; i < 3; ++i) { m[i*4] = x[i]; m[i*4+1] = y[i]; m[i*4+2] = z[i]; }
+    m[12] = -(x[0]*eye[0]+x[1]*eye[1]+x[2]*eye[2]); m[13] = -(y[0]*eye[0]+y[1]*eye[1]+y[2]*eye[2]); m[14] = -(z[0]*eye[0]+z[1]*eye[1]+z[2]*eye[2]);
 }
 
 int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ LPWSTR, _In_ int)
@@ -69,53 +82,95 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ LPWSTR,
 
     D3D12_COMMAND_QUEUE_DESC qd{}; qd.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
     ComPtr<ID3D12CommandQueue> queue; device->CreateCommandQueue(&qd, IID_PPV_ARGS(&queue));
-    DXGI_SWAP_CHAIN_DESC1 sc{}; sc.Width = kWidth; sc.Height = kHeight; sc.BufferCount = 2; sc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    DXGI_SWAP_CHAIN_DESC1 sc{}; sc.Width = kWidth; sc.Height = kHeight; sc.BufferCount = kFramesInFlight; sc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
     sc.SampleDesc = {1,0}; sc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT; sc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
     ComPtr<IDXGISwapChain1> sc1; factory->CreateSwapChainForHwnd(queue.Get(), hwnd, &sc, nullptr, nullptr, &sc1);
     ComPtr<IDXGISwapChain3> swap; sc1.As(&swap); UINT frameIndex = swap->GetCurrentBackBufferIndex();
 
     // RTVs
-    ComPtr<ID3D12DescriptorHeap> rtvHeap; D3D12_DESCRIPTOR_HEAP_DESC rtvDesc{}; rtvDesc.NumDescriptors=2; rtvDesc.Type=D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+    ComPtr<ID3D12DescriptorHeap> rtvHeap; D3D12_DESCRIPTOR_HEAP_DESC rtvDesc{}; rtvDesc.NumDescriptors=kFramesInFlight; rtvDesc.Type=D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
     device->CreateDescriptorHeap(&rtvDesc, IID_PPV_ARGS(&rtvHeap)); auto rtvInc = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-    std::vector<ComPtr<ID3D12Resource>> backbuf(2);
-    for (UINT i=0;i<2;i++) { swap->GetBuffer(i, IID_PPV_ARGS(&backbuf[i]));
+    std::vector<ComPtr<ID3D12Resource>> backbuf(kFramesInFlight);
+    for (UINT i=0;i<kFramesInFlight;i++) { swap->GetBuffer(i, IID_PPV_ARGS(&backbuf[i]));
         D3D12_CPU_DESCRIPTOR_HANDLE h = rtvHeap->GetCPUDescriptorHandleForHeapStart(); h.ptr += SIZE_T(i)*SIZE_T(rtvInc);
         device->CreateRenderTargetView(backbuf[i].Get(), nullptr, h); }
 
-    // Command list + fence
-    ComPtr<ID3D12CommandAllocator> alloc; device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&alloc));
-    ComPtr<ID3D12GraphicsCommandList6> list; device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, alloc.Get(), nullptr, IID_PPV_ARGS(&list));
+    // Frame contexts: one command allocator + the fence value that retires it, per frame in flight
+    struct FrameContext { ComPtr<ID3D12CommandAllocator> alloc; UINT64 fenceValue = 0; };
+    FrameContext frames[kFramesInFlight];
+    for (auto& f : frames) device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&f.alloc));
+    ComPtr<ID3D12GraphicsCommandList6> list; device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, frames[0].alloc.Get(), nullptr, IID_PPV_ARGS(&list));
+    list->Close(); // reopened per frame
     ComPtr<ID3D12Fence> fence; UINT64 fenceValue=0; device->CreateFence(fenceValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
     HANDLE fenceEvent = CreateEvent(nullptr,FALSE,FALSE,nullptr);
-    auto WaitGPU = [&](){ fenceValue++; queue->Signal(fence.Get(), fenceValue);
-        if (fence->GetCompletedValue() < fenceValue){ fence->SetEventOnCompletion(fenceValue, fenceEvent); WaitForSingleObject(fenceEvent, INFINITE);} };
+    UINT64 fenceStallNs = 0; // reported per frame
+    auto WaitFence = [&](UINT64 value){
+        if (fence->GetCompletedValue() < value){
+            GRFX_PROFILE_ZONE("Wait fence"); const uint64_t t0 = ProfileNow();
+            fence->SetEventOnCompletion(value, fenceEvent); WaitForSingleObject(fenceEvent, INFINITE);
+            fenceStallNs += ProfileNow() - t0;
+        } };
+    auto WaitGPU = [&](){ fenceValue++; queue->Signal(fence.Get(), fenceValue); WaitFence(fenceValue); };
 
-    // Root signature: CBV b0 + SRVs t0..t3 as root descriptors
-    D3D12_ROOT_PARAMETER1 params[5]{};
+    // Root signature: CBV b0 + SRVs t0..t7 as root descriptors
+    D3D12_ROOT_PARAMETER1 params[9]{};
     params[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV; params[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL; params[0].Descriptor = {0,0};
-    for(int i=0;i<4;i++){ params[1+i].ParameterType=D3D12_ROOT_PARAMETER_TYPE_SRV; params[1+i].ShaderVisibility=D3D12_SHADER_VISIBILITY_ALL; params[1+i].Descriptor={(UINT)i,0}; }
+    for(int i=0;i<8;i++){ params[1+i].ParameterType=D3D12_ROOT_PARAMETER_TYPE_SRV; params[1+i].ShaderVisibility=D3D12_SHADER_VISIBILITY_ALL; params[1+i].Descriptor={(UINT)i,0}; }
     D3D12_VERSIONED_ROOT_SIGNATURE_DESC rsd{}; rsd.Version=D3D_ROOT_SIGNATURE_VERSION_1_1;
-    D3D12_ROOT_SIGNATURE_DESC1 d{}; d.NumParameters=5; d.pParameters=params; d.Flags=D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT; rsd.Desc_1_1=d;
+    D3D12_ROOT_SIGNATURE_DESC1 d{}; d.NumParameters=9; d.pParameters=params; d.Flags=D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT; rsd.Desc_1_1=d;
     ComPtr<ID3DBlob> rsBlob, rsErr; D3D12SerializeVersionedRootSignature(&rsd,&rsBlob,&rsErr);
     ComPtr<ID3D12RootSignature> rootSig; device->CreateRootSignature(0, rsBlob->GetBufferPointer(), rsBlob->GetBufferSize(), IID_PPV_ARGS(&rootSig));
 
+    // Geometry: quad (4 verts, 2 tris) run through the meshletizer, 2 bones
+    std::vector<VertexIn> verts = {
+        {{-0.5f,  0.5f, 0.0f},{0,0,1},{0,0,0,0},{1,0,0,0}},
+        {{ 0.5f,  0.5f, 0.0f},{0,0,1},{0,0,0,0},{1,0,0,0}},
+        {{-0.5f, -0.5f, 0.0f},{0,0,1},{1,0,0,0},{1,0,0,0}},
+        {{ 0.5f, -0.5f, 0.0f},{0,0,1},{1,0,0,0},{1,0,0,0}},
+    };
+    std::vector<uint32_t> indices = { 0,2,1, 1,2,3 };
+    MeshletMesh mesh = BuildMeshlets(verts, indices);
+    PackedVertices packed = PackMeshletVertices(mesh);
+    std::vector<MeshletBounds> meshletBounds = ComputeMeshletBounds(mesh);
+
+    // Crowd: a grid of instances, each with its own palette slice in gBones
+    std::vector<InstanceData> instances(kCrowdSide * kCrowdSide);
+    for (UINT i = 0; i < instances.size(); ++i) {
+        InstanceData& inst = instances[i]; MakeIdentity(inst.world);
+        inst.world[12] = (float(i % kCrowdSide) - 0.5f * kCrowdSide) * kCrowdSpacing;
+        inst.world[14] = -(float(i / kCrowdSide)) * kCrowdSpacing;
+        inst.paletteOffset = i * kBonesPerInstance;
+        inst.boundsPadding = 0.5f; // bone 1 swings the lower half by up to ~0.5
+    }
+
     // DXC load
     HMODULE dxcm = LoadLibrary("dxcompiler.dll");
     if(!dxcm){ MessageBox(hwnd,"dxcompiler.dll not found.","DXC missing",MB_OK); return 0; }
     auto DxcCreateInstance = reinterpret_cast<HRESULT (WINAPI *)(REFCLSID, REFIID, LPVOID*)>(GetProcAddress(dxcm,"DxcCreateInstance"));
     if(!DxcCreateInstance){ MessageBox(hwnd,"Failed to get DxcCreateInstance","DXC error",MB_OK); return 0; }
-    ComPtr<IDxcUtils> dxcUtils; ComPtr<IDxcCompiler3> dxc; DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&dxcUtils)); DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&dxc));
-    auto asBlob = CompileHLSL(dxc,dxcUtils,L"shaders/as.hlsl",L"ASMain",L"as_6_5");
-    auto msBlob = CompileHLSL(dxc,dxcUtils,L"shaders/ms.hlsl",L"MSMain",L"ms_6_5");
-    auto psBlob = CompileHLSL(dxc,dxcUtils,L"shaders/ps.hlsl",L"PSMain",L"ps_6_6");
+
+    // Shaders: content-addressed cache next to the exe (tools/shaderc can prefill it); misses compile in parallel
+    auto shaderStart = std::chrono::high_resolution_clock::now();
+    ShaderCache shaderCache("shader_cache", DxcCompilerId(DxcCreateInstance),
+                            [DxcCreateInstance](const ShaderDesc& d){ return CompileWithDxc(DxcCreateInstance, d); });
+    std::vector<ShaderBinary> shaders;
+    { ThreadPool shaderPool; shaders = shaderCache.GetAll(shaderPool, { DemoAmplificationShader("shaders", kPaletteFormat),
+                                                                         DemoMeshShader("shaders", kPackedVertices, packed.joints == JointFormat::U16, kPaletteFormat),
+                                                                         DemoShader("shaders","ps.hlsl","PSMain","ps_6_6") }); }
+    for (const ShaderBinary& b : shaders) shaderCache.ExportPdb(b);
+    { const ShaderCacheStats st = shaderCache.Stats(); char msg[160];
+      snprintf(msg, sizeof(msg), "Shaders: %zu hits, %zu misses, %.1f ms\n", st.hits, st.misses,
+               std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - shaderStart).count());
+      OutputDebugStringA(msg); }
+    const ShaderBinary& asBin = shaders[0]; const ShaderBinary& msBin = shaders[1]; const ShaderBinary& psBin = shaders[2];
 
     // PSO via pipeline state stream
     D3D12_RT_FORMAT_ARRAY rtvFormats{}; rtvFormats.NumRenderTargets=1; rtvFormats.RTFormats[0]=DXGI_FORMAT_R8G8B8A8_UNORM;
     struct { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type; ID3D12RootSignature* p; } sRoot{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_ROOT_SIGNATURE, rootSig.Get() };
-    struct { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type; D3D12_SHADER_BYTECODE BC; } sAS{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_AS, { asBlob->GetBufferPointer(), asBlob->GetBufferSize() } };
-    struct { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type; D3D12_SHADER_BYTECODE BC; } sMS{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_MS, { msBlob->GetBufferPointer(), msBlob->GetBufferSize() } };
-    struct { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type; D3D12_SHADER_BYTECODE BC; } sPS{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS, { psBlob->GetBufferPointer(), psBlob->GetBufferSize() } };
-    D3D12_RASTERIZER_DESC rast{ D3D12_FILL_MODE_SOLID, D3D12_CULL_MODE_BACK, FALSE, 0, 0.0f, 0.0f, TRUE, FALSE, FALSE, 0, D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF };
+    struct { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type; D3D12_SHADER_BYTECODE BC; } sAS{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_AS, { asBin.object.data(), asBin.object.size() } };
+    struct { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type; D3D12_SHADER_BYTECODE BC; } sMS{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_MS, { msBin.object.data(), msBin.object.size() } };
+    struct { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type; D3D12_SHADER_BYTECODE BC; } sPS{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS, { psBin.object.data(), psBin.object.size() } };
+    D3D12_RASTERIZER_DESC rast{ D3D12_FILL_MODE_SOLID, D3D12_CULL_MODE_BACK, TRUE, 0, 0.0f, 0.0f, TRUE, FALSE, FALSE, 0, D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF };
     struct { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type; D3D12_RASTERIZER_DESC Desc; } sRast{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RASTERIZER, rast };
     D3D12_BLEND_DESC blend{ FALSE, FALSE, { { FALSE, FALSE, D3D12_BLEND_ONE, D3D12_BLEND_ZERO, D3D12_BLEND_OP_ADD,
                                             D3D12_BLEND_ONE, D3D12_BLEND_ZERO, D3D12_BLEND_OP_ADD,
@@ -131,17 +186,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ LPWSTR,
     ComPtr<ID3D12PipelineState> pso; if (FAILED(device->CreatePipelineState(&pssDesc, IID_PPV_ARGS(&pso))))
     { MessageBox(hwnd,"Failed to create PSO.","PSO error",MB_OK); return 0; }
 
-    // Buffers: quad meshlet (4 verts, 2 tris), 2 bones
-    VertexIn verts[4] = {
-        {{-0.5f,  0.5f, 0.0f},{0,0,1},{0,0,0,0},{1,0,0,0}},
-        {{ 0.5f,  0.5f, 0.0f},{0,0,1},{0,0,0,0},{1,0,0,0}},
-        {{-0.5f, -0.5f, 0.0f},{0,0,1},{1,0,0,0},{1,0,0,0}},
-        {{ 0.5f, -0.5f, 0.0f},{0,0,1},{1,0,0,0},{1,0,0,0}},
-    };
-    struct UINT3 { unsigned int x,y,z; };
-    UINT3 triangles[2] = { {0,2,1}, {1,2,3} };
-    MeshletData meshlet{4,2,0,0,0};
-
+    // Buffers
     auto CreateUpload = [&](size_t size, ComPtr<ID3D12Resource>& res){
         D3D12_RESOURCE_DESC desc{}; desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER; desc.Width = size; desc.Height = 1;
         desc.DepthOrArraySize = 1; desc.MipLevels = 1; desc.Format = DXGI_FORMAT_UNKNOWN; desc.SampleDesc={1,0};
@@ -150,13 +195,82 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ LPWSTR,
         device->CreateCommittedResource(&hp, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&res));
     };
 
-    ComPtr<ID3D12Resource> vb, ib, mb, bones, cb;
-    CreateUpload(sizeof(verts), vb); CreateUpload(sizeof(triangles), ib); CreateUpload(sizeof(meshlet), mb);
-    CreateUpload(sizeof(float)*16*2, bones); CreateUpload(sizeof(GlobalsCB), cb);
+    auto UploadVector = [&](const auto& v, ComPtr<ID3D12Resource>& res){
+        const size_t size = v.size()*sizeof(v[0]); CreateUpload(size, res);
+        void* p; res->Map(0,nullptr,&p); memcpy(p, v.data(), size); res->Unmap(0,nullptr);
+    };
+
+    ComPtr<ID3D12Resource> vb, ib, mb, rb, qb, instb, boundsb, ringBuf;
+    if (kPackedVertices) { UploadVector(packed.words, vb); UploadVector(packed.quant, qb); }
+    else UploadVector(mesh.vertices, vb);
+    UploadVector(mesh.triangles, ib); UploadVector(mesh.meshlets, mb); UploadVector(mesh.boneRemap, rb);
+    UploadVector(instances, instb); UploadVector(meshletBounds, boundsb);
+
+    // Per-frame constants and bone palettes: one persistently mapped upload ring, recycled as
+    // frame fences retire. Upload heaps may stay mapped for the lifetime of the resource.
+    CreateUpload(kUploadRingSize, ringBuf);
+    void* ringCPU; ringBuf->Map(0,nullptr,&ringCPU);
+    RingAllocator ring(ringCPU, kUploadRingSize);
+    UINT64 uploadBytes = 0; // reported per frame
+    auto UploadFrameData = [&](const void* data, size_t size) -> D3D12_GPU_VIRTUAL_ADDRESS {
+        uploadBytes += size;
+        RingAllocator::Allocation a = ring.Allocate(size);
+        if (!a) { WaitFence(fenceValue); ring.Reclaim(fence->GetCompletedValue()); a = ring.Allocate(size); } // ring lapped the GPU
+        if (!a) throw std::runtime_error("Upload ring too small for one frame");
+        memcpy(a.cpu, data, size);
+        return ringBuf->GetGPUVirtualAddress() + a.offset;
+    };
+
+    std::vector<float> bonesCPU(instances.size() * kBonesPerInstance * 16);
+    std::vector<float> paletteCPU(instances.size() * kBonesPerInstance * PaletteFloats(kPaletteFormat));
+
+    // GPU timestamps: kGpuTimestampsPerFrame per frame context, resolved into a readback buffer and
+    // read once that frame's fence has passed. GPU ticks map to ProfileNow() through the queue's
+    // clock calibration (MSVC's steady_clock is QPC-based).
+    auto CreateReadback = [&](UINT64 size, ComPtr<ID3D12Resource>& out) {
+        D3D12_RESOURCE_DESC desc{}; desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER; desc.Width = size; desc.Height = 1;
+        desc.DepthOrArraySize = 1; desc.MipLevels = 1; desc.Format = DXGI_FORMAT_UNKNOWN; desc.SampleDesc={1,0}; desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        D3D12_HEAP_PROPERTIES hp{}; hp.Type = D3D12_HEAP_TYPE_READBACK; hp.CreationNodeMask = 1; hp.VisibleNodeMask = 1;
+        device->CreateCommittedResource(&hp, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&out));
+    };
+    ComPtr<ID3D12QueryHeap> timestampHeap; ComPtr<ID3D12Resource> timestampReadback;
+    { D3D12_QUERY_HEAP_DESC qh{ D3D12_QUERY_HEAP_TYPE_TIMESTAMP, kGpuTimestampsPerFrame * kFramesInFlight, 0 };
+      device->CreateQueryHeap(&qh, IID_PPV_ARGS(&timestampHeap));
+      CreateReadback(8 * kGpuTimestampsPerFrame * kFramesInFlight, timestampReadback); }
+    // Mesh pipeline statistics around DispatchMesh, one query per frame context, where the driver
+    // supports them: MSInvocations / kMeshletGroupSize is the number of meshlets that survived
+    // amplification culling (one 64-thread MS group per meshlet).
+    ComPtr<ID3D12QueryHeap> statsHeap; ComPtr<ID3D12Resource> statsReadback;
+    { D3D12_FEATURE_DATA_D3D12_OPTIONS9 opts9{};
+      if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS9, &opts9, sizeof(opts9))) && opts9.MeshShaderPipelineStatsSupported) {
+          D3D12_QUERY_HEAP_DESC qh{ D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS1, kFramesInFlight, 0 };
+          if (SUCCEEDED(device->CreateQueryHeap(&qh, IID_PPV_ARGS(&statsHeap))))
+              CreateReadback(sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS1) * kFramesInFlight, statsReadback);
+      } }
+    UINT64 gpuFreq = 1, gpuCalib = 0, cpuCalib = 0; LARGE_INTEGER qpcFreq; QueryPerformanceFrequency(&qpcFreq);
+    queue->GetTimestampFrequency(&gpuFreq); queue->GetClockCalibration(&gpuCalib, &cpuCalib);
+    auto GpuToProfileNs = [&](UINT64 gpuTicks) {
+        const double qpc = double(cpuCalib) + (double(gpuTicks) - double(gpuCalib)) * double(qpcFreq.QuadPart) / double(gpuFreq);
+        return uint64_t(qpc * 1e9 / double(qpcFreq.QuadPart));
+    };
+    auto ReadGpuTimestamps = [&](UINT slot){
+        const SIZE_T begin = SIZE_T(slot) * kGpuTimestampsPerFrame * 8; D3D12_RANGE read{ begin, begin + kGpuTimestampsPerFrame * 8 }, written{ 0, 0 };
+        void* p; if (FAILED(timestampReadback->Map(0, &read, &p))) return;
+        UINT64 ts[kGpuTimestampsPerFrame]; memcpy(ts, static_cast<uint8_t*>(p) + begin, sizeof(ts)); timestampReadback->Unmap(0, &written);
+        ProfileGpuZone("Clear", GpuToProfileNs(ts[0]), GpuToProfileNs(ts[1]));
+        ProfileGpuZone("DispatchMesh", GpuToProfileNs(ts[2]), GpuToProfileNs(ts[3]));
+    };
+    auto ReadMeshStatistics = [&](UINT slot){ // reported when read, kFramesInFlight frames late
+        const SIZE_T size = sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS1), begin = SIZE_T(slot) * size;
+        D3D12_RANGE read{ begin, begin + size }, written{ 0, 0 };
+        void* p; if (FAILED(statsReadback->Map(0, &read, &p))) return;
+        D3D12_QUERY_DATA_PIPELINE_STATISTICS1 stats; memcpy(&stats, static_cast<uint8_t*>(p) + begin, size); statsReadback->Unmap(0, &written);
+        ProfileCounter("Meshlets dispatched", double(stats.MSInvocations / kMeshletGroupSize));
+    };
 
-    void* p; vb->Map(0,nullptr,&p); memcpy(p, verts, sizeof(verts)); vb->Unmap(0,nullptr);
-    ib->Map(0,nullptr,&p); memcpy(p, triangles, sizeof(triangles)); ib->Unmap(0,nullptr);
-    mb->Map(0,nullptr,&p); memcpy(p, &meshlet, sizeof(meshlet)); mb->Unmap(0,nullptr);
+    ProfileSetThreadName("Render");
+    std::vector<ProfileEvent> trace;
+    UINT frameCount = 0;
 
     // Main loop
     auto start = std::chrono::high_resolution_clock::now();
@@ -166,21 +280,43 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ LPWSTR,
         MSG msg{}; while (PeekMessage(&msg,nullptr,0,0,PM_REMOVE)){ if (msg.message==WM_QUIT) running=false; TranslateMessage(&msg); DispatchMessage(&msg); }
         if (!running) break;
 
+        ProfileZone frameZone("Frame");
+        if (++frameCount % 600 == 0) queue->GetClockCalibration(&gpuCalib, &cpuCalib); // GPU and CPU clocks drift apart
+
+        // Reuse this back buffer's frame context; only blocks if the GPU is kFramesInFlight frames behind
+        FrameContext& frame = frames[frameIndex];
+        WaitFence(frame.fenceValue);
+        ring.Reclaim(fence->GetCompletedValue());
+        if (frame.fenceValue) ReadGpuTimestamps(frameIndex); // this context's previous frame is done
+        if (frame.fenceValue && statsHeap) ReadMeshStatistics(frameIndex);
+        const UINT tsBase = frameIndex * kGpuTimestampsPerFrame;
+
         // Update bones
+        D3D12_GPU_VIRTUAL_ADDRESS bonesVA = 0, cbVA = 0; GlobalsCB g{};
+        { GRFX_PROFILE_ZONE("Update bones");
         auto now = std::chrono::high_resolution_clock::now();
         float t = std::chrono::duration<float>(now - start).count();
-        float angle = 0.5f * sinf(t*1.5f);
+        for (size_t i = 0; i < instances.size(); ++i) {
+            float* b0 = &bonesCPU[i * kBonesPerInstance * 16]; float* b1 = b0 + 16;
+            float angle = 0.5f * sinf(t*1.5f + 0.37f * float(i)); // phase-shifted per instance
+            float c = cosf(angle), s = sinf(angle); MakeIdentity(b0); MakeIdentity(b1);
+            b1[5]=c; b1[6]=s; b1[9]=-s; b1[10]=c; b1[13]=-0.25f; // rotate around X, translate downward
+        }
+        EncodePalette(kPaletteFormat, bonesCPU.data(), bonesCPU.size() / 16, paletteCPU.data());
+        bonesVA = UploadFrameData(paletteCPU.data(), paletteCPU.size() * sizeof(float));
 
-        float bonesCPU[32]; MakeIdentity(&bonesCPU[0]);
-        float c = cosf(angle), s = sinf(angle); float b1[16]; MakeIdentity(b1);
-        b1[5]=c; b1[6]=s; b1[9]=-s; b1[10]=c; b1[13]=-0.25f; // rotate around X, translate downward
-        memcpy(&bonesCPU[16], b1, sizeof(b1));
-        bones->Map(0,nullptr,&p); memcpy(p, bonesCPU, sizeof(bonesCPU)); bones->Unmap(0,nullptr);
+        // orbiting camera; frustum planes and eye position feed ASMain's culling
+        const float eye[3] = { 30.0f * sinf(t*0.2f), 4.0f, 30.0f * cosf(t*0.2f) - 0.5f * kCrowdSide * kCrowdSpacing };
+        const float at[3] = { 0.0f, 0.0f, -0.5f * kCrowdSide * kCrowdSpacing };
+        float view[16], proj[16]; MakeLookAt(view, eye, at); MakePerspective(proj, 0.9f, float(kWidth) / kHeight, 0.1f, 500.0f);
+        Mat4Mul(proj, view, g.viewProj); ExtractFrustumPlanes(g.viewProj, g.frustum);
+        memcpy(g.cameraPos, eye, sizeof(eye)); g.time = t;
+        g.meshletCount = (UINT)mesh.meshlets.size(); g.instanceCount = (UINT)instances.size(); g.cullFlags = kCullFrustum | kCullCones;
+        cbVA = UploadFrameData(&g, sizeof(g));
+        } // Update bones
 
-        GlobalsCB g{}; MakeOrtho(g.mvp, (float)kWidth, (float)kHeight); g.time = t;
-        cb->Map(0,nullptr,&p); memcpy(p, &g, sizeof(g)); cb->Unmap(0,nullptr);
-
-        alloc->Reset(); list->Reset(alloc.Get(), pso.Get());
+        const uint64_t recordBegin = ProfilerEnabled() ? ProfileNow() : 0;
+        frame.alloc->Reset(); list->Reset(frame.alloc.Get(), pso.Get());
 
         // Transition to RT
         D3D12_RESOURCE_BARRIER toRT{}; toRT.Type=D3D12_RESOURCE_BARRIER_TYPE_TRANSITION; toRT.Transition.pResource=backbuf[frameIndex].Get();
@@ -188,28 +324,57 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ LPWSTR,
         toRT.Transition.StateAfter=D3D12_RESOURCE_STATE_RENDER_TARGET; list->ResourceBarrier(1,&toRT);
 
         D3D12_CPU_DESCRIPTOR_HANDLE rtv = rtvHeap->GetCPUDescriptorHandleForHeapStart(); rtv.ptr += SIZE_T(frameIndex)*SIZE_T(rtvInc);
-        FLOAT clear[4] = {0.1f,0.1f,0.12f,1.0f}; list->ClearRenderTargetView(rtv, clear, 0, nullptr);
+        FLOAT clear[4] = {0.1f,0.1f,0.12f,1.0f};
+        list->EndQuery(timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, tsBase + 0);
+        list->ClearRenderTargetView(rtv, clear, 0, nullptr);
+        list->EndQuery(timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, tsBase + 1);
         list->OMSetRenderTargets(1, &rtv, FALSE, nullptr);
 
         list->SetGraphicsRootSignature(rootSig.Get());
-        list->SetGraphicsRootConstantBufferView(0, cb->GetGPUVirtualAddress());
+        list->SetGraphicsRootConstantBufferView(0, cbVA);
         list->SetGraphicsRootShaderResourceView(1, vb->GetGPUVirtualAddress());
         list->SetGraphicsRootShaderResourceView(2, ib->GetGPUVirtualAddress());
         list->SetGraphicsRootShaderResourceView(3, mb->GetGPUVirtualAddress());
-        list->SetGraphicsRootShaderResourceView(4, bones->GetGPUVirtualAddress());
+        list->SetGraphicsRootShaderResourceView(4, bonesVA);
+        list->SetGraphicsRootShaderResourceView(5, rb->GetGPUVirtualAddress());
+        list->SetGraphicsRootShaderResourceView(6, (kPackedVertices ? qb : rb)->GetGPUVirtualAddress());
+        list->SetGraphicsRootShaderResourceView(7, instb->GetGPUVirtualAddress());
+        list->SetGraphicsRootShaderResourceView(8, boundsb->GetGPUVirtualAddress());
 
         D3D12_VIEWPORT vp{0,0,(float)kWidth,(float)kHeight,0,1}; D3D12_RECT sc{0,0,(LONG)kWidth,(LONG)kHeight};
         list->RSSetViewports(1,&vp); list->RSSetScissorRects(1,&sc);
 
-        list->DispatchMesh(1,1,1);
+        // one amplification thread per (instance, meshlet) pair
+        const UINT pairs = g.instanceCount * g.meshletCount;
+        list->EndQuery(timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, tsBase + 2);
+        if (statsHeap) list->BeginQuery(statsHeap.Get(), D3D12_QUERY_TYPE_PIPELINE_STATISTICS1, frameIndex);
+        list->DispatchMesh((pairs + kAmplificationGroupSize - 1) / kAmplificationGroupSize, 1, 1);
+        if (statsHeap) list->EndQuery(statsHeap.Get(), D3D12_QUERY_TYPE_PIPELINE_STATISTICS1, frameIndex);
+        list->EndQuery(timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, tsBase + 3);
+        list->ResolveQueryData(timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, tsBase, kGpuTimestampsPerFrame, timestampReadback.Get(), UINT64(tsBase) * 8);
+        if (statsHeap) list->ResolveQueryData(statsHeap.Get(), D3D12_QUERY_TYPE_PIPELINE_STATISTICS1, frameIndex, 1, statsReadback.Get(),
+                                              UINT64(frameIndex) * sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS1));
 
         D3D12_RESOURCE_BARRIER toPresent{}; toPresent.Type=D3D12_RESOURCE_BARRIER_TYPE_TRANSITION; toPresent.Transition.pResource=backbuf[frameIndex].Get();
         toPresent.Transition.Subresource=D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES; toPresent.Transition.StateBefore=D3D12_RESOURCE_STATE_RENDER_TARGET;
         toPresent.Transition.StateAfter=D3D12_RESOURCE_STATE_PRESENT; list->ResourceBarrier(1,&toPresent);
 
-        list->Close(); ID3D12CommandList* lists[] = { list.Get() }; queue->ExecuteCommandLists(1, lists);
-        swap->Present(1,0); WaitGPU(); frameIndex = swap->GetCurrentBackBufferIndex();
+        list->Close(); if (recordBegin) ProfileZoneEnd("Record", recordBegin);
+        { GRFX_PROFILE_ZONE("Submit"); ID3D12CommandList* lists[] = { list.Get() }; queue->ExecuteCommandLists(1, lists); }
+        frame.fenceValue = ++fenceValue; queue->Signal(fence.Get(), frame.fenceValue); ring.FinishFrame(frame.fenceValue);
+        { GRFX_PROFILE_ZONE("Present"); swap->Present(1,0); } frameIndex = swap->GetCurrentBackBufferIndex();
+
+        ProfileCounter("AS threads (instance x meshlet, before culling)", double(pairs));
+        ProfileCounter("Upload bytes", double(uploadBytes));
+        ProfileCounter("Fence stall ms", double(fenceStallNs) * 1e-6);
+        uploadBytes = 0; fenceStallNs = 0;
+        ProfilerCollect(trace);
+        if (trace.size() > kMaxTraceEvents) trace.erase(trace.begin(), trace.begin() + trace.size() / 2);
     }
 
-    WaitGPU(); CloseHandle(fenceEvent); return 0;
+    WaitGPU();
+    for (UINT i = 0; i < kFramesInFlight; ++i) if (frames[i].fenceValue) ReadGpuTimestamps(i);
+    ProfilerCollect(trace);
+    try { WriteChromeTrace("frame_trace.json", trace); } catch (const std::exception& e) { OutputDebugStringA(e.what()); }
+    ringBuf->Unmap(0,nullptr); CloseHandle(fenceEvent); return 0;
 }
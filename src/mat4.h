@@ -0,0 +1,60 @@
+#pragma once
+// Column-major 4x4 helpers (glTF / gBones layout: translation in m[12..14], p' = M * p).
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRFX_MAT4_SSE 1
+#include <xmmintrin.h>
+#endif
+
+inline void Mat4Identity(float m[16]) { memset(m, 0, 16 * sizeof(float)); m[0] = m[5] = m[10] = m[15] = 1.0f; }
+
+// out = a * b; out must not alias a or b.
+inline void Mat4Mul(const float* a, const float* b, float* out) {
+#if GRFX_MAT4_SSE
+    const __m128 a0 = _mm_loadu_ps(a), a1 = _mm_loadu_ps(a + 4), a2 = _mm_loadu_ps(a + 8), a3 = _mm_loadu_ps(a + 12);
+    for (int j = 0; j < 4; ++j) {
+        const float* bj = b + j * 4;
+        __m128 c = _mm_mul_ps(a0, _mm_set1_ps(bj[0]));
+        c = _mm_add_ps(c, _mm_mul_ps(a1, _mm_set1_ps(bj[1])));
+        c = _mm_add_ps(c, _mm_mul_ps(a2, _mm_set1_ps(bj[2])));
+        c = _mm_add_ps(c, _mm_mul_ps(a3, _mm_set1_ps(bj[3])));
+        _mm_storeu_ps(out + j * 4, c);
+    }
+#else
+    for (int j = 0; j < 4; ++j)
+        for (int i = 0; i < 4; ++i)
+            out[j*4 + i] = a[i] * b[j*4] + a[4 + i] * b[j*4 + 1] + a[8 + i] * b[j*4 + 2] + a[12 + i] * b[j*4 + 3];
+#endif
+}
+
+// Translation, unit quaternion (x, y, z, w) and scale, composed as T * R * S.
+inline void ComposeTRS(const float t[3], const float q[4], const float s[3], float m[16]) {
+    const float x = q[0], y = q[1], z = q[2], w = q[3];
+    m[0] = (1 - 2*(y*y + z*z)) * s[0]; m[1] = 2*(x*y + w*z) * s[0];       m[2]  = 2*(x*z - w*y) * s[0];       m[3]  = 0;
+    m[4] = 2*(x*y - w*z) * s[1];       m[5] = (1 - 2*(x*x + z*z)) * s[1]; m[6]  = 2*(y*z + w*x) * s[1];       m[7]  = 0;
+    m[8] = 2*(x*z + w*y) * s[2];       m[9] = 2*(y*z - w*x) * s[2];       m[10] = (1 - 2*(x*x + y*y)) * s[2]; m[11] = 0;
+    m[12] = t[0]; m[13] = t[1]; m[14] = t[2]; m[15] = 1;
+}
+
+// Quaternion (x, y, z, w) of the rotation held in the upper 3x3 of a column-major matrix whose
+// columns have already been normalized.
+inline void Mat3ToQuat(const float* m, float q[4]) {
+    const float r00 = m[0], r10 = m[1], r20 = m[2], r01 = m[4], r11 = m[5], r21 = m[6], r02 = m[8], r12 = m[9], r22 = m[10];
+    const float trace = r00 + r11 + r22;
+    if (trace > 0) {
+        const float s = std::sqrt(trace + 1.0f) * 2;
+        q[3] = 0.25f * s; q[0] = (r21 - r12) / s; q[1] = (r02 - r20) / s; q[2] = (r10 - r01) / s;
+    } else if (r00 > r11 && r00 > r22) {
+        const float s = std::sqrt(1.0f + r00 - r11 - r22) * 2;
+        q[3] = (r21 - r12) / s; q[0] = 0.25f * s; q[1] = (r01 + r10) / s; q[2] = (r02 + r20) / s;
+    } else if (r11 > r22) {
+        const float s = std::sqrt(1.0f + r11 - r00 - r22) * 2;
+        q[3] = (r02 - r20) / s; q[0] = (r01 + r10) / s; q[1] = 0.25f * s; q[2] = (r12 + r21) / s;
+    } else {
+        const float s = std::sqrt(1.0f + r22 - r00 - r11) * 2;
+        q[3] = (r10 - r01) / s; q[0] = (r02 + r20) / s; q[1] = (r12 + r21) / s; q[2] = 0.25f * s;
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+// CPU mirrors of the structured buffers declared in shaders/common.hlsli. Keep the layouts in sync.
+
+#include <cstdint>
+
+struct VertexIn { float pos[3]; float nrm[3]; uint32_t boneIdx[4]; float boneWgt[4]; };
+struct MeshletData { uint32_t vCount, pCount; uint32_t vOffset, pOffset; uint32_t boneBase; };
+
+// Packed vertex mode (PACKED_VERTICES, see vertex_pack.h): per-meshlet position dequantization,
+// pos = boundsMin + q * boundsScale for 16-bit q.
+struct MeshletQuant { float boundsMin[3]; float boundsScale[3]; };
+
+// Crowd mode (see crowd.h). Bounds are in bind-pose mesh space.
+struct MeshletBounds {
+    float center[3]; float radius;
+    float coneAxis[3]; float coneCutoff; // cutoff >= 1: cone test disabled
+    float coneApex[3]; uint32_t dominantBone; // meshlet-local bone the bounds follow
+};
+struct InstanceData {
+    float world[16];
+    uint32_t paletteOffset;  // first gBones entry of this instance's palette
+    float boundsPadding;     // radius slack for deformation not captured by the dominant bone
+    uint32_t pad[2];
+};
@@ -0,0 +1,191 @@
+#include "meshlet.h"
+#include "tinygltf.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+static constexpr uint32_t kNone = ~0u;
+
+// Vertex -> triangle incidence in CSR form.
+struct TriangleAdjacency {
+    std::vector<uint32_t> offsets; // vertexCount + 1
+    std::vector<uint32_t> tris;
+};
+
+static TriangleAdjacency BuildAdjacency(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    TriangleAdjacency a; a.offsets.assign(vertexCount + 1, 0); a.tris.resize(indices.size());
+    for (uint32_t v : indices) a.offsets[v + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v) a.offsets[v + 1] += a.offsets[v];
+    std::vector<uint32_t> fill(a.offsets.begin(), a.offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); ++i) a.tris[fill[indices[i]]++] = uint32_t(i / 3);
+    return a;
+}
+
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+    const size_t triCount = indices.size() / 3;
+    if (triCount == 0) return;
+    for (uint32_t v : indices) if (v >= vertexCount) throw std::runtime_error("Vertex index out of range");
+    const TriangleAdjacency adj = BuildAdjacency(indices, vertexCount);
+
+    std::vector<uint32_t> live(vertexCount), cacheTime(vertexCount, 0);
+    for (size_t v = 0; v < vertexCount; ++v) live[v] = adj.offsets[v + 1] - adj.offsets[v];
+    std::vector<uint8_t> emitted(triCount, 0);
+    std::vector<uint32_t> deadEnd, candidates, out;
+    deadEnd.reserve(indices.size()); out.reserve(triCount * 3);
+    uint32_t time = cacheSize + 1; // cacheTime 0 => "not in cache"
+    size_t cursor = 0;
+
+    auto nextLive = [&]() -> int64_t {
+        while (!deadEnd.empty()) { uint32_t d = deadEnd.back(); deadEnd.pop_back(); if (live[d]) return d; }
+        for (; cursor < vertexCount; ++cursor) if (live[cursor]) return int64_t(cursor);
+        return -1;
+    };
+
+    for (int64_t fan = nextLive(); fan >= 0;) {
+        // emit every remaining triangle around the fanning vertex
+        candidates.clear();
+        for (uint32_t k = adj.offsets[fan]; k < adj.offsets[fan + 1]; ++k) {
+            const uint32_t t = adj.tris[k];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+            for (int c = 0; c < 3; ++c) {
+                const uint32_t v = indices[t*3 + c];
+                out.push_back(v); deadEnd.push_back(v); candidates.push_back(v); live[v]--;
+                if (time - cacheTime[v] > cacheSize) cacheTime[v] = time++;
+            }
+        }
+        // next fan: the oldest candidate that stays in cache after its remaining fan is emitted
+        fan = -1; int64_t best = -1;
+        for (uint32_t v : candidates) {
+            if (!live[v]) continue;
+            const int64_t age = int64_t(time - cacheTime[v]);
+            const int64_t p = age + 2 * int64_t(live[v]) <= int64_t(cacheSize) ? age : 0;
+            if (p > best) { best = p; fan = v; }
+        }
+        if (fan < 0) fan = nextLive();
+    }
+    indices.swap(out);
+}
+
+MeshletMesh BuildMeshlets(const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices,
+                          const MeshletLimits& requested) {
+    MeshletLimits limits = requested;
+    limits.maxVertices   = std::clamp(limits.maxVertices, 3u, kMaxMeshletVertices);
+    limits.maxPrimitives = std::clamp(limits.maxPrimitives, 1u, kMaxMeshletPrimitives);
+    limits.maxBones      = std::clamp(limits.maxBones, 4u, kMaxMeshletBones);
+
+    std::vector<uint32_t> order(indices.begin(), indices.end() - indices.size() % 3);
+    OptimizeVertexCache(order, vertices.size());
+    const size_t triCount = order.size() / 3;
+    const TriangleAdjacency adj = BuildAdjacency(order, vertices.size());
+
+    uint32_t boneCount = 0;
+    for (const VertexIn& v : vertices)
+        for (int k = 0; k < 4; ++k) if (v.boneWgt[k] > 0.0f) boneCount = std::max(boneCount, v.boneIdx[k] + 1);
+
+    MeshletMesh out;
+    out.triangles.reserve(triCount);
+    out.sourceVertex.reserve(vertices.size());
+    out.meshlets.reserve(triCount / limits.maxPrimitives + 1);
+    std::vector<uint32_t> localVertex(vertices.size(), kNone), localBone(boneCount, kNone);
+    std::vector<uint32_t> meshletVerts, meshletBones, candidates;
+    std::vector<uint8_t> emitted(triCount, 0);
+    size_t triStart = 0, cursor = 0;
+
+    // Vertices (return) and bones (newBones) triangle t would add to the open meshlet.
+    auto cost = [&](uint32_t t, uint32_t& newBones) {
+        uint32_t newVerts = 0, seen[12]; newBones = 0;
+        const uint32_t* tri = &order[t*3];
+        for (int c = 0; c < 3; ++c) {
+            const uint32_t v = tri[c];
+            if (localVertex[v] != kNone || (c > 0 && tri[0] == v) || (c > 1 && tri[1] == v)) continue;
+            newVerts++;
+            for (int k = 0; k < 4; ++k) {
+                if (!(vertices[v].boneWgt[k] > 0.0f)) continue;
+                const uint32_t b = vertices[v].boneIdx[k];
+                if (localBone[b] == kNone && std::find(seen, seen + newBones, b) == seen + newBones) seen[newBones++] = b;
+            }
+        }
+        return newVerts;
+    };
+    auto fits = [&](uint32_t newVerts, uint32_t newBones) {
+        return meshletVerts.size() + newVerts <= limits.maxVertices && meshletBones.size() + newBones <= limits.maxBones;
+    };
+    auto emit = [&](uint32_t t) {
+        emitted[t] = 1;
+        uint32_t local[3];
+        for (int c = 0; c < 3; ++c) {
+            const uint32_t v = order[t*3 + c];
+            if (localVertex[v] == kNone) {
+                localVertex[v] = uint32_t(meshletVerts.size()); meshletVerts.push_back(v);
+                for (int k = 0; k < 4; ++k) {
+                    const uint32_t b = vertices[v].boneIdx[k];
+                    if (vertices[v].boneWgt[k] > 0.0f && localBone[b] == kNone) { localBone[b] = uint32_t(meshletBones.size()); meshletBones.push_back(b); }
+                }
+                for (uint32_t k = adj.offsets[v]; k < adj.offsets[v + 1]; ++k)
+                    if (!emitted[adj.tris[k]]) candidates.push_back(adj.tris[k]);
+            }
+            local[c] = localVertex[v];
+        }
+        out.triangles.push_back({ local[0], local[1], local[2] });
+    };
+    auto flush = [&]() {
+        if (out.triangles.size() == triStart) return;
+        out.meshlets.push_back({ uint32_t(meshletVerts.size()), uint32_t(out.triangles.size() - triStart),
+                                 uint32_t(out.vertices.size()), uint32_t(triStart), uint32_t(out.boneRemap.size()) });
+        // bone compaction: vertices index the meshlet's slice of boneRemap
+        for (uint32_t v : meshletVerts) {
+            VertexIn vin = vertices[v];
+            for (int k = 0; k < 4; ++k) vin.boneIdx[k] = vin.boneWgt[k] > 0.0f ? localBone[vin.boneIdx[k]] : 0;
+            out.vertices.push_back(vin); out.sourceVertex.push_back(v); localVertex[v] = kNone;
+        }
+        for (uint32_t b : meshletBones) { out.boneRemap.push_back(b); localBone[b] = kNone; }
+        if (meshletBones.empty()) out.boneRemap.push_back(0); // unweighted meshlet: dominantBone 0 must stay in its slice
+        meshletVerts.clear(); meshletBones.clear(); candidates.clear();
+        triStart = out.triangles.size();
+    };
+
+    for (;;) {
+        // adjacency-aware greedy pick: fewest new vertices, then fewest new bones, then cache order
+        uint32_t best = kNone, bestVerts = 4, bestBones = 0;
+        for (size_t i = 0; i < candidates.size();) {
+            const uint32_t t = candidates[i];
+            if (emitted[t]) { candidates[i] = candidates.back(); candidates.pop_back(); continue; }
+            uint32_t nb; const uint32_t nv = cost(t, nb);
+            if (fits(nv, nb) && (nv < bestVerts || (nv == bestVerts && (nb < bestBones || (nb == bestBones && t < best)))))
+            { best = t; bestVerts = nv; bestBones = nb; if (nv == 0 && nb == 0) break; }
+            ++i;
+        }
+        if (best == kNone) {
+            // no connected triangle fits: continue with the next one in cache order
+            while (cursor < triCount && emitted[cursor]) ++cursor;
+            if (cursor == triCount) break;
+            uint32_t nb; const uint32_t nv = cost(uint32_t(cursor), nb);
+            if (!meshletVerts.empty() && !fits(nv, nb)) { flush(); continue; }
+            best = uint32_t(cursor);
+        }
+        emit(best);
+        if (out.triangles.size() - triStart == limits.maxPrimitives) flush();
+    }
+    flush();
+    return out;
+}
+
+MeshletMesh BuildMeshlets(const tinygltf::Model& model, const tinygltf::Primitive& prim, const MeshletLimits& limits) {
+    std::vector<VertexIn> vertices; std::vector<uint32_t> indices;
+    ReadPrimitiveVertices(model, prim, vertices, indices);
+    return BuildMeshlets(vertices, indices, limits);
+}
+
+MeshletStats ComputeMeshletStats(const MeshletMesh& mesh, const MeshletLimits& limits, size_t sourceVertexCount) {
+    MeshletStats s;
+    s.meshletCount = mesh.meshlets.size(); s.vertexCount = mesh.vertices.size(); s.triangleCount = mesh.triangles.size();
+    if (!s.meshletCount) return s;
+    const double n = double(s.meshletCount);
+    s.avgVertices  = s.vertexCount / n;
+    s.avgTriangles = s.triangleCount / n;
+    s.avgBones     = mesh.boneRemap.size() / n;
+    s.triangleFill = s.avgTriangles / std::clamp(limits.maxPrimitives, 1u, kMaxMeshletPrimitives);
+    s.vertexDuplication = sourceVertexCount ? double(s.vertexCount) / double(sourceVertexCount) : 0.0;
+    return s;
+}
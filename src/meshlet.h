@@ -0,0 +1,51 @@
+#pragma once
+// Meshletizer: turns indexed triangle lists (or glTF primitives) into the
+// VertexIn / uint3 / MeshletData / bone-remap buffers consumed by MSMain.
+
+#include "mesh_types.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace tinygltf { class Model; struct Primitive; }
+
+// Hard limits of MSMain in shaders/ms.hlsl.
+constexpr uint32_t kMeshletGroupSize     = 64;  // [numthreads(64,1,1)]
+constexpr uint32_t kMaxMeshletVertices   = 256; // vOut[256]
+constexpr uint32_t kMaxMeshletPrimitives = 256; // pOut[256]
+// Meshlet-local bone indices must fit the U8 joint stream and ComputeMeshletBounds' weight table.
+constexpr uint32_t kMaxMeshletBones      = 256;
+
+struct MeshletLimits {
+    uint32_t maxVertices   = 64;
+    uint32_t maxPrimitives = 126;
+    uint32_t maxBones      = 64;  // distinct palette entries a single meshlet may reference, <= kMaxMeshletBones
+};
+
+struct MeshletTriangle { uint32_t x, y, z; }; // meshlet-local vertex indices (gTris' uint3)
+
+struct MeshletMesh {
+    std::vector<VertexIn>        vertices;  // per-meshlet copies, boneIdx is meshlet-local
+    std::vector<MeshletTriangle> triangles;
+    std::vector<MeshletData>     meshlets;
+    std::vector<uint32_t>        boneRemap; // palette index = boneRemap[m.boneBase + local], >= 1 entry per meshlet
+    std::vector<uint32_t>        sourceVertex; // input vertex of each entry in `vertices`
+};
+
+struct MeshletStats {
+    size_t meshletCount = 0, vertexCount = 0, triangleCount = 0;
+    double avgVertices = 0, avgTriangles = 0, avgBones = 0;
+    double triangleFill = 0;      // avgTriangles / maxPrimitives
+    double vertexDuplication = 0; // emitted vertices / source vertices
+};
+
+// In-place vertex-reuse reordering of a triangle list (Tipsify, Sander et al. 2007).
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+MeshletMesh BuildMeshlets(const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices,
+                          const MeshletLimits& limits = {});
+MeshletMesh BuildMeshlets(const tinygltf::Model& model, const tinygltf::Primitive& prim,
+                          const MeshletLimits& limits = {});
+
+MeshletStats ComputeMeshletStats(const MeshletMesh& mesh, const MeshletLimits& limits, size_t sourceVertexCount);
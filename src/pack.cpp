@@ -0,0 +1,297 @@
+#include "pack.h"
+#include "skeleton.h"
+#include "tinygltf.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t AlignUp(uint64_t v) { return (v + kPackAlignment - 1) & ~uint64_t(kPackAlignment - 1); }
+
+uint32_t PackBuilder::AddString(const std::string& s) {
+    const uint32_t offset = uint32_t(strings_.size());
+    strings_.append(s); strings_.push_back('\0');
+    return offset;
+}
+
+uint32_t PackBuilder::AddMesh(const std::string& name, const MeshletMesh& mesh, int32_t skin) {
+    PackMesh m{};
+    m.meshletOffset = uint32_t(meshlets_.size()); m.meshletCount = uint32_t(mesh.meshlets.size());
+    m.vertexOffset = uint32_t(vertices_.size()); m.vertexCount = uint32_t(mesh.vertices.size());
+    m.triangleOffset = uint32_t(triangles_.size()); m.triangleCount = uint32_t(mesh.triangles.size());
+    m.boneRemapOffset = uint32_t(boneRemap_.size()); m.boneRemapCount = uint32_t(mesh.boneRemap.size());
+    m.skin = skin; m.nameOffset = AddString(name);
+    for (MeshletData md : mesh.meshlets) {
+        md.vOffset += m.vertexOffset; md.pOffset += m.triangleOffset; md.boneBase += m.boneRemapOffset;
+        meshlets_.push_back(md);
+    }
+    vertices_.insert(vertices_.end(), mesh.vertices.begin(), mesh.vertices.end());
+    triangles_.insert(triangles_.end(), mesh.triangles.begin(), mesh.triangles.end());
+    boneRemap_.insert(boneRemap_.end(), mesh.boneRemap.begin(), mesh.boneRemap.end());
+    meshes_.push_back(m);
+    return uint32_t(meshes_.size() - 1);
+}
+
+uint32_t PackBuilder::AddSkin(const std::string& name, const Skin& skin, const SkeletonLayout& layout) {
+    PackSkin ps{ uint32_t(bones_.size()), uint32_t(layout.BoneCount()), skin.skeletonRootNode, AddString(name) };
+    for (size_t s = 0; s < layout.BoneCount(); ++s) {
+        PackBone b{};
+        b.parent = layout.parent[s]; b.paletteIndex = layout.boneOfSlot[s]; b.node = layout.node[s];
+        b.nameOffset = AddString(skin.bones[layout.boneOfSlot[s]].name);
+        memcpy(b.inverseBind, &layout.inverseBind[s * 16], sizeof(b.inverseBind));
+        memcpy(b.restLocal, &layout.restLocal[s * 16], sizeof(b.restLocal));
+        bones_.push_back(b);
+    }
+    skins_.push_back(ps);
+    return uint32_t(skins_.size() - 1);
+}
+
+uint32_t PackBuilder::AddClip(const AnimationClip& clip, uint32_t skin) {
+    clips_.push_back({ uint32_t(tracks_.size()), uint32_t(clip.tracks.size()), skin, clip.boneCount, clip.duration, AddString(clip.name) });
+    for (AnimTrack tr : clip.tracks) {
+        tr.timeOffset += uint32_t(times_.size());
+        tr.valueOffset += uint32_t(tr.encoding == uint8_t(TrackEncoding::Quant16) ? qvalues_.size() : values_.size());
+        tracks_.push_back(tr);
+    }
+    times_.insert(times_.end(), clip.times.begin(), clip.times.end());
+    values_.insert(values_.end(), clip.values.begin(), clip.values.end());
+    qvalues_.insert(qvalues_.end(), clip.qvalues.begin(), clip.qvalues.end());
+    return uint32_t(clips_.size() - 1);
+}
+
+void PackBuilder::Write(const std::string& path) const {
+    struct Blob { uint32_t elementSize; const void* data; size_t count; };
+    const Blob blobs[size_t(PackSection::Count)] = {
+        { sizeof(PackMesh), meshes_.data(), meshes_.size() },
+        { sizeof(VertexIn), vertices_.data(), vertices_.size() },
+        { sizeof(MeshletTriangle), triangles_.data(), triangles_.size() },
+        { sizeof(MeshletData), meshlets_.data(), meshlets_.size() },
+        { sizeof(uint32_t), boneRemap_.data(), boneRemap_.size() },
+        { sizeof(PackSkin), skins_.data(), skins_.size() },
+        { sizeof(PackBone), bones_.data(), bones_.size() },
+        { sizeof(PackClip), clips_.data(), clips_.size() },
+        { sizeof(AnimTrack), tracks_.data(), tracks_.size() },
+        { sizeof(float), times_.data(), times_.size() },
+        { sizeof(float), values_.data(), values_.size() },
+        { sizeof(uint16_t), qvalues_.data(), qvalues_.size() },
+        { 1, strings_.data(), strings_.size() },
+    };
+    PackSectionEntry entries[size_t(PackSection::Count)];
+    uint64_t offset = AlignUp(sizeof(PackHeader) + sizeof(entries));
+    for (uint32_t i = 0; i < uint32_t(PackSection::Count); ++i) {
+        entries[i] = { i, blobs[i].elementSize, offset, blobs[i].count };
+        offset = AlignUp(offset + uint64_t(blobs[i].elementSize) * blobs[i].count);
+    }
+    const PackHeader header{ kPackMagic, kPackVersion, uint32_t(PackSection::Count), 0, offset };
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) throw std::runtime_error("Failed to open pack for writing: " + path);
+    static const uint8_t zeros[kPackAlignment] = {};
+    uint64_t written = 0;
+    auto put = [&](const void* p, size_t n) {
+        if (n && fwrite(p, 1, n, f) != n) { fclose(f); throw std::runtime_error("Failed to write pack: " + path); }
+        written += n;
+    };
+    auto padTo = [&](uint64_t target) { while (written < target) put(zeros, size_t(std::min<uint64_t>(target - written, kPackAlignment))); };
+    put(&header, sizeof(header)); put(entries, sizeof(entries));
+    for (uint32_t i = 0; i < uint32_t(PackSection::Count); ++i) {
+        padTo(entries[i].offset);
+        put(blobs[i].data, size_t(blobs[i].elementSize) * blobs[i].count);
+    }
+    padTo(header.fileSize);
+    if (fclose(f) != 0) throw std::runtime_error("Failed to write pack: " + path);
+}
+
+void PackFile::Open(const std::string& path) {
+    Close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Failed to open pack: " + path);
+    LARGE_INTEGER size{}; GetFileSizeEx(file, &size);
+    HANDLE mapping = size.QuadPart ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) { if (mapping) CloseHandle(mapping); CloseHandle(file); throw std::runtime_error("Failed to map pack: " + path); }
+    file_ = file; mapping_ = mapping; data_ = static_cast<const uint8_t*>(view); size_ = size_t(size.QuadPart);
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Failed to open pack: " + path);
+    struct stat st{};
+    void* view = (fstat(fd, &st) == 0 && st.st_size > 0) ? mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd); // the mapping keeps the file alive
+    if (view == MAP_FAILED) throw std::runtime_error("Failed to map pack: " + path);
+    data_ = static_cast<const uint8_t*>(view); size_ = size_t(st.st_size);
+#endif
+
+    auto fail = [&](const char* why) { Close(); throw std::runtime_error(std::string("Invalid pack ") + path + ": " + why); };
+    if (size_ < sizeof(PackHeader) + sizeof(PackSectionEntry) * size_t(PackSection::Count)) fail("truncated header");
+    const auto* header = reinterpret_cast<const PackHeader*>(data_);
+    if (header->magic != kPackMagic) fail("bad magic");
+    if (header->version != kPackVersion) fail("unsupported version");
+    if (header->sectionCount != uint32_t(PackSection::Count)) fail("unexpected section count");
+    if (header->fileSize != size_) fail("size mismatch");
+    static const uint32_t kElementSize[size_t(PackSection::Count)] = {
+        sizeof(PackMesh), sizeof(VertexIn), sizeof(MeshletTriangle), sizeof(MeshletData), sizeof(uint32_t),
+        sizeof(PackSkin), sizeof(PackBone),
+        sizeof(PackClip), sizeof(AnimTrack), sizeof(float), sizeof(float), sizeof(uint16_t),
+        1,
+    };
+    for (uint32_t i = 0; i < uint32_t(PackSection::Count); ++i) {
+        const PackSectionEntry& e = Entry(PackSection(i));
+        if (e.type != i || e.offset % kPackAlignment) fail("bad section entry");
+        if (e.count && e.elementSize != kElementSize[i]) fail("section element size mismatch");
+        if (e.offset > size_) fail("section out of bounds");
+        if (e.elementSize && e.count > (size_ - e.offset) / e.elementSize) fail("section out of bounds");
+    }
+    if (const char* why = ValidateSkins()) fail(why);
+    if (const char* why = ValidateMeshes()) fail(why);
+    if (const char* why = ValidateClips()) fail(why);
+}
+
+// Every range a mesh or its meshlets address lies inside its section and, for meshlets, inside
+// the mesh; local triangle indices stay below vCount and remapped bones below the skin's count.
+const char* PackFile::ValidateMeshes() const {
+    const auto meshlets = Meshlets(); const auto triangles = Triangles(); const auto remap = BoneRemap();
+    const auto skins = Skins();
+    for (const PackMesh& m : Meshes()) {
+        if (m.skin < -1 || m.skin >= int64_t(skins.size())) return "mesh skin out of range";
+        if (uint64_t(m.vertexOffset) + m.vertexCount > Vertices().size() ||
+            uint64_t(m.triangleOffset) + m.triangleCount > triangles.size() ||
+            uint64_t(m.meshletOffset) + m.meshletCount > meshlets.size() ||
+            uint64_t(m.boneRemapOffset) + m.boneRemapCount > remap.size())
+            return "mesh out of bounds";
+        for (uint32_t i = 0; i < m.meshletCount; ++i) {
+            const MeshletData& md = meshlets[m.meshletOffset + i];
+            if (md.vCount > kMaxMeshletVertices || md.pCount > kMaxMeshletPrimitives ||
+                md.vOffset < m.vertexOffset || uint64_t(md.vOffset) + md.vCount > uint64_t(m.vertexOffset) + m.vertexCount ||
+                md.pOffset < m.triangleOffset || uint64_t(md.pOffset) + md.pCount > uint64_t(m.triangleOffset) + m.triangleCount ||
+                md.boneBase < m.boneRemapOffset || md.boneBase >= uint64_t(m.boneRemapOffset) + m.boneRemapCount)
+                return "meshlet out of bounds";
+            for (uint32_t t = 0; t < md.pCount; ++t) {
+                const MeshletTriangle& tri = triangles[md.pOffset + t];
+                if (tri.x >= md.vCount || tri.y >= md.vCount || tri.z >= md.vCount) return "meshlet triangle out of bounds";
+            }
+        }
+        if (m.skin >= 0)
+            for (uint32_t i = 0; i < m.boneRemapCount; ++i)
+                if (remap[m.boneRemapOffset + i] >= skins[m.skin].boneCount) return "mesh bone out of range";
+    }
+    return nullptr;
+}
+
+// Layout() indexes by these without further checks: bone ranges inside Bones, parents before
+// children, slots sorted by depth, palette indices a permutation of the skin's bones.
+const char* PackFile::ValidateSkins() const {
+    const auto bones = Bones();
+    std::vector<bool> seen;
+    std::vector<uint32_t> depth;
+    for (const PackSkin& ps : Skins()) {
+        if (uint64_t(ps.boneOffset) + ps.boneCount > bones.size()) return "skin bones out of bounds";
+        seen.assign(ps.boneCount, false);
+        depth.assign(ps.boneCount, 0);
+        for (uint32_t s = 0; s < ps.boneCount; ++s) {
+            const PackBone& b = bones[ps.boneOffset + s];
+            if (b.parent < -1 || b.parent >= int64_t(s)) return "bone parent out of order";
+            depth[s] = b.parent >= 0 ? depth[b.parent] + 1 : 0;
+            if (s && depth[s] < depth[s - 1]) return "bones not sorted by depth";
+            if (b.paletteIndex < 0 || uint32_t(b.paletteIndex) >= ps.boneCount || seen[b.paletteIndex]) return "bad bone palette index";
+            seen[b.paletteIndex] = true;
+        }
+    }
+    return nullptr;
+}
+
+// Every key a track can fetch (see SampleClip) lies inside its section.
+const char* PackFile::ValidateClips() const {
+    const auto skins = Skins();
+    const auto tracks = Section<AnimTrack>(PackSection::Tracks);
+    const uint64_t times = Entry(PackSection::Times).count, values = Entry(PackSection::Values).count;
+    const uint64_t qvalues = Entry(PackSection::QValues).count;
+    for (const PackClip& c : Clips()) {
+        if (c.skin >= skins.size() || c.boneCount != skins[c.skin].boneCount) return "clip skin out of range";
+        if (uint64_t(c.trackOffset) + c.trackCount > tracks.size()) return "clip tracks out of bounds";
+        for (uint32_t t = 0; t < c.trackCount; ++t) {
+            const AnimTrack& tr = tracks[c.trackOffset + t];
+            if (tr.slot >= c.boneCount || tr.path > uint8_t(AnimPath::Scale) || tr.interp > uint8_t(AnimInterp::CubicSpline) ||
+                tr.encoding > uint8_t(TrackEncoding::Constant) || tr.comps < 3 || tr.comps > 4 || tr.keyCount == 0)
+                return "bad track";
+            if (tr.keyCount > 1 && uint64_t(tr.timeOffset) + tr.keyCount > times) return "track times out of bounds";
+            const bool constant = tr.encoding == uint8_t(TrackEncoding::Constant);
+            const uint64_t keys = constant ? 1 : uint64_t(tr.keyCount) * (tr.interp == uint8_t(AnimInterp::CubicSpline) ? 3 : 1);
+            const uint64_t available = tr.encoding == uint8_t(TrackEncoding::Quant16) ? qvalues : values;
+            if (uint64_t(tr.valueOffset) + keys * tr.comps > available) return "track values out of bounds";
+        }
+    }
+    return nullptr;
+}
+
+void PackFile::Close() {
+    if (!data_) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data_); CloseHandle(mapping_); CloseHandle(file_);
+    file_ = mapping_ = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr; size_ = 0;
+}
+
+const PackSectionEntry& PackFile::Entry(PackSection section) const {
+    return reinterpret_cast<const PackSectionEntry*>(data_ + sizeof(PackHeader))[size_t(section)];
+}
+
+const char* PackFile::String(uint32_t offset) const {
+    const auto strings = Section<char>(PackSection::Strings);
+    return offset < strings.size() ? strings.data() + offset : "";
+}
+
+PackMeshView PackFile::Mesh(uint32_t index) const {
+    if (index >= Meshes().size()) throw std::runtime_error("Pack mesh index out of range");
+    const PackMesh& m = Meshes()[index];
+    return { Vertices().subspan(m.vertexOffset, m.vertexCount), Triangles().subspan(m.triangleOffset, m.triangleCount),
+             Meshlets().subspan(m.meshletOffset, m.meshletCount), BoneRemap().subspan(m.boneRemapOffset, m.boneRemapCount),
+             m.skin, String(m.nameOffset) };
+}
+
+ClipView PackFile::Clip(uint32_t index) const {
+    if (index >= Clips().size()) throw std::runtime_error("Pack clip index out of range");
+    const PackClip& c = Clips()[index];
+    ClipView v;
+    v.tracks = Section<AnimTrack>(PackSection::Tracks).data() + c.trackOffset; v.trackCount = c.trackCount;
+    v.times = Section<float>(PackSection::Times).data();
+    v.values = Section<float>(PackSection::Values).data();
+    v.qvalues = Section<uint16_t>(PackSection::QValues).data();
+    v.duration = c.duration; v.boneCount = c.boneCount;
+    return v;
+}
+
+SkeletonLayout PackFile::Layout(uint32_t skin) const {
+    if (skin >= Skins().size()) throw std::runtime_error("Pack skin index out of range");
+    const PackSkin& ps = Skins()[skin];
+    const auto bones = Bones().subspan(ps.boneOffset, ps.boneCount);
+    SkeletonLayout L;
+    const size_t n = bones.size();
+    L.parent.resize(n); L.boneOfSlot.resize(n); L.node.resize(n); L.slotOfBone.resize(n);
+    L.inverseBind.resize(n * 16); L.restLocal.resize(n * 16);
+    std::vector<uint32_t> depth(n, 0);
+    for (size_t s = 0; s < n; ++s) {
+        const PackBone& b = bones[s];
+        L.parent[s] = b.parent; L.boneOfSlot[s] = b.paletteIndex; L.node[s] = b.node;
+        L.slotOfBone[b.paletteIndex] = int32_t(s);
+        memcpy(&L.inverseBind[s * 16], b.inverseBind, sizeof(b.inverseBind));
+        memcpy(&L.restLocal[s * 16], b.restLocal, sizeof(b.restLocal));
+        depth[s] = b.parent >= 0 ? depth[b.parent] + 1 : 0;
+        if (L.depthStart.size() <= depth[s]) L.depthStart.push_back(uint32_t(s));
+    }
+    L.depthStart.push_back(uint32_t(n));
+    return L;
+}
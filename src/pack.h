@@ -0,0 +1,131 @@
+#pragma once
+// Cooked asset pack: a versioned binary file of ready-to-upload arrays (VertexIn, meshlet
+// tables, skeletons, animation tracks) in 64-byte aligned sections. PackFile memory-maps the
+// file and hands out spans into it; nothing is parsed or copied at load.
+//
+// Layout: PackHeader | PackSectionEntry[PackSection::Count] | sections...
+// All meshlet offsets (vOffset/pOffset/boneBase) and track offsets are absolute within their
+// section, so every section can be uploaded or viewed as one block. Little-endian only.
+
+#include "mesh_types.h"
+#include "meshlet.h"
+#include "animation.h"
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct Skin;
+struct SkeletonLayout;
+
+constexpr uint32_t kPackMagic     = 0x4B505847; // "GXPK"
+constexpr uint32_t kPackVersion   = 1;
+constexpr uint32_t kPackAlignment = 64;
+
+enum class PackSection : uint32_t {
+    Meshes, Vertices, Triangles, Meshlets, BoneRemap,
+    Skins, Bones,
+    Clips, Tracks, Times, Values, QValues,
+    Strings,
+    Count
+};
+
+struct PackHeader       { uint32_t magic, version, sectionCount, reserved; uint64_t fileSize; };
+struct PackSectionEntry { uint32_t type, elementSize; uint64_t offset, count; };
+
+struct PackMesh {
+    uint32_t meshletOffset, meshletCount;
+    uint32_t vertexOffset, vertexCount, triangleOffset, triangleCount, boneRemapOffset, boneRemapCount;
+    int32_t  skin;        // index into Skins, or -1
+    uint32_t nameOffset;  // into Strings
+};
+struct PackSkin { uint32_t boneOffset, boneCount; int32_t skeletonRootNode; uint32_t nameOffset; };
+// Bones are stored in SkeletonLayout slot (depth) order.
+struct PackBone { int32_t parent, paletteIndex, node; uint32_t nameOffset; float inverseBind[16]; float restLocal[16]; };
+struct PackClip { uint32_t trackOffset, trackCount, skin, boneCount; float duration; uint32_t nameOffset; };
+
+// One mesh's slices of the shared sections. Meshlet offsets stay absolute within their sections.
+struct PackMeshView {
+    std::span<const VertexIn>        vertices;
+    std::span<const MeshletTriangle> triangles;
+    std::span<const MeshletData>     meshlets;
+    std::span<const uint32_t>        boneRemap;
+    int32_t skin;
+    const char* name;
+};
+
+class PackBuilder {
+public:
+    uint32_t AddMesh(const std::string& name, const MeshletMesh& mesh, int32_t skin);
+    uint32_t AddSkin(const std::string& name, const Skin& skin, const SkeletonLayout& layout);
+    uint32_t AddClip(const AnimationClip& clip, uint32_t skin);
+    void Write(const std::string& path) const; // throws std::runtime_error
+
+private:
+    uint32_t AddString(const std::string& s);
+
+    std::vector<PackMesh> meshes_;
+    std::vector<VertexIn> vertices_;
+    std::vector<MeshletTriangle> triangles_;
+    std::vector<MeshletData> meshlets_;
+    std::vector<uint32_t> boneRemap_;
+    std::vector<PackSkin> skins_;
+    std::vector<PackBone> bones_;
+    std::vector<PackClip> clips_;
+    std::vector<AnimTrack> tracks_;
+    std::vector<float> times_, values_;
+    std::vector<uint16_t> qvalues_;
+    std::string strings_;
+};
+
+class PackFile {
+public:
+    PackFile() = default;
+    explicit PackFile(const std::string& path) { Open(path); }
+    ~PackFile() { Close(); }
+    PackFile(const PackFile&) = delete;
+    PackFile& operator=(const PackFile&) = delete;
+
+    // Throws std::runtime_error on I/O or format errors, including mesh, skin and clip contents
+    // that would index outside their sections.
+    void Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return data_ != nullptr; }
+    size_t SizeBytes() const { return size_; }
+    const uint8_t* Data() const { return data_; }
+
+    template <class T> std::span<const T> Section(PackSection section) const {
+        const PackSectionEntry& e = Entry(section);
+        if (e.count && e.elementSize != sizeof(T)) throw std::runtime_error("Pack section element size mismatch");
+        return { reinterpret_cast<const T*>(data_ + e.offset), size_t(e.count) };
+    }
+
+    std::span<const PackMesh>        Meshes()    const { return Section<PackMesh>(PackSection::Meshes); }
+    std::span<const VertexIn>        Vertices()  const { return Section<VertexIn>(PackSection::Vertices); }
+    std::span<const MeshletTriangle> Triangles() const { return Section<MeshletTriangle>(PackSection::Triangles); }
+    std::span<const MeshletData>     Meshlets()  const { return Section<MeshletData>(PackSection::Meshlets); }
+    std::span<const uint32_t>        BoneRemap() const { return Section<uint32_t>(PackSection::BoneRemap); }
+    std::span<const PackSkin>        Skins()     const { return Section<PackSkin>(PackSection::Skins); }
+    std::span<const PackBone>        Bones()     const { return Section<PackBone>(PackSection::Bones); }
+    std::span<const PackClip>        Clips()     const { return Section<PackClip>(PackSection::Clips); }
+
+    const char* String(uint32_t offset) const;
+    PackMeshView Mesh(uint32_t index) const;     // throws on a bad index
+    ClipView Clip(uint32_t index) const;         // zero-copy view for SampleClip; throws on a bad index
+    SkeletonLayout Layout(uint32_t skin) const;  // small copy: bones only; throws on a bad index
+
+private:
+    const PackSectionEntry& Entry(PackSection section) const;
+    const char* ValidateMeshes() const;          // nullptr when valid, else the reason
+    const char* ValidateSkins() const;
+    const char* ValidateClips() const;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
@@ -0,0 +1,140 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+std::atomic<bool> gProfilerEnabled{ true };
+
+// head is written by the owning thread only, tail by the collector only.
+struct ProfileRing {
+    alignas(64) std::atomic<uint64_t> head{ 0 };
+    alignas(64) std::atomic<uint64_t> tail{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    uint32_t track = 0;
+    std::string name;                       // guarded by gRegistryMutex
+    std::unique_ptr<ProfileEvent[]> events{ new ProfileEvent[kProfileRingEvents] };
+};
+
+// Rings outlive their threads so events of exited threads can still be collected.
+static std::mutex gRegistryMutex;
+static std::vector<std::unique_ptr<ProfileRing>> gRings;
+static thread_local ProfileRing* tlsRing = nullptr;
+
+static ProfileRing* ThreadRing() {
+    if (tlsRing) return tlsRing;
+    auto ring = std::make_unique<ProfileRing>();
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    ring->track = uint32_t(gRings.size());
+    ring->name = "thread " + std::to_string(ring->track);
+    tlsRing = ring.get();
+    gRings.push_back(std::move(ring));
+    return tlsRing;
+}
+
+static void Push(const ProfileEvent& e) {
+    ProfileRing* r = ThreadRing();
+    const uint64_t head = r->head.load(std::memory_order_relaxed);
+    if (head - r->tail.load(std::memory_order_acquire) >= kProfileRingEvents) {
+        r->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    r->events[head & (kProfileRingEvents - 1)] = e;
+    r->head.store(head + 1, std::memory_order_release);
+}
+
+uint64_t ProfileNow() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void ProfileSetThreadName(const char* name) {
+    ProfileRing* r = ThreadRing();
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    r->name = name;
+}
+
+void ProfileZoneEnd(const char* name, uint64_t begin) {
+    ProfileEvent e; e.name = name; e.begin = begin; e.end = ProfileNow(); e.kind = ProfileEventKind::Zone;
+    e.track = ThreadRing()->track;
+    Push(e);
+}
+
+void ProfileCounter(const char* name, double value) {
+    if (!ProfilerEnabled()) return;
+    ProfileEvent e; e.name = name; e.begin = ProfileNow(); e.value = value; e.kind = ProfileEventKind::Counter;
+    e.track = ThreadRing()->track;
+    Push(e);
+}
+
+void ProfileGpuZone(const char* name, uint64_t begin, uint64_t end) {
+    if (!ProfilerEnabled()) return;
+    ProfileEvent e; e.name = name; e.begin = begin; e.end = end; e.kind = ProfileEventKind::Zone; e.track = kProfileGpuTrack;
+    Push(e);
+}
+
+size_t ProfilerCollect(std::vector<ProfileEvent>& out) {
+    size_t dropped = 0;
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    for (auto& r : gRings) {
+        const uint64_t tail = r->tail.load(std::memory_order_relaxed);
+        const uint64_t head = r->head.load(std::memory_order_acquire);
+        for (uint64_t i = tail; i < head; ++i) out.push_back(r->events[i & (kProfileRingEvents - 1)]);
+        r->tail.store(head, std::memory_order_release);
+        dropped += size_t(r->dropped.exchange(0, std::memory_order_relaxed));
+    }
+    return dropped;
+}
+
+std::vector<ProfileTrack> ProfilerTracks() {
+    std::vector<ProfileTrack> tracks{ { kProfileGpuTrack, "GPU" } };
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    for (auto& r : gRings) tracks.push_back({ r->track, r->name });
+    return tracks;
+}
+
+static void AppendEscaped(std::string& s, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') { s += '\\'; s += *c; }
+        else if (uint8_t(*c) < 0x20) { char buf[8]; snprintf(buf, sizeof(buf), "\\u%04x", unsigned(uint8_t(*c))); s += buf; }
+        else s += *c;
+    }
+}
+
+std::string ChromeTraceJson(const std::vector<ProfileEvent>& events, const std::vector<ProfileTrack>& tracks) {
+    uint64_t origin = UINT64_MAX;
+    for (const ProfileEvent& e : events) origin = std::min(origin, e.begin);
+    std::string s = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    char buf[160];
+    bool first = true;
+    auto separator = [&] { if (!first) s += ",\n"; first = false; };
+    for (const ProfileTrack& t : tracks) {
+        separator();
+        snprintf(buf, sizeof(buf), "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"", t.track);
+        s += buf; AppendEscaped(s, t.name.c_str()); s += "\"}}";
+    }
+    for (const ProfileEvent& e : events) {
+        separator();
+        s += "{\"name\":\""; AppendEscaped(s, e.name); s += "\",";
+        const double ts = double(e.begin - origin) * 1e-3;
+        if (e.kind == ProfileEventKind::Zone)
+            snprintf(buf, sizeof(buf), "\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", e.track, ts,
+                     double(e.end >= e.begin ? e.end - e.begin : 0) * 1e-3);
+        else
+            snprintf(buf, sizeof(buf), "\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%.17g}}", e.track, ts, std::isfinite(e.value) ? e.value : 0.0);
+        s += buf;
+    }
+    s += "\n]}\n";
+    return s;
+}
+
+void WriteChromeTrace(const std::string& path, const std::vector<ProfileEvent>& events, const std::vector<ProfileTrack>& tracks) {
+    const std::string json = ChromeTraceJson(events, tracks);
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) throw std::runtime_error("Cannot write trace: " + path);
+    const bool ok = fwrite(json.data(), 1, json.size(), f) == json.size();
+    if (fclose(f) != 0 || !ok) throw std::runtime_error("Failed writing trace: " + path);
+}
@@ -0,0 +1,77 @@
+#pragma once
+// Frame instrumentation: scoped CPU zones, counters and GPU zones recorded into per-thread
+// single-producer/single-consumer rings (no locks or allocations on the hot path), drained by
+// ProfilerCollect and written as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+//   GRFX_PROFILE_ZONE("Update bones");               // until the end of the scope
+//   ProfileCounter("upload bytes", double(bytes));
+//
+// Names must outlive the trace (string literals). A full ring drops new events and counts
+// them; drain once per frame. Build with GRFX_PROFILE=0 to compile the macros out.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef GRFX_PROFILE
+#define GRFX_PROFILE 1
+#endif
+
+constexpr size_t   kProfileRingEvents = 1 << 16; // per thread, power of two
+constexpr uint32_t kProfileGpuTrack   = 1000;    // track id of GPU zones
+
+enum class ProfileEventKind : uint32_t { Zone, Counter };
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t begin;                     // ns, ProfileNow() clock
+    union { uint64_t end; double value; };
+    uint32_t track;                     // registration order of the recording thread, or kProfileGpuTrack
+    ProfileEventKind kind;
+};
+
+uint64_t ProfileNow(); // steady_clock in ns (QPC-based with MSVC)
+
+extern std::atomic<bool> gProfilerEnabled;
+inline void ProfilerSetEnabled(bool enabled) { gProfilerEnabled.store(enabled, std::memory_order_relaxed); }
+inline bool ProfilerEnabled() { return gProfilerEnabled.load(std::memory_order_relaxed); }
+
+void ProfileSetThreadName(const char* name);         // names this thread's track in the trace
+void ProfileZoneEnd(const char* name, uint64_t begin); // records [begin, now]
+void ProfileCounter(const char* name, double value);
+// A GPU interval already converted to the ProfileNow() clock (see ID3D12CommandQueue::GetClockCalibration).
+void ProfileGpuZone(const char* name, uint64_t begin, uint64_t end);
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : name_(name), begin_(ProfilerEnabled() ? ProfileNow() : 0) {}
+    ~ProfileZone() { if (begin_) ProfileZoneEnd(name_, begin_); }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+private:
+    const char* name_;
+    uint64_t begin_;
+};
+
+#define GRFX_PROFILE_CONCAT2(a, b) a##b
+#define GRFX_PROFILE_CONCAT(a, b) GRFX_PROFILE_CONCAT2(a, b)
+#if GRFX_PROFILE
+#define GRFX_PROFILE_ZONE(name) ProfileZone GRFX_PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#else
+#define GRFX_PROFILE_ZONE(name) ((void)0)
+#endif
+
+struct ProfileTrack { uint32_t track; std::string name; };
+
+// Appends every event recorded since the last call (any thread may record meanwhile; one
+// collector at a time). Returns the number of events dropped to full rings since the last call.
+size_t ProfilerCollect(std::vector<ProfileEvent>& out);
+std::vector<ProfileTrack> ProfilerTracks();
+
+// Chrome trace event format: zones as complete ("X") events, counters as "C" events,
+// timestamps relative to the earliest event. Throws std::runtime_error if the file can't be written.
+void WriteChromeTrace(const std::string& path, const std::vector<ProfileEvent>& events,
+                      const std::vector<ProfileTrack>& tracks = ProfilerTracks());
+std::string ChromeTraceJson(const std::vector<ProfileEvent>& events, const std::vector<ProfileTrack>& tracks);
@@ -0,0 +1,41 @@
+#include "ring_allocator.h"
+
+#include <cassert>
+
+void RingAllocator::Reset(void* base, uint64_t size) {
+    base_ = static_cast<uint8_t*>(base); size_ = size;
+    head_.store(0, std::memory_order_relaxed); tail_.store(0, std::memory_order_relaxed);
+    firstFrame_ = frameCount_ = 0;
+}
+
+RingAllocator::Allocation RingAllocator::Allocate(uint64_t size, uint64_t alignment) {
+    assert(alignment && (alignment & (alignment - 1)) == 0);
+    if (size == 0 || size > size_) return {};
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    for (;;) {
+        // align the physical offset, not the position: size_ need not be a multiple of alignment
+        const uint64_t lap = head - head % size_;
+        const uint64_t offset = (head % size_ + alignment - 1) & ~(alignment - 1);
+        const uint64_t start = offset + size > size_ ? lap + size_ : lap + offset; // skip the wrap-around gap
+        const uint64_t end = start + size;
+        if (end - tail_.load(std::memory_order_acquire) > size_) return {};
+        // on failure `head` is reloaded and the placement recomputed
+        if (head_.compare_exchange_weak(head, end, std::memory_order_acq_rel, std::memory_order_relaxed))
+            return { base_ + start % size_, start % size_ };
+    }
+}
+
+bool RingAllocator::FinishFrame(uint64_t fenceValue) {
+    if (frameCount_ == kMaxFramesInFlight) return false;
+    frames_[(firstFrame_ + frameCount_) % kMaxFramesInFlight] = { fenceValue, head_.load(std::memory_order_acquire) };
+    frameCount_++;
+    return true;
+}
+
+void RingAllocator::Reclaim(uint64_t completedFenceValue) {
+    while (frameCount_ && frames_[firstFrame_].fenceValue <= completedFenceValue) {
+        tail_.store(frames_[firstFrame_].head, std::memory_order_release);
+        firstFrame_ = (firstFrame_ + 1) % kMaxFramesInFlight;
+        frameCount_--;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+// Linear ring allocator over a caller-owned block (on the GPU side: a persistently mapped
+// upload buffer). Allocate() is lock-free and may be called from any thread; space is handed
+// back a whole frame at a time once the GPU fence for that frame has passed.
+//
+// Head/tail are monotonically increasing byte positions (physical offset = position % size),
+// so full and empty are never ambiguous. An allocation never straddles the end of the block:
+// if it would, the rest of the block is skipped and it starts again at offset 0.
+//
+// Frame protocol (render thread):
+//   Reclaim(fence->GetCompletedValue());   // release finished frames
+//   ... Allocate() from any number of threads ...
+//   FinishFrame(valueSignaledForThisFrame);  // after every Allocate() of the frame returned
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class RingAllocator {
+public:
+    static constexpr uint32_t kMaxFramesInFlight = 16;
+
+    struct Allocation {
+        uint8_t* cpu = nullptr;  // nullptr: the ring is full until an older frame is reclaimed
+        uint64_t offset = 0;     // from the start of the block (add to the buffer's GPU address)
+        explicit operator bool() const { return cpu != nullptr; }
+    };
+
+    RingAllocator() = default;
+    RingAllocator(void* base, uint64_t size) { Reset(base, size); }
+    RingAllocator(const RingAllocator&) = delete;
+    RingAllocator& operator=(const RingAllocator&) = delete;
+
+    void Reset(void* base, uint64_t size); // not thread-safe; drops every frame
+
+    // alignment must be a power of two (256 for D3D12 constant buffer views). It applies to the
+    // offset within the block, whatever the block size.
+    Allocation Allocate(uint64_t size, uint64_t alignment = 256);
+
+    // Tags everything allocated since the previous FinishFrame with `fenceValue` (increasing).
+    // Returns false when kMaxFramesInFlight frames are already pending: Reclaim first.
+    bool FinishFrame(uint64_t fenceValue);
+    // Releases every finished frame whose fence value is <= completedFenceValue.
+    void Reclaim(uint64_t completedFenceValue);
+
+    uint64_t Capacity() const { return size_; }
+    uint64_t UsedBytes() const { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire); }
+    uint32_t PendingFrames() const { return frameCount_; }
+
+private:
+    struct FrameMark { uint64_t fenceValue, head; };
+
+    uint8_t* base_ = nullptr;
+    uint64_t size_ = 0;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    FrameMark frames_[kMaxFramesInFlight] = {};
+    uint32_t firstFrame_ = 0, frameCount_ = 0; // render thread only
+};
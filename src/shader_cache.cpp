@@ -0,0 +1,206 @@
+#include "shader_cache.h"
+#include "thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+static constexpr uint32_t kShaderEntryMagic   = 0x43535847; // "GXSC"
+static constexpr uint32_t kShaderEntryVersion = 1;
+
+struct ShaderEntryHeader {
+    uint32_t magic, version;
+    uint64_t key;
+    uint32_t objectSize, pdbSize, reflectionSize, nameSize;
+};
+
+static double MsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static bool ReadFile(const std::string& path, std::string& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END); const long size = ftell(f); fseek(f, 0, SEEK_SET);
+    out.resize(size > 0 ? size_t(size) : 0);
+    const bool ok = size >= 0 && fread(out.data(), 1, out.size(), f) == out.size();
+    fclose(f);
+    return ok;
+}
+
+// FNV-1a 64; every field is length-prefixed so ("ab","c") and ("a","bc") differ.
+struct KeyHasher {
+    uint64_t h = 0xcbf29ce484222325ull;
+    void Bytes(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) { h ^= p[i]; h *= 0x100000001b3ull; }
+    }
+    void Field(const std::string& s) { const uint64_t n = s.size(); Bytes(&n, sizeof(n)); Bytes(s.data(), s.size()); }
+};
+
+std::vector<std::string> ScanShaderIncludes(const std::string& file, const std::vector<std::string>& includeDirs) {
+    std::vector<std::string> found, pending{ file };
+    std::vector<fs::path> seen{ fs::path(file).lexically_normal() };
+    std::string text;
+    while (!pending.empty()) {
+        const fs::path current = pending.back(); pending.pop_back();
+        if (!ReadFile(current.string(), text)) continue;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos); if (end == std::string::npos) end = text.size();
+            size_t i = text.find_first_not_of(" \t", pos);
+            if (i < end && text[i] == '#') {
+                i = text.find_first_not_of(" \t", i + 1);
+                if (i < end && text.compare(i, 7, "include") == 0) {
+                    i = text.find_first_not_of(" \t", i + 7);
+                    const char close = i < end ? (text[i] == '"' ? '"' : text[i] == '<' ? '>' : 0) : 0;
+                    const size_t stop = close ? text.find(close, i + 1) : std::string::npos;
+                    if (stop < end) {
+                        const std::string name = text.substr(i + 1, stop - i - 1);
+                        std::vector<fs::path> candidates{ current.parent_path() / name };
+                        for (const std::string& dir : includeDirs) candidates.push_back(fs::path(dir) / name);
+                        for (const fs::path& c : candidates) {
+                            std::error_code ec;
+                            if (!fs::is_regular_file(c, ec)) continue;
+                            const fs::path norm = c.lexically_normal();
+                            bool known = false;
+                            for (const fs::path& s : seen) known |= s == norm;
+                            if (!known) { seen.push_back(norm); found.push_back(norm.string()); pending.push_back(norm.string()); }
+                            break;
+                        }
+                    }
+                }
+            }
+            pos = end + 1;
+        }
+    }
+    return found;
+}
+
+ShaderCache::ShaderCache(std::string directory, std::string compilerId, ShaderCompileFn compile)
+    : directory_(std::move(directory)), compilerId_(std::move(compilerId)), compile_(std::move(compile)) {
+    if (!directory_.empty()) {
+        std::error_code ec; fs::create_directories(directory_, ec);
+        if (ec) { fprintf(stderr, "shader cache: cannot create %s (%s), caching disabled\n", directory_.c_str(), ec.message().c_str()); directory_.clear(); }
+    }
+}
+
+uint64_t ShaderCache::Key(const ShaderDesc& desc) const {
+    // Content only: paths do not enter the key, so a moved checkout still hits.
+    KeyHasher k; std::string text;
+    k.Field(compilerId_);
+    if (!ReadFile(desc.file, text)) throw std::runtime_error("Cannot read shader source: " + desc.file);
+    k.Field(text);
+    const std::vector<std::string> includes = ScanShaderIncludes(desc.file, desc.includeDirs);
+    const uint64_t includeCount = includes.size(); k.Bytes(&includeCount, sizeof(includeCount));
+    for (const std::string& inc : includes) { if (ReadFile(inc, text)) k.Field(text); else k.Field(""); }
+    k.Field(desc.entry); k.Field(desc.target);
+    for (const std::string& d : desc.defines) k.Field(d);
+    k.Field("--");
+    for (const std::string& a : desc.args) k.Field(a);
+    return k.h;
+}
+
+std::string ShaderCache::EntryPath(uint64_t key) const {
+    char name[32]; snprintf(name, sizeof(name), "%016llx.dxc", (unsigned long long)key);
+    return (fs::path(directory_) / name).string();
+}
+
+bool ShaderCache::Load(uint64_t key, ShaderBinary& out) const {
+    std::string data;
+    if (directory_.empty() || !ReadFile(EntryPath(key), data)) return false;
+    ShaderEntryHeader h;
+    if (data.size() < sizeof(h)) return false;
+    memcpy(&h, data.data(), sizeof(h));
+    const uint64_t payload = uint64_t(h.objectSize) + h.pdbSize + h.reflectionSize + h.nameSize;
+    if (h.magic != kShaderEntryMagic || h.version != kShaderEntryVersion || h.key != key || h.objectSize == 0 ||
+        data.size() != sizeof(h) + payload) {
+        fprintf(stderr, "shader cache: ignoring corrupt entry %s\n", EntryPath(key).c_str());
+        return false;
+    }
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data.data()) + sizeof(h);
+    out.object.assign(p, p + h.objectSize);         p += h.objectSize;
+    out.pdb.assign(p, p + h.pdbSize);               p += h.pdbSize;
+    out.reflection.assign(p, p + h.reflectionSize); p += h.reflectionSize;
+    out.pdbName.assign(reinterpret_cast<const char*>(p), h.nameSize);
+    return true;
+}
+
+void ShaderCache::Store(uint64_t key, const ShaderBinary& b) const {
+    if (directory_.empty()) return;
+    static std::atomic<uint32_t> counter{ 0 };
+    const std::string path = EntryPath(key);
+    const std::string temp = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+                             "." + std::to_string(counter++) + ".tmp";
+    const ShaderEntryHeader h{ kShaderEntryMagic, kShaderEntryVersion, key, uint32_t(b.object.size()), uint32_t(b.pdb.size()),
+                               uint32_t(b.reflection.size()), uint32_t(b.pdbName.size()) };
+    FILE* f = fopen(temp.c_str(), "wb");
+    bool ok = f != nullptr;
+    if (ok) {
+        ok = fwrite(&h, sizeof(h), 1, f) == 1;
+        ok = ok && fwrite(b.object.data(), 1, b.object.size(), f) == b.object.size();
+        ok = ok && fwrite(b.pdb.data(), 1, b.pdb.size(), f) == b.pdb.size();
+        ok = ok && fwrite(b.reflection.data(), 1, b.reflection.size(), f) == b.reflection.size();
+        ok = ok && fwrite(b.pdbName.data(), 1, b.pdbName.size(), f) == b.pdbName.size();
+        ok = (fclose(f) == 0) && ok;
+    }
+    std::error_code ec;
+    if (ok) fs::rename(temp, path, ec);
+    if (!ok || ec) {
+        fs::remove(temp, ec);
+        fprintf(stderr, "shader cache: failed to write %s\n", path.c_str());
+    }
+}
+
+ShaderBinary ShaderCache::Get(const ShaderDesc& desc) {
+    auto t0 = std::chrono::steady_clock::now();
+    const uint64_t key = Key(desc);
+    const double keyMs = MsSince(t0);
+
+    ShaderBinary binary;
+    t0 = std::chrono::steady_clock::now();
+    const bool hit = Load(key, binary);
+    const double loadMs = MsSince(t0);
+    double compileMs = 0;
+    if (!hit) {
+        t0 = std::chrono::steady_clock::now();
+        binary = compile_(desc);
+        compileMs = MsSince(t0);
+        Store(key, binary);
+    }
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    (hit ? stats_.hits : stats_.misses)++;
+    stats_.keyMs += keyMs; stats_.loadMs += loadMs; stats_.compileMs += compileMs;
+    return binary;
+}
+
+std::vector<ShaderBinary> ShaderCache::GetAll(ThreadPool& pool, const std::vector<ShaderDesc>& descs) {
+    std::vector<ShaderBinary> out(descs.size());
+    pool.ParallelFor(0, descs.size(), 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) out[i] = Get(descs[i]);
+    });
+    return out;
+}
+
+void ShaderCache::ExportPdb(const ShaderBinary& binary) const {
+    if (directory_.empty() || binary.pdb.empty() || binary.pdbName.empty()) return;
+    const fs::path dir = fs::path(directory_) / "pdb";
+    std::error_code ec; fs::create_directories(dir, ec);
+    const fs::path path = dir / fs::path(binary.pdbName).filename();
+    if (fs::exists(path, ec)) return; // names are content hashes
+    FILE* f = fopen(path.string().c_str(), "wb");
+    if (!f) { fprintf(stderr, "shader cache: cannot write %s\n", path.string().c_str()); return; }
+    fwrite(binary.pdb.data(), 1, binary.pdb.size(), f);
+    fclose(f);
+}
+
+ShaderCacheStats ShaderCache::Stats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return stats_;
+}
@@ -0,0 +1,73 @@
+#pragma once
+// Content-addressed shader bytecode cache. An entry is keyed by a hash of the compiler id, the
+// source, every file it can #include (found by scanning, so an include behind an #if still
+// counts), entry point, profile, defines and arguments. Entries are single files
+// (<cache>/<key>.dxc) holding the object code plus PDB and reflection side data; they are
+// written to a temp name and renamed, so concurrent processes never see a torn entry.
+//
+// The cache does not know about DXC: misses go to a ShaderCompileFn (see dxc_compiler.h), which
+// is called from several threads at once by GetAll.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+struct ShaderDesc {
+    std::string file;                     // main source, read from disk
+    std::string entry, target;            // e.g. "MSMain", "ms_6_5"
+    std::vector<std::string> defines;     // "NAME=VALUE"
+    std::vector<std::string> includeDirs; // searched after the including file's directory
+    std::vector<std::string> args;        // extra compiler arguments
+};
+
+struct ShaderBinary {
+    std::vector<uint8_t> object;      // DXIL container
+    std::vector<uint8_t> pdb;         // may be empty
+    std::vector<uint8_t> reflection;  // may be empty
+    std::string pdbName;              // the name the object's debug info refers to
+};
+
+// Compiles one shader; throws std::runtime_error (with the compiler log) on failure.
+using ShaderCompileFn = std::function<ShaderBinary(const ShaderDesc&)>;
+
+struct ShaderCacheStats {
+    size_t hits = 0, misses = 0;
+    double keyMs = 0, loadMs = 0, compileMs = 0; // summed over threads
+};
+
+// Files reachable from `file` through #include "..." / <...>, in discovery order (the file
+// itself excluded). Missing includes are skipped: the compiler reports them.
+std::vector<std::string> ScanShaderIncludes(const std::string& file, const std::vector<std::string>& includeDirs);
+
+class ShaderCache {
+public:
+    // `compilerId` must change whenever the compiler does (version + commit), since it is part
+    // of every key. An empty `directory` disables the disk: every Get compiles.
+    ShaderCache(std::string directory, std::string compilerId, ShaderCompileFn compile);
+
+    uint64_t Key(const ShaderDesc& desc) const; // throws std::runtime_error if the source is missing
+    std::string EntryPath(uint64_t key) const;
+
+    ShaderBinary Get(const ShaderDesc& desc);
+    // Looks up every desc on the pool; misses compile in parallel. Rethrows the first failure.
+    std::vector<ShaderBinary> GetAll(ThreadPool& pool, const std::vector<ShaderDesc>& descs);
+
+    // Writes each binary's PDB as <directory>/pdb/<pdbName> so PIX can find it next to the cache.
+    void ExportPdb(const ShaderBinary& binary) const;
+
+    ShaderCacheStats Stats() const;
+
+private:
+    bool Load(uint64_t key, ShaderBinary& out) const;
+    void Store(uint64_t key, const ShaderBinary& binary) const;
+
+    std::string directory_, compilerId_;
+    ShaderCompileFn compile_;
+    mutable std::mutex statsMutex_;
+    ShaderCacheStats stats_;
+};
@@ -0,0 +1,88 @@
+#include "skeleton.h"
+#include "tinygltf.h"
+#include "mat4.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+SkeletonLayout BuildSkeletonLayout(const Skin& skin) {
+    const size_t n = skin.bones.size();
+    // depth of every bone via its parent chain, memoized
+    std::vector<int32_t> depth(n, -1), chain;
+    int32_t maxDepth = -1;
+    for (size_t i = 0; i < n; ++i) {
+        chain.clear();
+        int32_t b = int32_t(i);
+        for (; b >= 0; b = skin.bones[b].parent) {
+            if (b >= int32_t(n)) throw std::runtime_error("Bone parent out of range");
+            if (depth[b] >= 0) break;
+            if (chain.size() == n) throw std::runtime_error("Cycle in skeleton hierarchy");
+            chain.push_back(b);
+        }
+        int32_t d = b >= 0 ? depth[b] : -1;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) depth[*it] = ++d;
+        maxDepth = std::max(maxDepth, depth[i]);
+    }
+
+    // counting sort by depth, stable in bone order
+    SkeletonLayout L;
+    L.depthStart.assign(size_t(maxDepth + 2), 0);
+    for (size_t i = 0; i < n; ++i) L.depthStart[depth[i] + 1]++;
+    for (size_t d = 1; d < L.depthStart.size(); ++d) L.depthStart[d] += L.depthStart[d - 1];
+    std::vector<uint32_t> fill(L.depthStart.begin(), L.depthStart.end() - 1);
+    L.boneOfSlot.resize(n); L.slotOfBone.resize(n);
+    for (size_t i = 0; i < n; ++i) { const uint32_t slot = fill[depth[i]]++; L.boneOfSlot[slot] = int32_t(i); L.slotOfBone[i] = int32_t(slot); }
+
+    L.parent.resize(n); L.node.resize(n); L.inverseBind.resize(n * 16); L.restLocal.resize(n * 16);
+    for (size_t s = 0; s < n; ++s) {
+        const Bone& bone = skin.bones[L.boneOfSlot[s]];
+        L.parent[s] = bone.parent >= 0 ? L.slotOfBone[bone.parent] : -1;
+        L.node[s] = bone.node;
+        memcpy(&L.inverseBind[s * 16], bone.inverseBind, sizeof(float) * 16);
+        Mat4Identity(&L.restLocal[s * 16]);
+    }
+    return L;
+}
+
+void ReadRestPose(const tinygltf::Model& model, SkeletonLayout& layout) {
+    for (size_t s = 0; s < layout.BoneCount(); ++s) {
+        float* m = &layout.restLocal[s * 16];
+        if (layout.node[s] < 0 || layout.node[s] >= (int)model.nodes.size()) { Mat4Identity(m); continue; }
+        const auto& node = model.nodes[layout.node[s]];
+        if (node.matrix.size() == 16) { for (int i = 0; i < 16; ++i) m[i] = float(node.matrix[i]); continue; }
+        float t[3] = { 0, 0, 0 }, q[4] = { 0, 0, 0, 1 }, sc[3] = { 1, 1, 1 };
+        if (node.translation.size() == 3) for (int i = 0; i < 3; ++i) t[i] = float(node.translation[i]);
+        if (node.rotation.size() == 4)    for (int i = 0; i < 4; ++i) q[i] = float(node.rotation[i]);
+        if (node.scale.size() == 3)       for (int i = 0; i < 3; ++i) sc[i] = float(node.scale[i]);
+        ComposeTRS(t, q, sc, m);
+    }
+}
+
+void EvaluateSkeleton(const SkeletonLayout& layout, const float* local, float* global, float* skinning) {
+    const size_t n = layout.BoneCount();
+    const int32_t* parent = layout.parent.data();
+    // depth order guarantees the parent's global is final before its children read it
+    for (size_t s = 0; s < n; ++s) {
+        if (parent[s] < 0) memcpy(global + s * 16, local + s * 16, sizeof(float) * 16);
+        else Mat4Mul(global + size_t(parent[s]) * 16, local + s * 16, global + s * 16);
+    }
+    if (!skinning) return;
+    const float* ibm = layout.inverseBind.data();
+    for (size_t s = 0; s < n; ++s)
+        Mat4Mul(global + s * 16, ibm + s * 16, skinning + size_t(layout.boneOfSlot[s]) * 16);
+}
+
+void EvaluateSkeletonInstances(ThreadPool& pool, const SkeletonLayout& layout, size_t instanceCount,
+                               const float* locals, float* globals, float* skinning, size_t grain) {
+    const size_t stride = layout.BoneCount() * 16;
+    pool.ParallelFor(0, instanceCount, grain, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+            EvaluateSkeleton(layout, locals + i * stride, globals + i * stride, skinning ? skinning + i * stride : nullptr);
+    });
+}
+
+void StoreGlobalMatrices(const SkeletonLayout& layout, const float* global, Skin& skin) {
+    for (size_t s = 0; s < layout.BoneCount(); ++s)
+        memcpy(skin.bones[layout.boneOfSlot[s]].globalMatrix, global + s * 16, sizeof(float) * 16);
+}
@@ -0,0 +1,39 @@
+#pragma once
+// Skeleton runtime: bones of a Skin sorted by depth into flat arrays (parents before children),
+// evaluated per frame as local -> global -> skinning (global * inverseBind).
+// Roots are evaluated in skeleton space; non-joint ancestors of the root are not applied.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tinygltf { class Model; }
+struct Skin;
+class ThreadPool;
+
+struct SkeletonLayout {
+    // Indexed by slot (depth order): parent[i] < i, or -1 for roots.
+    std::vector<int32_t> parent;
+    std::vector<int32_t> boneOfSlot;  // slot -> Skin::bones index (== palette index)
+    std::vector<int32_t> node;        // slot -> glTF node
+    std::vector<uint32_t> depthStart; // first slot of each depth level, plus a terminator
+    std::vector<float> inverseBind;   // 16 per slot
+    std::vector<float> restLocal;     // 16 per slot, identity until ReadRestPose
+    std::vector<int32_t> slotOfBone;  // Skin::bones index -> slot
+
+    size_t BoneCount() const { return parent.size(); }
+};
+
+SkeletonLayout BuildSkeletonLayout(const Skin& skin);
+void ReadRestPose(const tinygltf::Model& model, SkeletonLayout& layout);
+
+// local and global: 16 floats per slot. skinning (optional, may be null): 16 floats per bone
+// in palette order, ready for gBones.
+void EvaluateSkeleton(const SkeletonLayout& layout, const float* local, float* global, float* skinning);
+
+// Same for `instanceCount` skeletons laid out back to back (BoneCount()*16 floats each).
+void EvaluateSkeletonInstances(ThreadPool& pool, const SkeletonLayout& layout, size_t instanceCount,
+                               const float* locals, float* globals, float* skinning, size_t grain = 8);
+
+// Copies slot-ordered global matrices into Bone::globalMatrix.
+void StoreGlobalMatrices(const SkeletonLayout& layout, const float* global, Skin& skin);
@@ -0,0 +1,254 @@
+#include "skin_validate.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRFX_VALIDATE_SSE 1
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif
+
+static constexpr size_t kValidateChunk = 64 * 1024; // vertices per parallel job
+
+void SkinIssueCounts::Add(const SkinIssueCounts& o) {
+    vertices += o.vertices; nonFinite += o.nonFinite; negative += o.negative; jointOutOfRange += o.jointOutOfRange;
+    pruned += o.pruned; zeroWeights += o.zeroWeights; drift += o.drift; modified += o.modified;
+    firstBadVertex = std::min(firstBadVertex, o.firstBadVertex);
+}
+
+static void ReadJoints(const VertexSkinView& v, size_t i, uint32_t j[4]) {
+    const uint8_t* p = v.joints + v.strideJ * i;
+    if (v.jointType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) { for (int k = 0; k < 4; ++k) j[k] = p[k]; }
+    else { uint16_t s[4]; memcpy(s, p, sizeof(s)); for (int k = 0; k < 4; ++k) j[k] = s[k]; }
+}
+
+static void WriteJoints(const VertexSkinView& v, size_t i, const uint32_t j[4]) {
+    uint8_t* p = const_cast<uint8_t*>(v.joints + v.strideJ * i);
+    if (v.jointType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) { for (int k = 0; k < 4; ++k) p[k] = uint8_t(j[k]); }
+    else { const uint16_t s[4] = { uint16_t(j[0]), uint16_t(j[1]), uint16_t(j[2]), uint16_t(j[3]) }; memcpy(p, s, sizeof(s)); }
+}
+
+static void ReadWeights(const VertexSkinView& v, size_t i, float w[4]) {
+    const uint8_t* p = v.weights + v.strideW * i;
+    switch (v.weightType) {
+    case TINYGLTF_COMPONENT_TYPE_FLOAT: memcpy(w, p, 4 * sizeof(float)); break;
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: for (int k = 0; k < 4; ++k) w[k] = p[k] / 255.0f; break;
+    default: { uint16_t s[4]; memcpy(s, p, sizeof(s)); for (int k = 0; k < 4; ++k) w[k] = s[k] / 65535.0f; }
+    }
+}
+
+// Normalized weights to unorm with the largest-remainder method, so the sum is exactly `one`.
+static void QuantizeUnorm(const float w[4], uint32_t one, uint32_t q[4]) {
+    float frac[4]; uint32_t total = 0;
+    for (int k = 0; k < 4; ++k) {
+        const float s = w[k] * float(one);
+        q[k] = std::min(uint32_t(s), one); frac[k] = s - float(q[k]); total += q[k];
+    }
+    for (; total < one; ++total) {
+        int best = 0;
+        for (int k = 1; k < 4; ++k) if (frac[k] > frac[best]) best = k;
+        q[best]++; frac[best] = -1.0f;
+    }
+}
+
+static void WriteWeights(const VertexSkinView& v, size_t i, const float w[4]) {
+    uint8_t* p = const_cast<uint8_t*>(v.weights + v.strideW * i);
+    uint32_t q[4];
+    switch (v.weightType) {
+    case TINYGLTF_COMPONENT_TYPE_FLOAT: memcpy(p, w, 4 * sizeof(float)); break;
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: QuantizeUnorm(w, 255, q); for (int k = 0; k < 4; ++k) p[k] = uint8_t(q[k]); break;
+    default: {
+        QuantizeUnorm(w, 65535, q);
+        const uint16_t s[4] = { uint16_t(q[0]), uint16_t(q[1]), uint16_t(q[2]), uint16_t(q[3]) }; memcpy(p, s, sizeof(s));
+    }
+    }
+}
+
+static void ValidateVertex(const VertexSkinView& v, size_t i, uint32_t jointCount, const SkinValidationOptions& o, SkinIssueCounts& c) {
+    float w[4]; uint32_t j[4];
+    ReadWeights(v, i, w); ReadJoints(v, i, j);
+    bool changed = false, nonFinite = false, negative = false, outOfRange = false, resetJoint = false;
+    float sum = 0;
+    for (int k = 0; k < 4; ++k) {
+        const bool weighted = w[k] != 0.0f; // NaN included
+        if (!std::isfinite(w[k])) { w[k] = 0; nonFinite = true; }
+        else if (w[k] < 0.0f) { w[k] = 0; negative = true; }
+        // an unused slot may hold any joint: reset it, but only a weighted one is an issue
+        if (j[k] >= jointCount) { w[k] = 0; j[k] = 0; outOfRange |= weighted; resetJoint = true; }
+        sum += w[k];
+    }
+    const bool drift = std::fabs(sum - 1.0f) > o.sumTolerance;
+    changed = nonFinite || negative || outOfRange;
+    if (o.pruneThreshold > 0.0f) {
+        for (int k = 0; k < 4; ++k)
+            if (w[k] > 0.0f && w[k] < o.pruneThreshold && sum - w[k] > 0.0f) { sum -= w[k]; w[k] = 0; c.pruned++; changed = true; }
+    }
+    const bool zero = !(sum > 0.0f);
+    if (zero) { w[0] = 1.0f; w[1] = w[2] = w[3] = 0.0f; sum = 1.0f; }
+
+    c.nonFinite += nonFinite; c.negative += negative; c.jointOutOfRange += outOfRange;
+    c.zeroWeights += zero; c.drift += drift && !zero;
+    if (!(changed || drift || zero)) {
+        if (o.fix && resetJoint) WriteJoints(v, i, j);
+        return;
+    }
+    c.modified++;
+    c.firstBadVertex = std::min(c.firstBadVertex, i);
+    if (!o.fix) return;
+    for (float& x : w) x /= sum;
+    WriteWeights(v, i, w);
+    if (resetJoint) WriteJoints(v, i, j);
+}
+
+#if GRFX_VALIDATE_SSE
+static __m128 LoadWeights(const VertexSkinView& v, size_t i) {
+    const uint8_t* p = v.weights + v.strideW * i;
+    if (v.weightType == TINYGLTF_COMPONENT_TYPE_FLOAT) return _mm_loadu_ps(reinterpret_cast<const float*>(p));
+    const __m128i zero = _mm_setzero_si128();
+    if (v.weightType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
+        uint32_t b; memcpy(&b, p, 4);
+        const __m128i x = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(int(b)), zero), zero);
+        return _mm_mul_ps(_mm_cvtepi32_ps(x), _mm_set1_ps(1.0f / 255.0f));
+    }
+    const __m128i x = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), zero);
+    return _mm_mul_ps(_mm_cvtepi32_ps(x), _mm_set1_ps(1.0f / 65535.0f));
+}
+
+// True when all four vertices [i, i+4) pass every check, in which case the scalar path is skipped.
+static bool QuadIsClean(const VertexSkinView& v, size_t i, uint32_t jointCount, const SkinValidationOptions& o) {
+    __m128 w0 = LoadWeights(v, i), w1 = LoadWeights(v, i + 1), w2 = LoadWeights(v, i + 2), w3 = LoadWeights(v, i + 3);
+    const __m128 zero = _mm_setzero_ps(), prune = _mm_set1_ps(o.pruneThreshold);
+    __m128 bad = zero;
+    for (__m128 w : { w0, w1, w2, w3 }) {
+        const __m128 z = _mm_mul_ps(w, zero);            // NaN for NaN/Inf
+        bad = _mm_or_ps(bad, _mm_cmpunord_ps(z, z));
+        bad = _mm_or_ps(bad, _mm_cmplt_ps(w, zero));
+        bad = _mm_or_ps(bad, _mm_and_ps(_mm_cmpgt_ps(w, zero), _mm_cmplt_ps(w, prune)));
+    }
+    _MM_TRANSPOSE4_PS(w0, w1, w2, w3);
+    const __m128 sum = _mm_add_ps(_mm_add_ps(w0, w1), _mm_add_ps(w2, w3));
+    const __m128 err = _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_sub_ps(sum, _mm_set1_ps(1.0f)));
+    bad = _mm_or_ps(bad, _mm_cmpgt_ps(err, _mm_set1_ps(o.sumTolerance)));
+    if (_mm_movemask_ps(bad)) return false;
+
+    // joints: saturating (j - (jointCount - 1)) is non-zero exactly for out-of-range joints
+    if (v.jointType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
+        if (jointCount > 0xFF) return true;
+        uint32_t b[4];
+        for (int k = 0; k < 4; ++k) memcpy(&b[k], v.joints + v.strideJ * (i + k), 4);
+        const __m128i j = _mm_setr_epi32(int(b[0]), int(b[1]), int(b[2]), int(b[3]));
+        const __m128i over = _mm_subs_epu8(j, _mm_set1_epi8(char(jointCount ? jointCount - 1 : 0)));
+        return jointCount && _mm_movemask_epi8(_mm_cmpeq_epi8(over, _mm_setzero_si128())) == 0xFFFF;
+    }
+    if (jointCount > 0xFFFF) return true;
+    const __m128i lo = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(v.joints + v.strideJ * i)),
+                                          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v.joints + v.strideJ * (i + 1))));
+    const __m128i hi = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(v.joints + v.strideJ * (i + 2))),
+                                          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v.joints + v.strideJ * (i + 3))));
+    const __m128i limit = _mm_set1_epi16(short(jointCount ? jointCount - 1 : 0));
+    const __m128i over = _mm_or_si128(_mm_subs_epu16(lo, limit), _mm_subs_epu16(hi, limit));
+    return jointCount && _mm_movemask_epi8(_mm_cmpeq_epi16(over, _mm_setzero_si128())) == 0xFFFF;
+}
+#endif
+
+SkinIssueCounts ValidateSkinStreams(const VertexSkinView& view, uint32_t jointCount, const SkinValidationOptions& options,
+                                    size_t begin, size_t end) {
+    SkinIssueCounts c;
+    if (!view.valid) return c;
+    end = std::min(end, view.count);
+    if (begin >= end) return c;
+    c.vertices = end - begin;
+    size_t i = begin;
+#if GRFX_VALIDATE_SSE
+    for (; i + 4 <= end; i += 4)
+        if (!QuadIsClean(view, i, jointCount, options))
+            for (size_t k = i; k < i + 4; ++k) ValidateVertex(view, k, jointCount, options, c);
+#endif
+    for (; i < end; ++i) ValidateVertex(view, i, jointCount, options, c);
+    return c;
+}
+
+static size_t ViewBytes(const VertexSkinView& v) {
+    return v.count * 4 * size_t(tinygltf::GetComponentSizeInBytes(v.jointType) + tinygltf::GetComponentSizeInBytes(v.weightType));
+}
+
+PrimitiveSkinReport ValidatePrimitiveSkin(const tinygltf::Model& model, const tinygltf::Skin& skin,
+                                          const tinygltf::Primitive& prim, const SkinValidationOptions& options) {
+    PrimitiveSkinReport r;
+    const VertexSkinView v = GetSkinStreams(model, prim);
+    if (!v.valid) { r.error = "missing or unsupported JOINTS_0/WEIGHTS_0"; return r; }
+    SkinValidationOptions reportOnly = options; reportOnly.fix = false;
+    r.counts = ValidateSkinStreams(v, uint32_t(skin.joints.size()), reportOnly);
+    return r;
+}
+
+SkinValidationReport ValidateModelSkins(ThreadPool& pool, tinygltf::Model& model, const SkinValidationOptions& options) {
+    SkinValidationReport report;
+    std::vector<int> skinOfMesh(model.meshes.size(), -1);
+    for (const auto& node : model.nodes)
+        if (node.mesh >= 0 && node.mesh < int(model.meshes.size()) && node.skin >= 0 && skinOfMesh[node.mesh] < 0)
+            skinOfMesh[node.mesh] = node.skin;
+
+    // one stream per distinct (JOINTS_0, WEIGHTS_0) pair
+    struct Stream { VertexSkinView view; uint32_t jointCount; size_t report; };
+    std::vector<Stream> streams;
+    std::map<std::pair<int, int>, size_t> streamOf;
+    for (size_t m = 0; m < model.meshes.size(); ++m)
+        for (size_t p = 0; p < model.meshes[m].primitives.size(); ++p) {
+            const auto& prim = model.meshes[m].primitives[p];
+            if (!prim.attributes.count("JOINTS_0") && !prim.attributes.count("WEIGHTS_0")) continue; // not skinned
+            PrimitiveSkinReport r; r.mesh = int(m); r.primitive = int(p); r.skin = skinOfMesh[m];
+            const VertexSkinView v = GetSkinStreams(model, prim);
+            if (!v.valid) r.error = "missing or unsupported JOINTS_0/WEIGHTS_0";
+            else {
+                const uint32_t joints = r.skin >= 0 && r.skin < int(model.skins.size()) ? uint32_t(model.skins[r.skin].joints.size()) : UINT32_MAX;
+                auto [it, inserted] = streamOf.try_emplace({ v.jointsAccessor, v.weightsAccessor }, streams.size());
+                if (inserted) streams.push_back({ v, joints, report.primitives.size() });
+                else { streams[it->second].jointCount = std::min(streams[it->second].jointCount, joints); r.sharedWith = int(streams[it->second].report); }
+            }
+            report.errors += !r.error.empty();
+            report.primitives.push_back(std::move(r));
+        }
+
+    struct Job { size_t stream, begin, end; };
+    std::vector<Job> jobs;
+    for (size_t s = 0; s < streams.size(); ++s)
+        for (size_t b = 0; b < streams[s].view.count; b += kValidateChunk)
+            jobs.push_back({ s, b, std::min(b + kValidateChunk, streams[s].view.count) });
+    std::vector<SkinIssueCounts> results(jobs.size());
+    pool.ParallelFor(0, jobs.size(), 1, [&](size_t b, size_t e) {
+        for (size_t k = b; k < e; ++k) {
+            const Stream& s = streams[jobs[k].stream];
+            results[k] = ValidateSkinStreams(s.view, s.jointCount, options, jobs[k].begin, jobs[k].end);
+        }
+    });
+
+    for (size_t k = 0; k < jobs.size(); ++k) report.primitives[streams[jobs[k].stream].report].counts.Add(results[k]);
+    for (const Stream& s : streams) {
+        report.total.Add(report.primitives[s.report].counts);
+        report.bytesScanned += ViewBytes(s.view);
+    }
+    for (auto& r : report.primitives)
+        if (r.sharedWith >= 0) r.counts = report.primitives[r.sharedWith].counts;
+    return report;
+}
+
+void PrintSkinReport(const SkinValidationReport& report, FILE* out) {
+    for (const auto& r : report.primitives) {
+        if (!r.error.empty()) { fprintf(out, "mesh %d prim %d: %s\n", r.mesh, r.primitive, r.error.c_str()); continue; }
+        if (r.sharedWith >= 0 || r.counts.Clean()) continue;
+        const SkinIssueCounts& c = r.counts;
+        fprintf(out, "mesh %d prim %d (skin %d): %zu/%zu vertices bad (first %zu): non-finite %zu, negative %zu, "
+                     "joint out of range %zu, zero %zu, drift %zu, pruned influences %zu\n",
+                r.mesh, r.primitive, r.skin, c.modified, c.vertices, c.firstBadVertex, c.nonFinite, c.negative,
+                c.jointOutOfRange, c.zeroWeights, c.drift, c.pruned);
+    }
+    const SkinIssueCounts& t = report.total;
+    fprintf(out, "skin validation: %zu primitives, %zu errors, %zu/%zu vertices bad, %.2f MB scanned\n",
+            report.primitives.size(), report.errors, t.modified, t.vertices, report.bytesScanned / (1024.0 * 1024.0));
+}
@@ -0,0 +1,75 @@
+#pragma once
+// Batch validation / repair of skinning streams (JOINTS_0 + WEIGHTS_0). Every issue is counted
+// into a report instead of thrown; with `fix` set, offending vertices are rewritten in place in
+// the model's buffers so ReadPrimitiveVertices / the cooker see clean data.
+//
+// Per vertex, in order: non-finite or negative weights become 0, influences on out-of-range
+// joints are dropped (a zero-weight slot's out-of-range joint is reset to 0 without being
+// reported), influences below pruneThreshold are dropped (never the last one), an
+// all-zero vertex binds fully to its first joint, and the result is renormalized when it was
+// changed or its sum drifted by more than sumTolerance. Unorm weights are requantized so they
+// sum to exactly 255 / 65535.
+
+#include "tinygltf.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+struct SkinValidationOptions {
+    float sumTolerance   = 1e-3f;
+    float pruneThreshold = 0.0f; // 0 disables pruning
+    bool  fix            = true;
+};
+
+struct SkinIssueCounts {
+    size_t vertices = 0;
+    size_t nonFinite = 0;        // vertices with NaN/Inf weights
+    size_t negative = 0;         // vertices with negative weights
+    size_t jointOutOfRange = 0;  // vertices with a weighted joint >= the skin's joint count
+    size_t pruned = 0;           // influences dropped below pruneThreshold
+    size_t zeroWeights = 0;      // vertices whose weights are all zero
+    size_t drift = 0;            // vertices whose weight sum is off by more than sumTolerance
+    size_t modified = 0;         // vertices rewritten (fix) or that would be
+    size_t firstBadVertex = SIZE_MAX;
+
+    bool Clean() const { return modified == 0; }
+    void Add(const SkinIssueCounts& o);
+};
+
+// Validates [begin, end) of one view against `jointCount` joints. Fixing writes through the
+// view, which must then point at writable memory. No allocations.
+SkinIssueCounts ValidateSkinStreams(const VertexSkinView& view, uint32_t jointCount, const SkinValidationOptions& options,
+                                    size_t begin = 0, size_t end = SIZE_MAX);
+
+struct PrimitiveSkinReport {
+    int mesh = -1, primitive = -1;
+    int skin = -1;               // skin of the first node instancing the mesh, -1 if none
+    int sharedWith = -1;         // index of the report that validated the same accessors
+    std::string error;           // streams missing/unsupported; counts are empty then
+    SkinIssueCounts counts;
+};
+
+struct SkinValidationReport {
+    std::vector<PrimitiveSkinReport> primitives;
+    SkinIssueCounts total;       // over unique streams only
+    size_t bytesScanned = 0;
+    size_t errors = 0;           // primitives with an error string
+
+    bool Clean() const { return errors == 0 && total.Clean(); }
+};
+
+// Single primitive, report only (the model is not modified).
+PrimitiveSkinReport ValidatePrimitiveSkin(const tinygltf::Model& model, const tinygltf::Skin& skin,
+                                          const tinygltf::Primitive& prim, const SkinValidationOptions& options = {});
+
+// Every skinned primitive of the model. Primitives sharing the same JOINTS_0/WEIGHTS_0 accessors
+// are validated once (against the smallest skin using them); large streams are split into
+// chunks so single big meshes still spread across the pool.
+SkinValidationReport ValidateModelSkins(ThreadPool& pool, tinygltf::Model& model, const SkinValidationOptions& options = {});
+
+void PrintSkinReport(const SkinValidationReport& report, FILE* out);
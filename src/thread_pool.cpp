@@ -0,0 +1,84 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+static thread_local const ThreadPool* tlsPool = nullptr;
+static thread_local size_t tlsWorker = 0;
+
+ThreadPool::ThreadPool(int workerCount) {
+    const unsigned n = workerCount >= 0 ? unsigned(workerCount)
+                                        : std::max(1u, std::thread::hardware_concurrency()) - 1;
+    queues_.resize(std::max(n, 1u));
+    for (auto& q : queues_) q = std::make_unique<WorkQueue>();
+    threads_.reserve(n);
+    for (unsigned i = 0; i < n; ++i) threads_.emplace_back([this, i]{ WorkerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    { std::lock_guard<std::mutex> lock(sleepMutex_); stop_ = true; }
+    wake_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    if (threads_.empty()) { task(); return; }
+    const size_t q = tlsPool == this ? tlsWorker : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    { std::lock_guard<std::mutex> lock(queues_[q]->mutex); queues_[q]->tasks.push_back(std::move(task)); }
+    { std::lock_guard<std::mutex> lock(sleepMutex_); pending_.fetch_add(1, std::memory_order_release); }
+    wake_.notify_one();
+}
+
+bool ThreadPool::TryRun(size_t home) {
+    std::function<void()> task;
+    const size_t n = queues_.size();
+    for (size_t i = 0; i < n && !task; ++i) {
+        WorkQueue& q = *queues_[(home + i) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) continue;
+        if (i == 0) { task = std::move(q.tasks.back()); q.tasks.pop_back(); }   // own queue: LIFO
+        else        { task = std::move(q.tasks.front()); q.tasks.pop_front(); } // steal: FIFO
+    }
+    if (!task) return false;
+    pending_.fetch_sub(1, std::memory_order_acq_rel);
+    task();
+    return true;
+}
+
+bool ThreadPool::RunPendingTask() {
+    return TryRun(tlsPool == this ? tlsWorker : 0);
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+    tlsPool = this; tlsWorker = index;
+    for (;;) {
+        if (TryRun(index)) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [&]{ return stop_ || pending_.load(std::memory_order_acquire) > 0; });
+        if (stop_) return;
+    }
+}
+
+void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (end <= begin) return;
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (end - begin + grain - 1) / grain;
+    if (chunks == 1 || threads_.empty()) { fn(begin, end); return; }
+
+    // Runners claim chunks dynamically; the caller is one of them.
+    std::atomic<size_t> nextChunk{0}, exited{0};
+    std::exception_ptr error; std::mutex errorMutex;
+    auto runner = [&]() {
+        for (size_t c; (c = nextChunk.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+            try { const size_t b = begin + c * grain; fn(b, std::min(end, b + grain)); }
+            catch (...) { std::lock_guard<std::mutex> lock(errorMutex); if (!error) error = std::current_exception(); }
+        }
+    };
+    const size_t helpers = std::min<size_t>(threads_.size(), chunks - 1);
+    for (size_t i = 0; i < helpers; ++i) Submit([&]{ runner(); exited.fetch_add(1, std::memory_order_acq_rel); });
+    runner();
+    // helpers reference this frame: wait until they have all left, running other work meanwhile
+    while (exited.load(std::memory_order_acquire) < helpers)
+        if (!RunPendingTask()) std::this_thread::yield();
+    if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,49 @@
+#pragma once
+// Work-stealing thread pool. Each worker owns a deque: it pops its own tasks LIFO and steals
+// from the other workers FIFO. Threads that wait on a ParallelFor help run queued tasks, so
+// nested parallel loops do not deadlock.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // -1: hardware_concurrency() - 1 workers. 0 workers is valid: Submit then runs inline and
+    // ParallelFor runs on the caller, which keeps single-core measurements comparable.
+    explicit ThreadPool(int workerCount = -1);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned WorkerCount() const { return unsigned(threads_.size()); }
+
+    void Submit(std::function<void()> task);
+
+    // Runs fn(chunkBegin, chunkEnd) over [begin, end) in chunks of `grain` on the workers and
+    // the calling thread; returns when every chunk is done. Rethrows the first exception.
+    void ParallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+    // Runs at most one queued task on the calling thread. Returns false if none was available.
+    bool RunPendingTask();
+
+private:
+    struct WorkQueue { std::mutex mutex; std::deque<std::function<void()>> tasks; };
+
+    bool TryRun(size_t home);
+    void WorkerLoop(size_t index);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> nextQueue_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+};
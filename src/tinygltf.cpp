@@ -5,30 +5,18 @@
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "tiny_gltf.h"
+#include "tinygltf.h"
 
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <stdexcept>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
-struct Bone {
-    int node;                  // index in glTF nodes
-    int parent;                // parent bone index, or -1
-    std::string name;
-    // bind-space data
-    float inverseBind[16];
-    // runtime data (updated per-frame)
-    float globalMatrix[16];
-};
+// 4x4 helpers live in mat4.h.
 
-struct Skin {
-    int skinIndex;
-    std::vector<Bone> bones;
-    int skeletonRootNode = -1; // optional: from skin.skeleton (if author provides)
-};
-
-// Helpers for 4x4 operations omitted for brevity; use a math lib in production.
+static const float kIdentity[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
 
 static void ReadAccessorMat4(const tinygltf::Model& model, int accessorIndex,
                              std::vector<float>& out) {
@@ -68,28 +56,27 @@ Skin BuildSkin(const tinygltf::Model& model, int skinIndex) {
 
     // 2) build bones array
     s.bones.resize(joints.size());
-    std::unordered_map<int,int> nodeToBone; nodeToBone.reserve(joints.size());
+    std::vector<int> nodeToBone(model.nodes.size(), -1);
     for (size_t i = 0; i < joints.size(); ++i) {
         const int nodeIdx = joints[i];
-        nodeToBone[nodeIdx] = int(i);
+        if (nodeIdx >= 0 && nodeIdx < (int)model.nodes.size()) nodeToBone[nodeIdx] = int(i);
         s.bones[i].node = nodeIdx;
         s.bones[i].parent = -1;
         if (nodeIdx >= 0 && nodeIdx < (int)model.nodes.size())
             s.bones[i].name = model.nodes[nodeIdx].name;
         memcpy(s.bones[i].inverseBind, &ibm[i*16], sizeof(float)*16);
+        memcpy(s.bones[i].globalMatrix, kIdentity, sizeof(float)*16); // filled by the skeleton runtime
     }
 
-    // 3) compute parent links from node hierarchy
+    // 3) compute parent links from node hierarchy: one pass over every children list
+    std::vector<int> nodeParent(model.nodes.size(), -1);
+    for (size_t n = 0; n < model.nodes.size(); ++n)
+        for (int child : model.nodes[n].children)
+            if (child >= 0 && child < (int)nodeParent.size()) nodeParent[child] = int(n);
     for (size_t i = 0; i < joints.size(); ++i) {
-        int nodeIdx = joints[i];
-        // find any parent among joints (linear scan is fine for small rigs)
-        for (size_t j = 0; j < joints.size(); ++j) {
-            const auto& parentNode = model.nodes[joints[j]];
-            for (int child : parentNode.children) {
-                if (child == nodeIdx) { s.bones[i].parent = int(j); break; }
-            }
-            if (s.bones[i].parent >= 0) break;
-        }
+        const int nodeIdx = joints[i];
+        const int parentNode = (nodeIdx >= 0 && nodeIdx < (int)model.nodes.size()) ? nodeParent[nodeIdx] : -1;
+        if (parentNode >= 0) s.bones[i].parent = nodeToBone[parentNode];
     }
 
     // optional: skin.skeleton is the common root node of the skeleton
@@ -110,61 +97,127 @@ bool LoadGLTF(const std::string& path, tinygltf::Model& model) {
     return ok;
 }
 
-struct VertexSkinView {
-    const uint16_t* joints16 = nullptr; // or uint8_t*
-    const float*    weights   = nullptr; // 4 floats per vertex
-    size_t count = 0; size_t strideJ = 0; size_t strideW = 0;
-    bool valid = false;
-};
+bool LoadGLTFFromMemory(const uint8_t* data, size_t size, const std::string& baseDir, tinygltf::Model& model,
+                        std::string& error) {
+    if (size > 0xFFFFFFFFull) { error = "glTF file larger than 4 GiB"; return false; }
+    tinygltf::TinyGLTF loader; std::string warn;
+    if (size >= 4 && memcmp(data, "glTF", 4) == 0)
+        return loader.LoadBinaryFromMemory(&model, &error, &warn, data, unsigned(size), baseDir);
+    return loader.LoadASCIIFromString(&model, &error, &warn, reinterpret_cast<const char*>(data), unsigned(size), baseDir);
+}
 
-VertexSkinView GetSkinStreams(const tinygltf::Model& m,
-                              const tinygltf::Primitive& prim) {
-    VertexSkinView v{};
-    auto getView = [&](const char* sem, bool weights) ->std::pair<const uint8_t*, size_t> {
-        auto it = prim.attributes.find(sem);
-        if (it == prim.attributes.end()) return {nullptr,0};
-        const auto& acc = m.accessors[it->second];
-        const auto& view = m.bufferViews[acc.bufferView];
-        const auto& buf = m.buffers[view.buffer];
-        size_t stride = view.byteStride ? view.byteStride :
-                        (weights ? sizeof(float)*4
-                                 : (acc.componentType==TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT ? sizeof(uint16_t)*4 : sizeof(uint8_t)*4));
-        const uint8_t* base = buf.data.data() + view.byteOffset + acc.byteOffset;
-        return { base, stride };
-    };
-    auto [jptr, jstride] = getView("JOINTS_0", false);
-    auto [wptr, wstride] = getView("WEIGHTS_0", true);
-    if (!jptr || !wptr) return v;
-
-    v.joints16 = reinterpret_cast<const uint16_t*>(jptr); // adjust if u8
-    v.weights  = reinterpret_cast<const float*>(wptr);
-    v.count    = m.accessors[prim.attributes.at("WEIGHTS_0")].count;
-    v.strideJ  = jstride; v.strideW = wstride;
-    v.valid    = true; return v;
+static const uint8_t* AccessorBase(const tinygltf::Model& model, const tinygltf::Accessor& acc, size_t& stride) {
+    if (acc.bufferView < 0) { stride = 0; return nullptr; } // sparse-only accessor: implicit zeros
+    const auto& view = model.bufferViews[acc.bufferView];
+    const auto& buf = model.buffers[view.buffer];
+    stride = size_t(acc.ByteStride(view));
+    return buf.data.data() + view.byteOffset + acc.byteOffset;
 }
 
-void ValidatePrimitiveSkin(const tinygltf::Model& model,
-                           const tinygltf::Skin& skin,
-                           const tinygltf::Primitive& prim)
-{
-    auto v = GetSkinStreams(model, prim);
-    if (!v.valid) throw std::runtime_error("Missing JOINTS_0/WEIGHTS_0");
-
-    for (size_t i = 0; i < v.count; ++i) {
-        const uint16_t* J = reinterpret_cast<const uint16_t*>(
-            reinterpret_cast<const uint8_t*>(v.joints16) + v.strideJ * i);
-        const float* W = reinterpret_cast<const float*>(
-            reinterpret_cast<const uint8_t*>(v.weights) + v.strideW * i);
-
-        float sum = W[0]+W[1]+W[2]+W[3];
-        if (!(sum > 0.0f)) throw std::runtime_error("All zero weights");
-        if (std::abs(sum - 1.0f) > 1e-3f) {
-            // Renormalize or warn; many exporters leave small drift
-        }
-        for (int k=0;k<4;k++) {
-            if (W[k] < 0.0f) throw std::runtime_error("Negative weight");
-            if (J[k] >= skin.joints.size())
-                throw std::runtime_error("Joint index out of range");
-        }
+static float ReadComponentFloat(const uint8_t* p, int componentType, bool normalized) {
+    switch (componentType) {
+    case TINYGLTF_COMPONENT_TYPE_FLOAT:          { float v; memcpy(&v, p, 4); return v; }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:  return normalized ? p[0] / 255.0f : float(p[0]);
+    case TINYGLTF_COMPONENT_TYPE_BYTE:           { int8_t v = int8_t(p[0]); return normalized ? std::max(v / 127.0f, -1.0f) : float(v); }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: { uint16_t v; memcpy(&v, p, 2); return normalized ? v / 65535.0f : float(v); }
+    case TINYGLTF_COMPONENT_TYPE_SHORT:          { int16_t v; memcpy(&v, p, 2); return normalized ? std::max(v / 32767.0f, -1.0f) : float(v); }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:   { uint32_t v; memcpy(&v, p, 4); return float(v); }
+    default: throw std::runtime_error("Unsupported accessor component type");
+    }
+}
+
+static uint32_t ReadComponentUInt(const uint8_t* p, int componentType) {
+    switch (componentType) {
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:  return p[0];
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: { uint16_t v; memcpy(&v, p, 2); return v; }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:   { uint32_t v; memcpy(&v, p, 4); return v; }
+    default: throw std::runtime_error("Unsupported index/joint component type");
+    }
+}
+
+void ReadAccessorFloats(const tinygltf::Model& model, int accessorIndex, int comps, std::vector<float>& out) {
+    const auto& acc = model.accessors[accessorIndex];
+    size_t stride; const uint8_t* base = AccessorBase(model, acc, stride);
+    const int n = std::min(comps, tinygltf::GetNumComponentsInType(acc.type));
+    const size_t csize = size_t(tinygltf::GetComponentSizeInBytes(acc.componentType));
+    out.assign(acc.count * comps, 0.0f);
+    if (!base) return;
+    for (size_t i = 0; i < acc.count; ++i)
+        for (int c = 0; c < n; ++c)
+            out[i*comps + c] = ReadComponentFloat(base + stride*i + csize*c, acc.componentType, acc.normalized);
+}
+
+void ReadAccessorUInts(const tinygltf::Model& model, int accessorIndex, int comps, std::vector<uint32_t>& out) {
+    const auto& acc = model.accessors[accessorIndex];
+    size_t stride; const uint8_t* base = AccessorBase(model, acc, stride);
+    const int n = std::min(comps, tinygltf::GetNumComponentsInType(acc.type));
+    const size_t csize = size_t(tinygltf::GetComponentSizeInBytes(acc.componentType));
+    out.assign(acc.count * comps, 0u);
+    if (!base) return;
+    for (size_t i = 0; i < acc.count; ++i)
+        for (int c = 0; c < n; ++c)
+            out[i*comps + c] = ReadComponentUInt(base + stride*i + csize*c, acc.componentType);
+}
+
+void ReadPrimitiveVertices(const tinygltf::Model& model, const tinygltf::Primitive& prim,
+                           std::vector<VertexIn>& vertices, std::vector<uint32_t>& indices) {
+    if (prim.mode != -1 && prim.mode != TINYGLTF_MODE_TRIANGLES)
+        throw std::runtime_error("Only triangle-list primitives are supported");
+    auto attr = [&](const char* sem) { auto it = prim.attributes.find(sem); return it == prim.attributes.end() ? -1 : it->second; };
+    const int posAcc = attr("POSITION"), nrmAcc = attr("NORMAL"), jntAcc = attr("JOINTS_0"), wgtAcc = attr("WEIGHTS_0");
+    if (posAcc < 0) throw std::runtime_error("Primitive has no POSITION");
+
+    std::vector<float> pos, nrm, wgt; std::vector<uint32_t> jnt;
+    ReadAccessorFloats(model, posAcc, 3, pos);
+    const size_t n = model.accessors[posAcc].count;
+    if (nrmAcc >= 0) ReadAccessorFloats(model, nrmAcc, 3, nrm);
+    const bool skinned = jntAcc >= 0 && wgtAcc >= 0;
+    if (skinned) {
+        if (model.accessors[jntAcc].count != n || model.accessors[wgtAcc].count != n)
+            throw std::runtime_error("JOINTS_0/WEIGHTS_0 count does not match POSITION");
+        ReadAccessorUInts(model, jntAcc, 4, jnt); ReadAccessorFloats(model, wgtAcc, 4, wgt);
+    }
+
+    vertices.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        VertexIn& v = vertices[i];
+        memcpy(v.pos, &pos[i*3], sizeof(v.pos));
+        if (nrm.size() >= (i+1)*3) memcpy(v.nrm, &nrm[i*3], sizeof(v.nrm));
+        else { v.nrm[0] = 0; v.nrm[1] = 0; v.nrm[2] = 1; }
+        if (skinned) { memcpy(v.boneIdx, &jnt[i*4], sizeof(v.boneIdx)); memcpy(v.boneWgt, &wgt[i*4], sizeof(v.boneWgt)); }
+        else { memset(v.boneIdx, 0, sizeof(v.boneIdx)); v.boneWgt[0] = 1; v.boneWgt[1] = v.boneWgt[2] = v.boneWgt[3] = 0; }
     }
+
+    if (prim.indices >= 0) ReadAccessorUInts(model, prim.indices, 1, indices);
+    else { indices.resize(n); for (size_t i = 0; i < n; ++i) indices[i] = uint32_t(i); }
+    indices.resize(indices.size() - indices.size() % 3);
+}
+
+
+VertexSkinView GetSkinStreams(const tinygltf::Model& m, const tinygltf::Primitive& prim) {
+    VertexSkinView v{};
+    auto jt = prim.attributes.find("JOINTS_0"), wt = prim.attributes.find("WEIGHTS_0");
+    if (jt == prim.attributes.end() || wt == prim.attributes.end()) return v;
+    const auto& ja = m.accessors[jt->second];
+    const auto& wa = m.accessors[wt->second];
+    if (ja.type != TINYGLTF_TYPE_VEC4 || wa.type != TINYGLTF_TYPE_VEC4 || ja.count != wa.count) return v;
+    if (ja.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE && ja.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) return v;
+    if (wa.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT &&
+        !(wa.normalized && (wa.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE || wa.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT))) return v;
+
+    // whole stream must lie inside its buffer view
+    auto inView = [&](const tinygltf::Accessor& acc, size_t stride) {
+        const auto& view = m.bufferViews[acc.bufferView];
+        const size_t elem = size_t(tinygltf::GetComponentSizeInBytes(acc.componentType)) * 4;
+        return stride >= elem && (acc.count == 0 || acc.byteOffset + stride * (acc.count - 1) + elem <= view.byteLength) &&
+               view.byteOffset + view.byteLength <= m.buffers[view.buffer].data.size();
+    };
+    size_t strideJ, strideW;
+    v.joints = AccessorBase(m, ja, strideJ); v.weights = AccessorBase(m, wa, strideW);
+    if (!v.joints || !v.weights || !inView(ja, strideJ) || !inView(wa, strideW)) return {};
+
+    v.jointType = ja.componentType; v.weightType = wa.componentType;
+    v.count = wa.count; v.strideJ = strideJ; v.strideW = strideW;
+    v.jointsAccessor = jt->second; v.weightsAccessor = wt->second;
+    v.valid = true; return v;
 }
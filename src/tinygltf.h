@@ -0,0 +1,56 @@
+#pragma once
+// glTF loading and skin extraction on top of tinygltf (see tinygltf.cpp).
+
+#include "tiny_gltf.h"
+#include "mesh_types.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+struct Bone {
+    int node;                  // index in glTF nodes
+    int parent;                // parent bone index, or -1
+    std::string name;
+    // bind-space data
+    float inverseBind[16];
+    // runtime data (updated per-frame)
+    float globalMatrix[16];
+};
+
+struct Skin {
+    int skinIndex;
+    std::vector<Bone> bones;
+    int skeletonRootNode = -1; // optional: from skin.skeleton (if author provides)
+};
+
+bool LoadGLTF(const std::string& path, tinygltf::Model& model);
+// Same for a file already in memory: GLB when it starts with the binary magic, JSON otherwise.
+// External URIs resolve against baseDir. Errors go to `error` instead of stderr.
+bool LoadGLTFFromMemory(const uint8_t* data, size_t size, const std::string& baseDir, tinygltf::Model& model,
+                        std::string& error);
+Skin BuildSkin(const tinygltf::Model& model, int skinIndex);
+
+// Accessor decoding. Integer components are converted (and scaled when the accessor is
+// normalized); `comps` values are written per element, missing components are zero.
+void ReadAccessorFloats(const tinygltf::Model& model, int accessorIndex, int comps, std::vector<float>& out);
+void ReadAccessorUInts(const tinygltf::Model& model, int accessorIndex, int comps, std::vector<uint32_t>& out);
+
+// Flattens a triangle primitive into VertexIn + a 32-bit index list. Missing NORMAL defaults
+// to +Z, missing JOINTS_0/WEIGHTS_0 binds every vertex fully to joint 0. Throws when JOINTS_0 or
+// WEIGHTS_0 has a different count than POSITION.
+void ReadPrimitiveVertices(const tinygltf::Model& model, const tinygltf::Primitive& prim,
+                           std::vector<VertexIn>& vertices, std::vector<uint32_t>& indices);
+
+// Raw JOINTS_0 / WEIGHTS_0 streams of a primitive, pointing into the model's buffers.
+struct VertexSkinView {
+    const uint8_t* joints  = nullptr; int jointType  = 0; // UNSIGNED_BYTE or UNSIGNED_SHORT
+    const uint8_t* weights = nullptr; int weightType = 0; // FLOAT, or normalized UNSIGNED_BYTE/SHORT
+    size_t count = 0; size_t strideJ = 0; size_t strideW = 0;
+    int jointsAccessor = -1, weightsAccessor = -1;
+    bool valid = false;
+};
+
+// Invalid (valid == false) when either stream is missing, sparse, out of bounds or of a
+// component type glTF does not allow for skinning.
+VertexSkinView GetSkinStreams(const tinygltf::Model& m, const tinygltf::Primitive& prim);
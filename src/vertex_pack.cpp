@@ -0,0 +1,157 @@
+#include "vertex_pack.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+static float SignNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+static float Snorm16ToFloat(uint16_t v) { return std::max(float(int16_t(v)) / 32767.0f, -1.0f); }
+
+void OctDecode(const uint16_t oct[2], float n[3]) {
+    float x = Snorm16ToFloat(oct[0]), y = Snorm16ToFloat(oct[1]);
+    const float z = 1.0f - std::fabs(x) - std::fabs(y);
+    const float t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t; y += y >= 0.0f ? -t : t;
+    const float len = std::sqrt(x*x + y*y + z*z);
+    n[0] = x / len; n[1] = y / len; n[2] = z / len;
+}
+
+void OctEncode(const float n[3], uint16_t oct[2]) {
+    const float l1 = std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]);
+    if (l1 == 0.0f) { oct[0] = oct[1] = 0; return; } // decodes to +Z
+    float u = n[0] / l1, v = n[1] / l1;
+    if (n[2] < 0.0f) { const float pu = (1.0f - std::fabs(v)) * SignNotZero(u); v = (1.0f - std::fabs(u)) * SignNotZero(v); u = pu; }
+    // try floor/ceil in both axes and keep the closest decoded direction
+    const float su = std::clamp(u, -1.0f, 1.0f) * 32767.0f, sv = std::clamp(v, -1.0f, 1.0f) * 32767.0f;
+    const float inv = 1.0f / std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+    float best = -2.0f;
+    for (int i = 0; i < 4; ++i) {
+        const uint16_t c[2] = { uint16_t(int16_t((i & 1) ? std::ceil(su) : std::floor(su))),
+                                uint16_t(int16_t((i & 2) ? std::ceil(sv) : std::floor(sv))) };
+        float d[3]; OctDecode(c, d);
+        const float dot = (d[0]*n[0] + d[1]*n[1] + d[2]*n[2]) * inv;
+        if (dot > best) { best = dot; oct[0] = c[0]; oct[1] = c[1]; }
+    }
+}
+
+void QuantizeWeights(const float w[4], uint8_t q[4]) {
+    float sum = 0;
+    for (int i = 0; i < 4; ++i) sum += std::max(w[i], 0.0f);
+    if (!(sum > 0.0f)) { q[0] = 255; q[1] = q[2] = q[3] = 0; return; }
+    float frac[4]; int total = 0;
+    for (int i = 0; i < 4; ++i) {
+        const float s = std::max(w[i], 0.0f) / sum * 255.0f;
+        const int f = std::min(int(s), 255);
+        q[i] = uint8_t(f); frac[i] = s - f; total += f;
+    }
+    // hand the leftover units to the largest remainders (ties: lower influence first)
+    for (; total < 255; ++total) {
+        int best = 0;
+        for (int i = 1; i < 4; ++i) if (frac[i] > frac[best]) best = i;
+        q[best]++; frac[best] = -1.0f;
+    }
+}
+
+JointFormat ChooseJointFormat(const VertexIn* vertices, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        for (uint32_t j : vertices[i].boneIdx) if (j > 0xFF) return JointFormat::U16;
+    return JointFormat::U8;
+}
+
+PackedVertices PackMeshletVertices(const MeshletMesh& mesh, JointFormat joints) {
+    PackedVertices out;
+    out.joints = joints == JointFormat::Auto ? ChooseJointFormat(mesh.vertices.data(), mesh.vertices.size()) : joints;
+    out.strideWords = out.joints == JointFormat::U16 ? 6 : 5;
+    out.words.assign(mesh.vertices.size() * out.strideWords, 0);
+    out.quant.resize(mesh.meshlets.size());
+
+    for (size_t mi = 0; mi < mesh.meshlets.size(); ++mi) {
+        const MeshletData& m = mesh.meshlets[mi];
+        if (size_t(m.vOffset) + m.vCount > mesh.vertices.size()) throw std::runtime_error("Meshlet vertex range out of bounds");
+        float lo[3] = { INFINITY, INFINITY, INFINITY }, hi[3] = { -INFINITY, -INFINITY, -INFINITY };
+        for (uint32_t v = 0; v < m.vCount; ++v)
+            for (int a = 0; a < 3; ++a) {
+                lo[a] = std::min(lo[a], mesh.vertices[m.vOffset + v].pos[a]);
+                hi[a] = std::max(hi[a], mesh.vertices[m.vOffset + v].pos[a]);
+            }
+        MeshletQuant& mq = out.quant[mi];
+        for (int a = 0; a < 3; ++a) {
+            mq.boundsMin[a] = m.vCount ? lo[a] : 0.0f;
+            mq.boundsScale[a] = m.vCount ? (hi[a] - lo[a]) / 65535.0f : 0.0f;
+        }
+
+        for (uint32_t v = 0; v < m.vCount; ++v) {
+            const VertexIn& vin = mesh.vertices[m.vOffset + v];
+            uint32_t* w = &out.words[size_t(m.vOffset + v) * out.strideWords];
+            uint32_t q[3];
+            for (int a = 0; a < 3; ++a)
+                q[a] = mq.boundsScale[a] > 0.0f
+                     ? uint32_t(std::clamp(std::lround((vin.pos[a] - mq.boundsMin[a]) / mq.boundsScale[a]), 0L, 65535L)) : 0u;
+            uint16_t oct[2]; OctEncode(vin.nrm, oct);
+            uint8_t wq[4]; QuantizeWeights(vin.boneWgt, wq);
+            w[0] = q[0] | q[1] << 16;
+            w[1] = q[2] | uint32_t(oct[0]) << 16;
+            w[2] = oct[1];
+            w[3] = wq[0] | wq[1] << 8 | wq[2] << 16 | uint32_t(wq[3]) << 24;
+            if (out.joints == JointFormat::U8) {
+                for (uint32_t j : vin.boneIdx) if (j > 0xFF) throw std::runtime_error("Joint index does not fit JointFormat::U8");
+                w[4] = vin.boneIdx[0] | vin.boneIdx[1] << 8 | vin.boneIdx[2] << 16 | vin.boneIdx[3] << 24;
+            } else {
+                for (uint32_t j : vin.boneIdx) if (j > 0xFFFF) throw std::runtime_error("Joint index does not fit JointFormat::U16");
+                w[4] = vin.boneIdx[0] | vin.boneIdx[1] << 16;
+                w[5] = vin.boneIdx[2] | vin.boneIdx[3] << 16;
+            }
+        }
+    }
+    return out;
+}
+
+void UnpackMeshletVertices(const PackedVertices& packed, const std::vector<MeshletData>& meshlets,
+                           std::vector<VertexIn>& out) {
+    if (meshlets.size() != packed.quant.size()) throw std::runtime_error("Packed vertices do not match meshlets");
+    out.resize(packed.VertexCount());
+    for (size_t mi = 0; mi < meshlets.size(); ++mi) {
+        const MeshletData& m = meshlets[mi];
+        const MeshletQuant& mq = packed.quant[mi];
+        if (size_t(m.vOffset) + m.vCount > out.size()) throw std::runtime_error("Meshlet vertex range out of bounds");
+        for (uint32_t v = 0; v < m.vCount; ++v) {
+            const uint32_t* w = &packed.words[size_t(m.vOffset + v) * packed.strideWords];
+            VertexIn& vo = out[m.vOffset + v];
+            const uint32_t q[3] = { w[0] & 0xFFFF, w[0] >> 16, w[1] & 0xFFFF };
+            for (int a = 0; a < 3; ++a) vo.pos[a] = mq.boundsMin[a] + float(q[a]) * mq.boundsScale[a];
+            const uint16_t oct[2] = { uint16_t(w[1] >> 16), uint16_t(w[2]) };
+            OctDecode(oct, vo.nrm);
+            for (int i = 0; i < 4; ++i) vo.boneWgt[i] = float((w[3] >> (8 * i)) & 0xFF) / 255.0f;
+            for (int i = 0; i < 4; ++i)
+                vo.boneIdx[i] = packed.joints == JointFormat::U8 ? (w[4] >> (8 * i)) & 0xFF : (w[4 + i / 2] >> (16 * (i & 1))) & 0xFFFF;
+        }
+    }
+}
+
+VertexPackError MeasureVertexPackError(const MeshletMesh& mesh, const PackedVertices& packed) {
+    std::vector<VertexIn> decoded;
+    UnpackMeshletVertices(packed, mesh.meshlets, decoded);
+    VertexPackError e;
+    for (const MeshletQuant& mq : packed.quant)
+        for (float s : mq.boundsScale) e.positionBound = std::max(e.positionBound, 0.5f * s);
+    double maxAngle = 0.0;
+    for (size_t i = 0; i < decoded.size() && i < mesh.vertices.size(); ++i) {
+        const VertexIn& a = mesh.vertices[i]; const VertexIn& b = decoded[i];
+        for (int k = 0; k < 3; ++k) e.position = std::max(e.position, std::fabs(a.pos[k] - b.pos[k]));
+        // atan2(|a x b|, a.b): acos is too ill-conditioned near 0 degrees to measure oct16 error
+        const double cx = double(a.nrm[1])*b.nrm[2] - double(a.nrm[2])*b.nrm[1];
+        const double cy = double(a.nrm[2])*b.nrm[0] - double(a.nrm[0])*b.nrm[2];
+        const double cz = double(a.nrm[0])*b.nrm[1] - double(a.nrm[1])*b.nrm[0];
+        const double dot = double(a.nrm[0])*b.nrm[0] + double(a.nrm[1])*b.nrm[1] + double(a.nrm[2])*b.nrm[2];
+        if (a.nrm[0] != 0 || a.nrm[1] != 0 || a.nrm[2] != 0) maxAngle = std::max(maxAngle, std::atan2(std::sqrt(cx*cx + cy*cy + cz*cz), dot));
+        float sum = 0;
+        for (float w : a.boneWgt) sum += std::max(w, 0.0f);
+        for (int k = 0; k < 4; ++k) {
+            const float ref = sum > 0 ? std::max(a.boneWgt[k], 0.0f) / sum : (k == 0 ? 1.0f : 0.0f);
+            e.weight = std::max(e.weight, std::fabs(ref - b.boneWgt[k]));
+            e.jointMismatches += a.boneWgt[k] > 0 && a.boneIdx[k] != b.boneIdx[k];
+        }
+    }
+    e.normalDegrees = float(maxAngle * 180.0 / 3.14159265358979323846);
+    return e;
+}
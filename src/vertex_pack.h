@@ -0,0 +1,55 @@
+#pragma once
+// Packed vertex layout for MSMain (compiled with PACKED_VERTICES): 20 or 24 bytes per vertex
+// instead of VertexIn's 56. One uint32 word stream, `strideWords` words per vertex:
+//
+//   w0  pos.x | pos.y << 16     unorm16 over the meshlet's bounds (MeshletQuant)
+//   w1  pos.z | oct.x << 16     normal: octahedral snorm16
+//   w2  oct.y                   upper 16 bits reserved (zero)
+//   w3  weights 4 x unorm8      the four bytes always sum to exactly 255
+//   w4  joints 4 x u8           JointFormat::U8
+//   w4, w5  joints 2 x u16 each JointFormat::U16 (PACKED_JOINTS16)
+//
+// Vertices keep the MeshletMesh order, so MeshletData::vOffset indexes them unchanged.
+// Error: positions within half a step of (meshlet extent / 65535), normals within ~0.01 degrees,
+// weights within 1/255 of the normalized source.
+
+#include "mesh_types.h"
+#include "meshlet.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class JointFormat : uint8_t { Auto, U8, U16 };
+
+struct PackedVertices {
+    JointFormat joints = JointFormat::U8;
+    uint32_t strideWords = 5;
+    std::vector<uint32_t> words;       // strideWords per vertex
+    std::vector<MeshletQuant> quant;   // one per meshlet
+    size_t VertexCount() const { return strideWords ? words.size() / strideWords : 0; }
+    size_t BytesPerVertex() const { return strideWords * sizeof(uint32_t); }
+};
+
+// Octahedral snorm16 normal encoding; the encoder picks the best of the four rounding neighbours.
+void OctEncode(const float n[3], uint16_t oct[2]);
+void OctDecode(const uint16_t oct[2], float n[3]);
+// Normalizes and rounds to unorm8 with the largest-remainder method so the result sums to 255.
+// All-zero weights bind fully to the first influence.
+void QuantizeWeights(const float w[4], uint8_t q[4]);
+
+// U8 when every joint index fits in 8 bits (always true for meshlet-local indices with maxBones <= 256).
+JointFormat ChooseJointFormat(const VertexIn* vertices, size_t count);
+
+PackedVertices PackMeshletVertices(const MeshletMesh& mesh, JointFormat joints = JointFormat::Auto);
+void UnpackMeshletVertices(const PackedVertices& packed, const std::vector<MeshletData>& meshlets,
+                           std::vector<VertexIn>& out);
+
+struct VertexPackError {
+    float position = 0;        // max absolute per-axis error, in mesh units
+    float positionBound = 0;   // theoretical max (half a quantization step of the largest meshlet)
+    float normalDegrees = 0;   // max angle between source and decoded normal
+    float weight = 0;          // max |decoded - normalized source| weight
+    size_t jointMismatches = 0;// decoded joint != source joint where the source weight > 0
+};
+VertexPackError MeasureVertexPackError(const MeshletMesh& mesh, const PackedVertices& packed);
@@ -0,0 +1,151 @@
+#include "animation.h"
+#include "bench_common.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// One-bone clip; AddTrack appends a Float track over its own times.
+static AnimationClip OneBoneClip() {
+    AnimationClip clip; clip.name = "test"; clip.boneCount = 1;
+    return clip;
+}
+
+static void AddTrack(AnimationClip& clip, AnimPath path, AnimInterp interp, const std::vector<float>& times,
+                     const std::vector<float>& values) {
+    AnimTrack tr{};
+    tr.slot = 0; tr.path = uint8_t(path); tr.interp = uint8_t(interp); tr.encoding = uint8_t(TrackEncoding::Float);
+    tr.comps = path == AnimPath::Rotation ? 4 : 3; tr.keyCount = uint32_t(times.size());
+    tr.timeOffset = uint32_t(clip.times.size()); tr.valueOffset = uint32_t(clip.values.size());
+    clip.times.insert(clip.times.end(), times.begin(), times.end());
+    clip.values.insert(clip.values.end(), values.begin(), values.end());
+    clip.tracks.push_back(tr);
+    clip.duration = std::max(clip.duration, times.back());
+}
+
+static std::vector<float> Translation(const AnimationClip& clip, float time, ClipSampler& sampler) {
+    float local[16];
+    SampleClip(ViewOf(clip), time, sampler, local);
+    return { sampler.translation.begin(), sampler.translation.begin() + 3 };
+}
+
+static std::vector<float> Translation(const AnimationClip& clip, float time) {
+    ClipSampler sampler;
+    return Translation(clip, time, sampler);
+}
+
+TEST(Animation, StepHoldsTheKeyAtOrBeforeTheTime) {
+    AnimationClip clip = OneBoneClip();
+    AddTrack(clip, AnimPath::Translation, AnimInterp::Step, { 0.0f, 1.0f, 3.0f }, { 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    const std::vector<float> k0 = { 1, 2, 3 }, k1 = { 4, 5, 6 }, k2 = { 7, 8, 9 };
+    EXPECT_EQ(Translation(clip, -1.0f), k0);
+    EXPECT_EQ(Translation(clip, 0.5f), k0);
+    EXPECT_EQ(Translation(clip, 1.0f), k1);
+    EXPECT_EQ(Translation(clip, 2.9f), k1);
+    EXPECT_EQ(Translation(clip, 3.0f), k2);
+    EXPECT_EQ(Translation(clip, 5.0f), k2);
+}
+
+TEST(Animation, LinearInterpolatesAndSlerps) {
+    AnimationClip clip = OneBoneClip();
+    AddTrack(clip, AnimPath::Translation, AnimInterp::Linear, { 0.0f, 1.0f, 3.0f }, { 0, 0, 0, 4, -4, 8, 8, 0, 8 });
+    const float s = std::sin(0.25f * 3.14159265f), c = std::cos(0.25f * 3.14159265f); // 90 degrees about Z
+    AddTrack(clip, AnimPath::Rotation, AnimInterp::Linear, { 0.0f, 1.0f }, { 0, 0, 0, 1, 0, 0, s, c });
+    ClipSampler sampler;
+    const std::vector<float> t = Translation(clip, 0.25f, sampler);
+    EXPECT_NEAR(t[0], 1.0f, 1e-6f); EXPECT_NEAR(t[1], -1.0f, 1e-6f); EXPECT_NEAR(t[2], 2.0f, 1e-6f);
+    const float* q = sampler.rotation.data(); // a quarter of the way: 22.5 degrees about Z
+    EXPECT_NEAR(q[2], std::sin(0.0625f * 3.14159265f), 1e-5f);
+    EXPECT_NEAR(q[3], std::cos(0.0625f * 3.14159265f), 1e-5f);
+    const std::vector<float> m = Translation(clip, 2.0f);
+    EXPECT_NEAR(m[0], 6.0f, 1e-6f); EXPECT_NEAR(m[1], -2.0f, 1e-6f); EXPECT_NEAR(m[2], 8.0f, 1e-6f);
+}
+
+// Hermite over [0, 2]: p(u) = h00 p0 + h10 td m0 + h01 p1 + h11 td m1.
+TEST(Animation, CubicSplineUsesScaledTangents) {
+    AnimationClip clip = OneBoneClip();
+    // keys are (in-tangent, value, out-tangent); only x moves
+    AddTrack(clip, AnimPath::Translation, AnimInterp::CubicSpline, { 0.0f, 2.0f },
+             { 9, 0, 0,  1, 0, 0,  2, 0, 0,     4, 0, 0,  3, 0, 0,  9, 0, 0 });
+    EXPECT_NEAR(Translation(clip, 0.0f)[0], 1.0f, 1e-6f);
+    EXPECT_NEAR(Translation(clip, 2.0f)[0], 3.0f, 1e-6f);
+    // u = 0.5: h00 = 0.5, h10 = 0.125 * 2, h01 = 0.5, h11 = -0.125 * 2
+    EXPECT_NEAR(Translation(clip, 1.0f)[0], 0.5f * 1 + 0.25f * 2 + 0.5f * 3 - 0.25f * 4, 1e-6f);
+    // u = 0.25: h00 = 0.84375, h10 = 0.140625 * 2, h01 = 0.15625, h11 = -0.046875 * 2
+    EXPECT_NEAR(Translation(clip, 0.5f)[0], 0.84375f * 1 + 0.28125f * 2 + 0.15625f * 3 - 0.09375f * 4, 1e-6f);
+}
+
+// Linear x over irregular key times, with the key found by std::upper_bound.
+static float ReferenceX(const std::vector<float>& times, const std::vector<float>& x, float t) {
+    const size_t n = times.size();
+    const size_t ub = size_t(std::upper_bound(times.begin(), times.end(), t) - times.begin());
+    const size_t k = std::min(ub ? ub - 1 : 0, n - 2);
+    const float u = std::clamp((t - times[k]) / (times[k + 1] - times[k]), 0.0f, 1.0f);
+    return x[k] + (x[k + 1] - x[k]) * u;
+}
+
+TEST(Animation, CachedCursorMatchesBinarySearch) {
+    BenchRng rng;
+    std::vector<float> times, x, values;
+    float t = 0.0f;
+    for (int k = 0; k < 64; ++k) {
+        times.push_back(t); t += rng.Uniform(0.01f, 0.2f);
+        x.push_back(rng.Uniform(-1.0f, 1.0f));
+        values.insert(values.end(), { x.back(), 0.0f, 0.0f });
+    }
+    AnimationClip clip = OneBoneClip();
+    AddTrack(clip, AnimPath::Translation, AnimInterp::Linear, times, values);
+    const float duration = times.back();
+
+    std::vector<std::pair<const char*, std::vector<float>>> playbacks(4);
+    playbacks[0].first = "forward"; playbacks[1].first = "backward"; playbacks[2].first = "wrapping"; playbacks[3].first = "seeking";
+    for (float p = -0.1f; p < duration + 0.1f; p += 0.013f) playbacks[0].second.push_back(p);
+    for (float p = duration + 0.1f; p > -0.1f; p -= 0.013f) playbacks[1].second.push_back(p);
+    for (float p = 0.0f; p < 4.0f * duration; p += 0.021f) playbacks[2].second.push_back(std::fmod(p, duration));
+    for (int i = 0; i < 500; ++i) playbacks[3].second.push_back(rng.Uniform(-0.1f, duration + 0.1f));
+    for (const auto& [name, sequence] : playbacks) {
+        ClipSampler sampler;
+        for (float p : sequence)
+            ASSERT_NEAR(Translation(clip, p, sampler)[0], ReferenceX(times, x, p), 1e-5f) << name << " playback at " << p;
+    }
+}
+
+TEST(Animation, Quant16StaysWithinTheDocumentedBound) {
+    BenchRng rng;
+    AnimationClip clip = OneBoneClip();
+    std::vector<float> times, values;
+    for (int k = 0; k < 32; ++k) {
+        times.push_back(0.1f * float(k));
+        for (int c = 0; c < 3; ++c) values.push_back(rng.Uniform(-5.0f, 5.0f) * float(c + 1));
+    }
+    AddTrack(clip, AnimPath::Translation, AnimInterp::Linear, times, values);
+    const AnimationClip compressed = CompressClip(clip);
+    ASSERT_EQ(compressed.tracks[0].encoding, uint8_t(TrackEncoding::Quant16));
+    ClipSampler a, b;
+    for (float t = 0.0f; t <= clip.duration; t += 0.007f) {
+        const std::vector<float> ref = Translation(clip, t, a), q = Translation(compressed, t, b);
+        for (int c = 0; c < 3; ++c) {
+            const float bound = compressed.tracks[0].rangeExtent[c] / 131070.0f + 1e-6f * (1.0f + std::fabs(ref[c]));
+            ASSERT_LE(std::fabs(q[c] - ref[c]), bound) << "component " << c << " at " << t;
+        }
+    }
+}
+
+TEST(Animation, ConstantTracksAreElidedToTheirValue) {
+    AnimationClip clip = OneBoneClip();
+    AddTrack(clip, AnimPath::Translation, AnimInterp::Linear, { 0.0f, 1.0f, 2.0f }, { 1, 2, 3, 1, 2, 3, 1, 2, 3 });
+    AddTrack(clip, AnimPath::Scale, AnimInterp::CubicSpline, { 0.0f, 2.0f },
+             { 0, 0, 0, 2, 2, 2, 0, 0, 0,   0, 0, 0, 2, 2, 2, 0, 0, 0 });
+    AddTrack(clip, AnimPath::Rotation, AnimInterp::Linear, { 0.0f, 2.0f }, { 0, 0, 0, 1, 0, 0, 0.1f, 0.995f });
+    const AnimationClip compressed = CompressClip(clip);
+    EXPECT_EQ(compressed.tracks[0].encoding, uint8_t(TrackEncoding::Constant));
+    EXPECT_EQ(compressed.tracks[1].encoding, uint8_t(TrackEncoding::Constant));
+    EXPECT_NE(compressed.tracks[2].encoding, uint8_t(TrackEncoding::Constant)) << "a moving track was elided";
+    ClipSampler sampler;
+    for (float t : { -1.0f, 0.0f, 0.7f, 2.0f, 3.0f }) {
+        EXPECT_EQ(Translation(compressed, t, sampler), std::vector<float>({ 1, 2, 3 })) << "at " << t;
+        EXPECT_EQ(std::vector<float>(sampler.scale.begin(), sampler.scale.end()), std::vector<float>({ 2, 2, 2 })) << "at " << t;
+    }
+}
@@ -0,0 +1,169 @@
+#include "asset_streamer.h"
+#include "crowd.h"
+#include "stream_fixture.h"
+#include "thread_pool.h"
+#include "vertex_pack.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+static const StreamFixture& Fixture() {
+    static const StreamFixture f("grfx_tests_stream");
+    return f;
+}
+
+static std::vector<AssetStreamer::Request> Batch(uint32_t count) {
+    std::vector<AssetStreamer::Request> batch;
+    for (uint32_t i = 0; i < count; ++i) batch.push_back({ Fixture().rawPaths[i], int32_t((i * 5) % count) });
+    return batch;
+}
+
+// Takes one asset at a time and releases it at once, keeping the handed-off assets.
+static std::vector<StreamedAsset> TakeAll(AssetStreamer& streamer, size_t expected) {
+    std::vector<StreamedAsset> kept;
+    while (kept.size() < expected) {
+        std::vector<StreamedAsset> done = streamer.TakeCompleted(1);
+        if (done.empty()) { std::this_thread::yield(); continue; }
+        for (StreamedAsset& a : done) { streamer.Release(a); kept.push_back(std::move(a)); }
+    }
+    return kept;
+}
+
+TEST(AssetStreamer, AdmitsAndHandsOffByPriority) {
+    const StreamFixture& f = Fixture();
+    ThreadPool pool(2);
+    constexpr uint32_t kN = 8;
+    const std::vector<AssetStreamer::Request> batch = Batch(kN);
+    std::mutex m; std::vector<std::string> order;
+    AssetStreamerOptions o; o.maxInFlight = 1;
+    const AssetDecoder raw = f.RawDecoder();
+    o.decode = [&](const std::vector<uint8_t>& b, const std::string& p, tinygltf::Model& model, std::string& e) {
+        { std::lock_guard<std::mutex> lock(m); order.push_back(p); }
+        return raw(b, p, model, e);
+    };
+    AssetStreamer s(pool, o);
+    s.Load(batch);
+    s.WaitIdle();
+    ASSERT_EQ(order.size(), kN);
+    for (uint32_t i = 0; i < kN; ++i) {
+        const auto it = std::find_if(batch.begin(), batch.end(), [&](const auto& r) { return r.path == order[i]; });
+        EXPECT_EQ(it->priority, int32_t(kN - 1 - i)) << "decode " << i;
+    }
+    const std::vector<StreamedAsset> done = s.TakeCompleted();
+    ASSERT_EQ(done.size(), kN);
+    for (size_t i = 1; i < done.size(); ++i) EXPECT_LE(done[i].priority, done[i - 1].priority);
+}
+
+TEST(AssetStreamer, CancelsRunningAndQueuedAssets) {
+    const StreamFixture& f = Fixture();
+    ThreadPool pool(2);
+    constexpr uint32_t kN = 8;
+    AssetStreamerOptions o; o.maxInFlight = 1;
+    const AssetDecoder raw = f.RawDecoder();
+    AssetStreamer* self = nullptr; std::atomic<bool> first{true};
+    o.decode = [&](const std::vector<uint8_t>& b, const std::string& p, tinygltf::Model& model, std::string& e) {
+        if (first.exchange(false)) for (AssetId id : { 1, 3, 5, 7 }) self->Cancel(id); // the first is running
+        return raw(b, p, model, e);
+    };
+    AssetStreamer s(pool, o); self = &s;
+    std::vector<AssetStreamer::Request> same = Batch(kN);
+    for (auto& r : same) r.priority = 0;
+    const std::vector<AssetId> ids = s.Load(same);
+    EXPECT_EQ(ids.front(), 1u);
+    s.WaitIdle();
+    const std::vector<StreamedAsset> done = s.TakeCompleted();
+    const AssetStreamerStats st = s.Stats();
+    EXPECT_EQ(done.size(), kN / 2);
+    EXPECT_EQ(st.cancelled, kN / 2);
+    for (const StreamedAsset& a : done) {
+        EXPECT_EQ(a.id % 2, 0u);
+        EXPECT_TRUE(a.error.empty()) << a.error;
+    }
+    EXPECT_EQ(st.inFlight, 0u);
+    EXPECT_EQ(st.queued, 0u);
+}
+
+// Includes a budget smaller than any single asset, which stages one asset at a time.
+TEST(AssetStreamer, StagingStaysWithinBudget) {
+    const StreamFixture& f = Fixture();
+    ThreadPool pool(2);
+    for (uint64_t budget : { uint64_t(1), uint64_t(1) << 20 }) {
+        AssetStreamerOptions o; o.stagingBudget = budget; o.decode = f.RawDecoder();
+        AssetStreamer s(pool, o);
+        std::vector<AssetStreamer::Request> many;
+        for (uint32_t i = 0; i < 64; ++i) many.push_back({ f.rawPaths[i], 0 });
+        s.Load(many);
+        const std::vector<StreamedAsset> kept = TakeAll(s, many.size());
+        uint64_t largest = 0;
+        for (const StreamedAsset& a : kept) largest = std::max(largest, a.Range(StagedBuffer::Bounds).offset + a.Range(StagedBuffer::Bounds).size);
+        const AssetStreamerStats st = s.Stats();
+        EXPECT_EQ(st.completed, many.size()) << "budget " << budget;
+        EXPECT_EQ(st.stagingBytes, 0u) << "budget " << budget;
+        EXPECT_LE(st.peakStagingBytes, std::max(budget, largest + kStagingAlignment)) << "budget " << budget;
+    }
+}
+
+TEST(AssetStreamer, StagedBuffersMatchDirectBuild) {
+    const StreamFixture& f = Fixture();
+    ThreadPool pool(2);
+    AssetStreamerOptions o; o.decode = f.RawDecoder();
+    AssetStreamer s(pool, o);
+    s.Load(f.rawPaths[3]);
+    s.WaitIdle();
+    std::vector<StreamedAsset> done = s.TakeCompleted();
+    ASSERT_EQ(done.size(), 1u);
+    ASSERT_TRUE(done[0].error.empty()) << done[0].error;
+
+    std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    const tinygltf::Model& model = f.variants[3];
+    ReadPrimitiveVertices(model, model.meshes[0].primitives[0], verts, indices);
+    const MeshletMesh mesh = BuildMeshlets(verts, indices);
+    const PackedVertices packed = PackMeshletVertices(mesh);
+    const std::vector<MeshletBounds> bounds = ComputeMeshletBounds(mesh);
+    const StreamedAsset& a = done[0];
+    auto same = [&](StagedBuffer b, const auto& v) {
+        const StagingRange& r = a.Range(b);
+        return r.size == v.size() * sizeof(v[0]) && (!r.size || memcmp(a.staging.data() + r.offset, v.data(), size_t(r.size)) == 0);
+    };
+    EXPECT_TRUE(same(StagedBuffer::Vertices, packed.words));
+    EXPECT_TRUE(same(StagedBuffer::Quant, packed.quant));
+    EXPECT_TRUE(same(StagedBuffer::Triangles, mesh.triangles));
+    EXPECT_TRUE(same(StagedBuffer::Meshlets, mesh.meshlets));
+    EXPECT_TRUE(same(StagedBuffer::BoneRemap, mesh.boneRemap));
+    EXPECT_TRUE(same(StagedBuffer::Bounds, bounds));
+    EXPECT_EQ(a.skeleton.BoneCount(), kStreamVariants[3].bones);
+    s.Release(done[0]);
+}
+
+TEST(AssetStreamer, ReleasingTwiceCountsOnce) {
+    ThreadPool pool(2);
+    AssetStreamerOptions o; o.decode = Fixture().RawDecoder();
+    AssetStreamer s(pool, o);
+    s.Load(Fixture().rawPaths[0]);
+    s.WaitIdle();
+    std::vector<StreamedAsset> done = s.TakeCompleted();
+    ASSERT_EQ(done.size(), 1u);
+    s.Release(done[0]);
+    EXPECT_EQ(done[0].id, 0u);
+    s.Release(done[0]);
+    const AssetStreamerStats st = s.Stats();
+    EXPECT_EQ(st.released, 1u);
+    EXPECT_EQ(st.stagingBytes, 0u);
+}
+
+TEST(AssetStreamer, MissingFileFails) {
+    ThreadPool pool(2);
+    AssetStreamer s(pool);
+    s.Load((Fixture().dir / "missing.glb").string());
+    s.WaitIdle();
+    const std::vector<StreamedAsset> done = s.TakeCompleted();
+    ASSERT_EQ(done.size(), 1u);
+    EXPECT_FALSE(done[0].error.empty());
+    EXPECT_TRUE(done[0].staging.empty());
+    EXPECT_EQ(s.Stats().failed, 1u);
+}
@@ -0,0 +1,133 @@
+#include "bench_common.h"
+#include "bone_palette.h"
+#include "mat4.h"
+#include "skeleton.h"
+#include "synthetic_rig.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static constexpr PaletteFormat kFormats[] = { PaletteFormat::Mat4x4, PaletteFormat::Mat3x4, PaletteFormat::DualQuat };
+static constexpr uint32_t kBones = 64;
+
+static std::vector<float> Encode(PaletteFormat format, const std::vector<float>& skinning) {
+    std::vector<float> out(skinning.size() / 16 * PaletteFloats(format));
+    EncodePalette(format, skinning.data(), skinning.size() / 16, out.data());
+    return out;
+}
+
+static float MaxDiff3(const float* a, const float* b) {
+    return std::max({ std::fabs(a[0] - b[0]), std::fabs(a[1] - b[1]), std::fabs(a[2] - b[2]) });
+}
+
+// Largest position/normal difference between every format and the 4x4 path.
+static float MaxDiffToLbs(const std::vector<float>& skinning, const std::vector<VertexIn>& verts) {
+    std::vector<float> encoded[3];
+    for (PaletteFormat f : kFormats) encoded[uint32_t(f)] = Encode(f, skinning);
+    float worst = 0.0f;
+    for (const VertexIn& v : verts) {
+        float refP[3], refN[3];
+        SkinVertexReference(PaletteFormat::Mat4x4, encoded[0].data(), v, refP, refN);
+        for (PaletteFormat f : kFormats) {
+            float p[3], n[3];
+            SkinVertexReference(f, encoded[uint32_t(f)].data(), v, p, n);
+            worst = std::max({ worst, MaxDiff3(p, refP), MaxDiff3(n, refN) });
+        }
+    }
+    return worst;
+}
+
+static std::vector<VertexIn> UnitNormalVertices(BenchRng& rng) {
+    std::vector<VertexIn> verts = MakeRandomSkinnedVertices(4096, kBones, rng);
+    for (VertexIn& v : verts) {
+        const float len = std::sqrt(v.nrm[0]*v.nrm[0] + v.nrm[1]*v.nrm[1] + v.nrm[2]*v.nrm[2]) + 1e-6f;
+        for (float& c : v.nrm) c /= len;
+    }
+    return verts;
+}
+
+TEST(BonePalette, DecodedEntriesMatchSkinningMatrices) {
+    BenchRng rng;
+    const std::vector<float> skinning = MakeRandomPalette(kBones, rng);
+    for (PaletteFormat f : kFormats) {
+        const std::vector<float> encoded = Encode(f, skinning);
+        for (uint32_t b = 0; b < kBones; ++b) {
+            float m[16]; DecodePaletteEntry(f, &encoded[size_t(b) * PaletteFloats(f)], m);
+            for (int e = 0; e < 16; ++e)
+                ASSERT_NEAR(m[e], skinning[size_t(b) * 16 + e], 1e-4f) << PaletteFormatName(f) << " bone " << b;
+        }
+    }
+}
+
+TEST(BonePalette, SingleInfluenceSkinsLikeLbs) {
+    BenchRng rng;
+    const std::vector<float> skinning = MakeRandomPalette(kBones, rng);
+    std::vector<VertexIn> single = UnitNormalVertices(rng);
+    for (VertexIn& v : single) { v.boneWgt[0] = 1.0f; v.boneWgt[1] = v.boneWgt[2] = v.boneWgt[3] = 0.0f; }
+    EXPECT_LE(MaxDiffToLbs(skinning, single), 1e-4f);
+}
+
+// Every bone carries the same rigid transform: blending is exact in every format.
+TEST(BonePalette, RigidMultiInfluenceSkinsLikeLbs) {
+    BenchRng rng;
+    const std::vector<float> skinning = MakeRandomPalette(kBones, rng);
+    const std::vector<VertexIn> verts = UnitNormalVertices(rng);
+    std::vector<float> rigid(skinning.size());
+    for (uint32_t b = 0; b < kBones; ++b) memcpy(&rigid[size_t(b) * 16], skinning.data(), 16 * sizeof(float));
+    EXPECT_LE(MaxDiffToLbs(rigid, verts), 1e-4f);
+}
+
+// Candy wrapper: half-way between identity and a 170 degree twist about the bone axis (Y).
+TEST(BonePalette, DualQuatKeepsTwistRadius) {
+    std::vector<float> twist(32, 0.0f);
+    Mat4Identity(&twist[0]); Mat4Identity(&twist[16]);
+    const float a = 170.0f * 3.14159265f / 180.0f;
+    twist[16] = std::cos(a); twist[18] = -std::sin(a); twist[24] = std::sin(a); twist[26] = std::cos(a);
+    VertexIn v{}; v.pos[0] = 1.0f; v.nrm[0] = 1.0f;
+    v.boneIdx[1] = 1; v.boneWgt[0] = v.boneWgt[1] = 0.5f;
+    float lbsP[3], dqP[3], n[3];
+    SkinVertexReference(PaletteFormat::Mat4x4, twist.data(), v, lbsP, n);
+    const std::vector<float> dq = Encode(PaletteFormat::DualQuat, twist);
+    SkinVertexReference(PaletteFormat::DualQuat, dq.data(), v, dqP, n);
+    EXPECT_NEAR(std::hypot(dqP[0], dqP[2]), 1.0f, 1e-4f);
+    EXPECT_LT(std::hypot(lbsP[0], lbsP[2]), 0.5f) << "LBS did not collapse; the twist is not exercising anything";
+}
+
+// A posed synthetic rig: EncodeSkinPalette matches EncodePalette of global * inverseBind per bone,
+// and of EvaluateSkeleton's palette-ordered skinning matrices.
+TEST(BonePalette, SkinPaletteMatchesSkinningMatrices) {
+    BenchRng rng;
+    const tinygltf::Model model = MakeSyntheticRig({ "palette", 48, 1 << 10 }, rng);
+    Skin skin = BuildSkin(model, 0);
+    SkeletonLayout layout = BuildSkeletonLayout(skin);
+    ReadRestPose(model, layout);
+    const size_t n = layout.BoneCount();
+    ASSERT_EQ(n, skin.bones.size());
+    std::vector<float> local(layout.restLocal), global(n * 16), skinning(n * 16);
+    for (size_t s = 0; s < n; ++s) {
+        const float a = rng.Uniform(-1.0f, 1.0f), q[4] = { std::sin(0.5f * a), 0.0f, 0.0f, std::cos(0.5f * a) };
+        const float t[3] = { 0.0f, 0.0f, 0.0f }, one[3] = { 1.0f, 1.0f, 1.0f };
+        float r[16], posed[16]; ComposeTRS(t, q, one, r);
+        Mat4Mul(&local[s * 16], r, posed);
+        memcpy(&local[s * 16], posed, sizeof(posed));
+    }
+    EvaluateSkeleton(layout, local.data(), global.data(), skinning.data());
+    StoreGlobalMatrices(layout, global.data(), skin);
+
+    for (PaletteFormat f : kFormats) {
+        const size_t stride = PaletteFloats(f);
+        std::vector<float> encoded(n * stride), expected(n * stride);
+        EncodeSkinPalette(skin, f, encoded.data());
+        for (size_t b = 0; b < n; ++b) {
+            float m[16]; Mat4Mul(skin.bones[b].globalMatrix, skin.bones[b].inverseBind, m);
+            EncodePalette(f, m, 1, &expected[b * stride]);
+        }
+        EXPECT_EQ(encoded, expected) << PaletteFormatName(f);
+        const std::vector<float> evaluated = Encode(f, skinning);
+        for (size_t e = 0; e < encoded.size(); ++e)
+            ASSERT_NEAR(encoded[e], evaluated[e], 1e-4f) << PaletteFormatName(f) << " bone " << e / stride;
+    }
+}
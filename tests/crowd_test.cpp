@@ -0,0 +1,79 @@
+#include "crowd.h"
+#include "crowd_fixture.h"
+#include "thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+static const CrowdFixture& Crowd() {
+    static const CrowdFixture f(16, 6);
+    return f;
+}
+
+TEST(Crowd, MeshletSpheresContainTheirVertices) {
+    const CrowdFixture& f = Crowd();
+    for (size_t mi = 0; mi < f.mesh.meshlets.size(); ++mi) {
+        const MeshletData& m = f.mesh.meshlets[mi]; const MeshletBounds& b = f.bounds[mi];
+        for (uint32_t v = 0; v < m.vCount; ++v) {
+            const float* p = f.mesh.vertices[m.vOffset + v].pos;
+            const float d[3] = { p[0] - b.center[0], p[1] - b.center[1], p[2] - b.center[2] };
+            ASSERT_LE(std::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]), b.radius * 1.0001f + 1e-6f) << "meshlet " << mi;
+        }
+    }
+}
+
+// No culled meshlet has a triangle that is both inside the frustum and front-facing once fully
+// skinned.
+TEST(Crowd, CullIsConservativeForSkinnedTriangles) {
+    const CrowdFixture& f = Crowd();
+    const CullView& view = f.view;
+    size_t culled = 0;
+    std::vector<float> skinned;
+    for (const InstanceData& inst : f.instances)
+        for (size_t mi = 0; mi < f.mesh.meshlets.size(); ++mi) {
+            const MeshletData& m = f.mesh.meshlets[mi];
+            float toWorld[16]; Mat4Mul(inst.world, f.Bone(inst, m, f.bounds[mi].dominantBone), toWorld);
+            const CullResult result = CullMeshlet(view, f.bounds[mi], toWorld, inst.boundsPadding);
+            if (result == CullResult::Visible) continue;
+            ++culled;
+            skinned.resize(size_t(m.vCount) * 3);
+            for (uint32_t v = 0; v < m.vCount; ++v) f.Skin(inst, m, f.mesh.vertices[m.vOffset + v], &skinned[size_t(v) * 3]);
+            for (uint32_t t = 0; t < m.pCount; ++t) {
+                const MeshletTriangle& tri = f.mesh.triangles[m.pOffset + t];
+                const float* a = &skinned[tri.x * 3]; const float* p1 = &skinned[tri.y * 3]; const float* p2 = &skinned[tri.z * 3];
+                if (result == CullResult::Frustum) {
+                    bool outside = false;
+                    for (int pl = 0; pl < 6 && !outside; ++pl) {
+                        auto dist = [&](const float* q) { return view.frustum[pl][0]*q[0] + view.frustum[pl][1]*q[1] + view.frustum[pl][2]*q[2] + view.frustum[pl][3]; };
+                        outside = dist(a) < 1e-4f && dist(p1) < 1e-4f && dist(p2) < 1e-4f;
+                    }
+                    ASSERT_TRUE(outside) << "frustum cull dropped a triangle inside the frustum, meshlet " << mi;
+                } else {
+                    const float e1[3] = { p1[0] - a[0], p1[1] - a[1], p1[2] - a[2] }, e2[3] = { p2[0] - a[0], p2[1] - a[1], p2[2] - a[2] };
+                    const float n[3] = { e1[1]*e2[2] - e1[2]*e2[1], e1[2]*e2[0] - e1[0]*e2[2], e1[0]*e2[1] - e1[1]*e2[0] };
+                    const float v[3] = { a[0] - view.cameraPos[0], a[1] - view.cameraPos[1], a[2] - view.cameraPos[2] };
+                    const float nl = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]), vl = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
+                    ASSERT_GE(n[0]*v[0] + n[1]*v[1] + n[2]*v[2], -1e-4f * nl * vl) << "cone cull dropped a front-facing triangle, meshlet " << mi;
+                }
+            }
+        }
+    EXPECT_GT(culled, 0u) << "nothing was culled; the check is not exercising anything";
+}
+
+TEST(Crowd, ParallelCullMatchesPerMeshletCull) {
+    const CrowdFixture& f = Crowd();
+    ThreadPool pool(3);
+    std::vector<CrowdDraw> survivors;
+    const CullStats stats = CullCrowd(pool, f.mesh, f.bounds, f.instances, f.palettes.data(), f.view, &survivors);
+    size_t visible = 0;
+    for (const InstanceData& inst : f.instances)
+        for (size_t mi = 0; mi < f.mesh.meshlets.size(); ++mi) {
+            float toWorld[16]; Mat4Mul(inst.world, f.Bone(inst, f.mesh.meshlets[mi], f.bounds[mi].dominantBone), toWorld);
+            visible += CullMeshlet(f.view, f.bounds[mi], toWorld, inst.boundsPadding) == CullResult::Visible;
+        }
+    EXPECT_EQ(stats.tested, f.instances.size() * f.mesh.meshlets.size());
+    EXPECT_EQ(stats.visible, visible);
+    EXPECT_EQ(survivors.size(), visible);
+    EXPECT_EQ(stats.visible + stats.frustumCulled + stats.coneCulled, stats.tested);
+}
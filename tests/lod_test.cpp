@@ -0,0 +1,86 @@
+#include "lod.h"
+#include "lod_fixture.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+struct Tube {
+    std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    Tube() { MakeSkinnedTube(kTubes[0].rings, kTubes[0].segments, kTubeBones, verts, indices); }
+};
+
+static const Tube& SmallTube() {
+    static const Tube tube;
+    return tube;
+}
+
+// Largest distance from a source vertex to any triangle of the level, by brute force.
+static float SurfaceDistance(const std::vector<VertexIn>& source, const LodLevel& level) {
+    float worst = 0.0f;
+    for (const VertexIn& s : source) {
+        float best = 1e30f;
+        for (size_t t = 0; t < level.indices.size(); t += 3)
+            best = std::min(best, PointTriangleDistance(s.pos, level.vertices[level.indices[t]].pos,
+                                                        level.vertices[level.indices[t + 1]].pos, level.vertices[level.indices[t + 2]].pos));
+        worst = std::max(worst, best);
+    }
+    return worst;
+}
+
+// Shrinking triangle counts, growing error estimates that cover (and stay within 8x of) the true
+// distance from every source vertex to the level surface, and no collapse across a
+// heavily-weighted joint boundary.
+static void ExpectValidChain(const std::vector<VertexIn>& source, const LodChain& chain, const LodOptions& options) {
+    ASSERT_GE(chain.levels.size(), 3u) << "chain stopped early";
+    for (size_t i = 0; i < chain.levels.size(); ++i) {
+        SCOPED_TRACE("level " + std::to_string(i));
+        const LodLevel& l = chain.levels[i];
+        if (i) {
+            EXPECT_LT(l.indices.size(), chain.levels[i - 1].indices.size());
+            EXPECT_GE(l.error, chain.levels[i - 1].error);
+        }
+        for (uint32_t v : l.indices) ASSERT_LT(v, l.vertices.size());
+        EXPECT_EQ(l.meshlets.sourceVertex.size(), l.meshlets.vertices.size());
+        EXPECT_EQ(l.bounds.size(), l.meshlets.meshlets.size());
+        for (float e : l.meshletError) EXPECT_LE(e, l.error);
+        if (i) {
+            const float surface = SurfaceDistance(source, l);
+            EXPECT_LE(surface, l.error * 1.0001f + 1e-6f);
+            EXPECT_GE(surface * 8.0f, l.error) << "local estimate is far above the true surface distance";
+        }
+        for (size_t s = 0; s < source.size(); ++s) {
+            ASSERT_NE(l.remap[s], ~0u) << "source vertex " << s << " dropped";
+            const VertexIn& rep = l.vertices[l.remap[s]];
+            for (int k = 0; k < 4; ++k)
+                if (source[s].boneWgt[k] >= options.heavyWeight) {
+                    bool influenced = false;
+                    for (int j = 0; j < 4; ++j) influenced |= rep.boneIdx[j] == source[s].boneIdx[k] && rep.boneWgt[j] > 0.0f;
+                    ASSERT_TRUE(influenced) << "collapse of source vertex " << s << " crossed a heavily-weighted joint boundary";
+                }
+        }
+    }
+}
+
+TEST(Lod, SkinAwareChainInvariants) {
+    const Tube& t = SmallTube();
+    ExpectValidChain(t.verts, BuildLodChain(t.verts, t.indices), LodOptions{});
+}
+
+TEST(Lod, PlainQuadricChainInvariants) {
+    const Tube& t = SmallTube();
+    ExpectValidChain(t.verts, BuildLodChain(t.verts, t.indices, PlainQuadricOptions()), PlainQuadricOptions());
+}
+
+TEST(Lod, SelectLodIsMonotonicInDistance) {
+    const Tube& t = SmallTube();
+    const LodChain chain = BuildLodChain(t.verts, t.indices);
+    const float proj = LodProjectionScale(0.8f, 1080.0f);
+    uint32_t previous = 0;
+    for (float d = 0.5f; d < 1e5f; d *= 1.25f) {
+        const uint32_t lod = SelectLod(chain, d, proj, 1.0f);
+        ASSERT_GE(lod, previous) << "SelectLod picked a finer level farther away, at distance " << d;
+        previous = lod;
+    }
+    EXPECT_EQ(previous, chain.levels.size() - 1) << "SelectLod never reaches the coarsest level";
+}
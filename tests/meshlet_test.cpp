@@ -0,0 +1,114 @@
+#include "bench_common.h"
+#include "crowd.h"
+#include "lod_fixture.h"
+#include "meshlet.h"
+#include "synthetic_rig.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using Triangle = std::array<uint32_t, 3>;
+
+// Rotated so the smallest index comes first; keeps the winding.
+static Triangle Canonical(uint32_t a, uint32_t b, uint32_t c) {
+    if (b < a && b < c) return { b, c, a };
+    if (c < a && c < b) return { c, a, b };
+    return { a, b, c };
+}
+
+// Limits hold, meshlets tile the vertex and triangle buffers in order, local indices stay inside
+// their meshlet, and the source triangles come back exactly once each through sourceVertex.
+static void ExpectValidMeshlets(const std::vector<uint32_t>& indices, const MeshletMesh& mesh, const MeshletLimits& limits) {
+    ASSERT_EQ(mesh.sourceVertex.size(), mesh.vertices.size());
+    uint32_t vNext = 0, pNext = 0;
+    std::vector<Triangle> emitted;
+    for (size_t mi = 0; mi < mesh.meshlets.size(); ++mi) {
+        const MeshletData& m = mesh.meshlets[mi];
+        ASSERT_GT(m.pCount, 0u) << "meshlet " << mi;
+        ASSERT_LE(m.vCount, limits.maxVertices) << "meshlet " << mi;
+        ASSERT_LE(m.pCount, limits.maxPrimitives) << "meshlet " << mi;
+        ASSERT_EQ(m.vOffset, vNext) << "meshlet " << mi;
+        ASSERT_EQ(m.pOffset, pNext) << "meshlet " << mi;
+        vNext += m.vCount; pNext += m.pCount;
+        for (uint32_t t = 0; t < m.pCount; ++t) {
+            const MeshletTriangle& tri = mesh.triangles[m.pOffset + t];
+            ASSERT_TRUE(tri.x < m.vCount && tri.y < m.vCount && tri.z < m.vCount) << "meshlet " << mi << " triangle " << t;
+            emitted.push_back(Canonical(mesh.sourceVertex[m.vOffset + tri.x], mesh.sourceVertex[m.vOffset + tri.y],
+                                        mesh.sourceVertex[m.vOffset + tri.z]));
+        }
+    }
+    EXPECT_EQ(vNext, mesh.vertices.size());
+    EXPECT_EQ(pNext, mesh.triangles.size());
+    std::vector<Triangle> source;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) source.push_back(Canonical(indices[i], indices[i + 1], indices[i + 2]));
+    std::sort(source.begin(), source.end()); std::sort(emitted.begin(), emitted.end());
+    EXPECT_EQ(emitted, source);
+}
+
+TEST(Meshlet, CoversEveryTriangleOnceWithinLimits) {
+    std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    MakeSkinnedTube(kTubes[0].rings, kTubes[0].segments, kTubeBones, verts, indices);
+    for (const MeshletLimits limits : { MeshletLimits{}, MeshletLimits{ 32, 32, 4 }, MeshletLimits{ kMaxMeshletVertices, kMaxMeshletPrimitives, 64 } }) {
+        SCOPED_TRACE(testing::Message() << "limits " << limits.maxVertices << "/" << limits.maxPrimitives << "/" << limits.maxBones);
+        ExpectValidMeshlets(indices, BuildMeshlets(verts, indices, limits), limits);
+    }
+}
+
+TEST(Meshlet, GltfPrimitiveCoversEveryTriangleOnce) {
+    BenchRng rng;
+    const tinygltf::Model model = MakeSyntheticRig({ "meshlet", 32, 8 << 10 }, rng);
+    const tinygltf::Primitive& prim = model.meshes[0].primitives[0];
+    std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    ReadPrimitiveVertices(model, prim, verts, indices);
+    ExpectValidMeshlets(indices, BuildMeshlets(model, prim), MeshletLimits{});
+}
+
+// Every weighted meshlet-local bone index addresses the meshlet's own boneRemap slice.
+static void ExpectBonesInSlice(const MeshletMesh& mesh) {
+    for (size_t mi = 0; mi < mesh.meshlets.size(); ++mi) {
+        const MeshletData& m = mesh.meshlets[mi];
+        const uint32_t end = mi + 1 < mesh.meshlets.size() ? mesh.meshlets[mi + 1].boneBase : uint32_t(mesh.boneRemap.size());
+        const uint32_t bones = end - m.boneBase;
+        ASSERT_LE(bones, kMaxMeshletBones) << "meshlet " << mi;
+        for (uint32_t v = 0; v < m.vCount; ++v)
+            for (int k = 0; k < 4; ++k) {
+                if (mesh.vertices[m.vOffset + v].boneWgt[k] > 0.0f) {
+                    ASSERT_LT(mesh.vertices[m.vOffset + v].boneIdx[k], bones) << "meshlet " << mi;
+                }
+            }
+    }
+}
+
+// Requests above kMaxMeshletBones are clamped, so ComputeMeshletBounds sees every local bone.
+TEST(Meshlet, ClampsBonesPerMeshlet) {
+    BenchRng rng;
+    std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    MakeRandomSkinnedGrid(32, 1024, rng, verts, indices);
+    const MeshletMesh mesh = BuildMeshlets(verts, indices, { kMaxMeshletVertices, kMaxMeshletPrimitives, 1024 });
+    ExpectBonesInSlice(mesh);
+    const std::vector<MeshletBounds> bounds = ComputeMeshletBounds(mesh);
+    for (size_t mi = 0; mi < mesh.meshlets.size(); ++mi) {
+        const MeshletData& m = mesh.meshlets[mi];
+        const uint32_t end = mi + 1 < mesh.meshlets.size() ? mesh.meshlets[mi + 1].boneBase : uint32_t(mesh.boneRemap.size());
+        EXPECT_LT(bounds[mi].dominantBone, end - m.boneBase) << "meshlet " << mi;
+    }
+}
+
+// Unweighted vertices reference no bone; each meshlet still gets one slice entry for dominantBone 0.
+TEST(Meshlet, UnweightedMeshletsKeepOneBone) {
+    BenchRng rng;
+    std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    MakeRandomSkinnedGrid(16, 8, rng, verts, indices);
+    for (VertexIn& v : verts) for (float& w : v.boneWgt) w = 0.0f;
+    const MeshletMesh mesh = BuildMeshlets(verts, indices);
+    ASSERT_FALSE(mesh.meshlets.empty());
+    EXPECT_EQ(mesh.boneRemap.size(), mesh.meshlets.size());
+    for (size_t mi = 0; mi < mesh.meshlets.size(); ++mi) {
+        EXPECT_EQ(mesh.meshlets[mi].boneBase, mi);
+        EXPECT_EQ(mesh.boneRemap[mi], 0u);
+    }
+    for (const MeshletBounds& b : ComputeMeshletBounds(mesh)) EXPECT_EQ(b.dominantBone, 0u);
+}
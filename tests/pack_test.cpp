@@ -0,0 +1,195 @@
+#include "animation.h"
+#include "meshlet.h"
+#include "pack.h"
+#include "skeleton.h"
+#include "synthetic_rig.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+// Linear rotation and translation keys for every slot.
+static AnimationClip MakeSwayClip(uint32_t bones, BenchRng& rng) {
+    AnimationClip clip; clip.name = "sway"; clip.duration = 1.0f; clip.boneCount = bones;
+    clip.times = { 0.0f, 0.5f, 1.0f };
+    for (uint32_t s = 0; s < bones; ++s)
+        for (AnimPath path : { AnimPath::Rotation, AnimPath::Translation }) {
+            AnimTrack tr{};
+            tr.slot = s; tr.path = uint8_t(path); tr.interp = uint8_t(AnimInterp::Linear);
+            tr.encoding = uint8_t(TrackEncoding::Float); tr.comps = path == AnimPath::Rotation ? 4 : 3;
+            tr.keyCount = 3; tr.timeOffset = 0; tr.valueOffset = uint32_t(clip.values.size());
+            for (int k = 0; k < 3; ++k) {
+                const float a = rng.Uniform(-1.0f, 1.0f);
+                if (path == AnimPath::Rotation) clip.values.insert(clip.values.end(), { 0.0f, std::sin(0.5f * a), 0.0f, std::cos(0.5f * a) });
+                else clip.values.insert(clip.values.end(), { a, rng.Uniform(0.2f, 0.6f), 0.0f });
+            }
+            clip.tracks.push_back(tr);
+        }
+    return clip;
+}
+
+static std::vector<float> Sample(const ClipView& view, float time) {
+    ClipSampler sampler;
+    std::vector<float> local(size_t(view.boneCount) * 16);
+    SampleClip(view, time, sampler, local.data());
+    return local;
+}
+
+struct PackFixture {
+    std::string path;
+    tinygltf::Model model;
+    Skin skin;
+    SkeletonLayout layout;
+    MeshletMesh mesh;
+    AnimationClip clip, compressed;
+
+    PackFixture() {
+        path = (std::filesystem::temp_directory_path() / "grfx_tests_roundtrip.pack").string();
+        BenchRng rng;
+        model = MakeSyntheticRig({ "pack", 21, 2 << 10 }, rng);
+        skin = BuildSkin(model, 0);
+        layout = BuildSkeletonLayout(skin);
+        ReadRestPose(model, layout);
+        mesh = BuildMeshlets(model, model.meshes[0].primitives[0]);
+        clip = MakeSwayClip(uint32_t(layout.BoneCount()), rng);
+        compressed = CompressClip(clip);
+
+        PackBuilder builder;
+        builder.AddSkin("rig", skin, layout);
+        builder.AddMesh("empty", MeshletMesh{}, -1);
+        builder.AddMesh("body", mesh, 0);
+        builder.AddClip(clip, 0);
+        builder.AddClip(compressed, 0);
+        builder.Write(path);
+    }
+    ~PackFixture() { std::error_code ec; std::filesystem::remove(path, ec); }
+};
+
+TEST(Pack, RoundTripsMeshes) {
+    const PackFixture f;
+    const PackFile pack(f.path);
+    ASSERT_EQ(pack.Meshes().size(), 2u);
+    EXPECT_STREQ(pack.String(pack.Meshes()[0].nameOffset), "empty");
+    const PackMesh& m = pack.Meshes()[1];
+    EXPECT_STREQ(pack.String(m.nameOffset), "body");
+    EXPECT_EQ(m.skin, 0);
+    ASSERT_EQ(m.vertexCount, f.mesh.vertices.size());
+    ASSERT_EQ(m.triangleCount, f.mesh.triangles.size());
+    ASSERT_EQ(m.meshletCount, f.mesh.meshlets.size());
+    ASSERT_EQ(m.boneRemapCount, f.mesh.boneRemap.size());
+    const PackMeshView view = pack.Mesh(1);
+    EXPECT_STREQ(view.name, "body");
+    EXPECT_EQ(view.skin, 0);
+    EXPECT_EQ(memcmp(view.vertices.data(), f.mesh.vertices.data(), f.mesh.vertices.size() * sizeof(VertexIn)), 0);
+    EXPECT_EQ(memcmp(view.triangles.data(), f.mesh.triangles.data(), f.mesh.triangles.size() * sizeof(MeshletTriangle)), 0);
+    for (uint32_t i = 0; i < m.boneRemapCount; ++i) EXPECT_EQ(view.boneRemap[i], f.mesh.boneRemap[i]);
+    for (uint32_t i = 0; i < m.meshletCount; ++i) {
+        const MeshletData& a = view.meshlets[i]; const MeshletData& b = f.mesh.meshlets[i];
+        EXPECT_EQ(a.vOffset, b.vOffset + m.vertexOffset);
+        EXPECT_EQ(a.pOffset, b.pOffset + m.triangleOffset);
+        EXPECT_EQ(a.boneBase, b.boneBase + m.boneRemapOffset);
+        EXPECT_EQ(a.vCount, b.vCount);
+        EXPECT_EQ(a.pCount, b.pCount);
+    }
+}
+
+TEST(Pack, RoundTripsSkeletonLayout) {
+    const PackFixture f;
+    const PackFile pack(f.path);
+    ASSERT_EQ(pack.Skins().size(), 1u);
+    EXPECT_STREQ(pack.String(pack.Skins()[0].nameOffset), "rig");
+    const SkeletonLayout L = pack.Layout(0);
+    EXPECT_EQ(L.parent, f.layout.parent);
+    EXPECT_EQ(L.boneOfSlot, f.layout.boneOfSlot);
+    EXPECT_EQ(L.node, f.layout.node);
+    EXPECT_EQ(L.depthStart, f.layout.depthStart);
+    EXPECT_EQ(L.slotOfBone, f.layout.slotOfBone);
+    EXPECT_EQ(L.inverseBind, f.layout.inverseBind);
+    EXPECT_EQ(L.restLocal, f.layout.restLocal);
+}
+
+TEST(Pack, ClipViewsSampleLikeTheSourceClips) {
+    const PackFixture f;
+    const PackFile pack(f.path);
+    ASSERT_EQ(pack.Clips().size(), 2u);
+    EXPECT_STREQ(pack.String(pack.Clips()[1].nameOffset), "sway");
+    const AnimationClip* sources[] = { &f.clip, &f.compressed };
+    for (uint32_t c = 0; c < 2; ++c)
+        for (float t : { 0.0f, 0.3f, 0.75f, 1.0f })
+            EXPECT_EQ(Sample(pack.Clip(c), t), Sample(ViewOf(*sources[c]), t)) << "clip " << c << " at " << t;
+}
+
+// Writes a copy of `pack` with `field` (a reference into it) set to `value`; Open must reject it.
+template <class T>
+static void ExpectOpenRejects(const PackFile& pack, const T& field, T value) {
+    std::vector<uint8_t> bytes(pack.Data(), pack.Data() + pack.SizeBytes());
+    memcpy(&bytes[size_t(reinterpret_cast<const uint8_t*>(&field) - pack.Data())], &value, sizeof(T));
+    const std::string path = (std::filesystem::temp_directory_path() / "grfx_tests_corrupt.pack").string();
+    FILE* out = fopen(path.c_str(), "wb");
+    ASSERT_NE(out, nullptr);
+    fwrite(bytes.data(), 1, bytes.size(), out); fclose(out);
+    PackFile corrupt;
+    EXPECT_THROW(corrupt.Open(path), std::runtime_error);
+    EXPECT_FALSE(corrupt.IsOpen());
+    std::filesystem::remove(path);
+}
+
+TEST(Pack, OpenRejectsBadSkins) {
+    const PackFixture f;
+    const PackFile pack(f.path);
+    const PackSkin& skin = pack.Skins()[0];
+    const PackBone& bone = pack.Bones()[skin.boneOffset + 3];
+    ExpectOpenRejects(pack, bone.parent, int32_t(3));                        // not before its child
+    ExpectOpenRejects(pack, bone.parent, int32_t(-2));
+    ExpectOpenRejects(pack, bone.paletteIndex, int32_t(skin.boneCount));
+    ExpectOpenRejects(pack, bone.paletteIndex, pack.Bones()[skin.boneOffset + 4].paletteIndex); // duplicate
+    const PackBone* slots = &pack.Bones()[skin.boneOffset];
+    ASSERT_TRUE(slots[1].parent == 0 && slots[3].parent == 0);
+    ExpectOpenRejects(pack, slots[2].parent, int32_t(1));                    // slot 3 would be shallower than slot 2
+    ExpectOpenRejects(pack, skin.boneCount, uint32_t(pack.Bones().size() + 1));
+    ExpectOpenRejects(pack, skin.boneOffset, ~0u);
+}
+
+TEST(Pack, OpenRejectsBadMeshes) {
+    const PackFixture f;
+    const PackFile pack(f.path);
+    const PackMesh& m = pack.Meshes()[1];
+    ExpectOpenRejects(pack, m.skin, int32_t(1));
+    ExpectOpenRejects(pack, m.vertexCount, m.vertexCount + 1);
+    ExpectOpenRejects(pack, m.triangleOffset, ~0u);
+    ExpectOpenRejects(pack, m.meshletCount, m.meshletCount + 1);
+    ExpectOpenRejects(pack, m.boneRemapOffset, m.boneRemapOffset + 1);
+    const MeshletData& md = pack.Meshlets()[m.meshletOffset + 1];
+    ExpectOpenRejects(pack, md.vOffset, m.vertexOffset + m.vertexCount);
+    ExpectOpenRejects(pack, md.vCount, kMaxMeshletVertices + 1);
+    ExpectOpenRejects(pack, md.pOffset, m.triangleOffset + m.triangleCount - md.pCount + 1);
+    ExpectOpenRejects(pack, md.boneBase, m.boneRemapOffset + m.boneRemapCount);
+    ExpectOpenRejects(pack, pack.Triangles()[md.pOffset].y, md.vCount);
+    ExpectOpenRejects(pack, pack.BoneRemap()[m.boneRemapOffset], pack.Skins()[0].boneCount);
+}
+
+TEST(Pack, OpenRejectsBadClips) {
+    const PackFixture f;
+    const PackFile pack(f.path);
+    const PackClip& clip = pack.Clips()[1];
+    ExpectOpenRejects(pack, clip.skin, 1u);
+    ExpectOpenRejects(pack, clip.trackOffset, ~0u);
+    ExpectOpenRejects(pack, clip.trackCount, clip.trackCount + 1);
+    const AnimTrack& track = pack.Clip(0).tracks[0];
+    ExpectOpenRejects(pack, track.slot, clip.boneCount);
+    ExpectOpenRejects(pack, track.comps, uint8_t(5));
+    ExpectOpenRejects(pack, track.valueOffset, uint32_t(f.clip.values.size() + f.compressed.values.size()));
+    ExpectOpenRejects(pack, track.timeOffset, ~0u);
+}
+
+TEST(Pack, RejectsBadIndices) {
+    const PackFixture f;
+    const PackFile pack(f.path);
+    EXPECT_THROW(pack.Mesh(2), std::runtime_error);
+    EXPECT_THROW(pack.Layout(1), std::runtime_error);
+    EXPECT_THROW(pack.Clip(2), std::runtime_error);
+}
@@ -0,0 +1,74 @@
+#include "profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static void Drain() { std::vector<ProfileEvent> sink; ProfilerCollect(sink); }
+
+TEST(Profiler, CollectsNestedZonesPerThread) {
+    constexpr int kThreads = 4, kZones = 5000;
+    ProfilerSetEnabled(true);
+    Drain();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+        threads.emplace_back([] {
+            ProfileSetThreadName("test \"worker\"");
+            for (int i = 0; i < kZones; ++i) {
+                GRFX_PROFILE_ZONE("outer");
+                { GRFX_PROFILE_ZONE("inner"); ProfileCounter("i", double(i)); }
+            }
+        });
+    for (auto& t : threads) t.join();
+    std::vector<ProfileEvent> events;
+    EXPECT_EQ(ProfilerCollect(events), 0u) << "events dropped below ring capacity";
+    ASSERT_EQ(events.size(), size_t(kThreads) * kZones * 3);
+    // per track, in recording order: counter, inner, outer; inner lies inside outer
+    std::vector<uint32_t> tracks;
+    for (size_t i = 0; i + 2 < events.size(); i += 3) {
+        const ProfileEvent& c = events[i]; const ProfileEvent& in = events[i + 1]; const ProfileEvent& out = events[i + 2];
+        ASSERT_EQ(c.kind, ProfileEventKind::Counter);
+        ASSERT_STREQ(in.name, "inner");
+        ASSERT_STREQ(out.name, "outer");
+        ASSERT_EQ(c.track, in.track);
+        ASSERT_EQ(in.track, out.track);
+        ASSERT_GE(in.begin, out.begin);
+        ASSERT_LE(in.end, out.end);
+        ASSERT_GE(out.end, out.begin);
+        if (std::find(tracks.begin(), tracks.end(), out.track) == tracks.end()) tracks.push_back(out.track);
+    }
+    EXPECT_EQ(tracks.size(), size_t(kThreads));
+}
+
+TEST(Profiler, DisabledRecordsNothing) {
+    ProfilerSetEnabled(true);
+    Drain();
+    ProfilerSetEnabled(false);
+    { GRFX_PROFILE_ZONE("disabled"); ProfileCounter("disabled", 1); }
+    ProfilerSetEnabled(true);
+    std::vector<ProfileEvent> events;
+    ProfilerCollect(events);
+    EXPECT_TRUE(events.empty());
+}
+
+TEST(Profiler, FullRingDropsAndCountsNewEvents) {
+    ProfilerSetEnabled(true);
+    Drain();
+    for (size_t i = 0; i < kProfileRingEvents + 100; ++i) ProfileZoneEnd("fill", ProfileNow());
+    std::vector<ProfileEvent> events;
+    EXPECT_EQ(ProfilerCollect(events), 100u);
+    EXPECT_EQ(events.size(), kProfileRingEvents);
+}
+
+TEST(Profiler, ChromeTraceJson) {
+    std::vector<ProfileEvent> events(2);
+    events[0] = ProfileEvent{ "a \"quoted\" zone", 1000, { 3500 }, 0, ProfileEventKind::Zone };
+    events[1] = ProfileEvent{ "c", 2000, { 0 }, kProfileGpuTrack, ProfileEventKind::Counter }; events[1].value = 2.5;
+    const std::string json = ChromeTraceJson(events, { { 0, "main" }, { kProfileGpuTrack, "GPU" } });
+    EXPECT_NE(json.find("\"name\":\"a \\\"quoted\\\" zone\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":0.000,\"dur\":2.500}"), std::string::npos) << json;
+    EXPECT_NE(json.find("\"ph\":\"C\",\"pid\":1,\"tid\":1000,\"ts\":1.000,\"args\":{\"value\":2.5}"), std::string::npos) << json;
+    EXPECT_EQ(std::count(json.begin(), json.end(), '{'), std::count(json.begin(), json.end(), '}'));
+}
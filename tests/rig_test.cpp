@@ -0,0 +1,53 @@
+#include "skeleton.h"
+#include "skin_validate.h"
+#include "synthetic_rig.h"
+#include "tinygltf.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <stdexcept>
+
+static const RigSize kRig = { "test", 32, 8 << 10 };
+
+TEST(SyntheticRig, BuildSkinFollowsTheBoneTree) {
+    BenchRng rng;
+    const tinygltf::Model model = MakeSyntheticRig(kRig, rng);
+    const Skin skin = BuildSkin(model, 0);
+    ASSERT_EQ(skin.bones.size(), kRig.bones);
+    for (size_t b = 0; b < skin.bones.size(); ++b) EXPECT_EQ(skin.bones[b].parent, b ? int(b - 1) / 4 : -1) << "bone " << b;
+}
+
+TEST(SyntheticRig, ValidatesClean) {
+    BenchRng rng;
+    const tinygltf::Model model = MakeSyntheticRig(kRig, rng);
+    SkinValidationOptions options; options.fix = false;
+    const PrimitiveSkinReport report = ValidatePrimitiveSkin(model, model.skins[0], model.meshes[0].primitives[0], options);
+    EXPECT_TRUE(report.counts.Clean());
+}
+
+TEST(SyntheticRig, SkinStreamCountMismatchThrows) {
+    BenchRng rng;
+    for (const char* sem : { "JOINTS_0", "WEIGHTS_0" }) {
+        tinygltf::Model model = MakeSyntheticRig(kRig, rng);
+        const tinygltf::Primitive& prim = model.meshes[0].primitives[0];
+        model.accessors[prim.attributes.at(sem)].count -= 1;
+        std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+        EXPECT_THROW(ReadPrimitiveVertices(model, prim, verts, indices), std::runtime_error) << sem;
+    }
+}
+
+TEST(SyntheticRig, GlbRoundTrip) {
+    BenchRng rng;
+    tinygltf::Model model = MakeSyntheticRig(kRig, rng);
+    const std::string path = (std::filesystem::temp_directory_path() / "grfx_tests_rig.glb").string();
+    tinygltf::TinyGLTF writer;
+    if (!writer.WriteGltfSceneToFile(&model, path, true, true, false, true)) GTEST_SKIP() << "tinygltf cannot write GLBs here";
+    tinygltf::Model loaded;
+    const bool ok = LoadGLTF(path, loaded);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(loaded.accessors.size(), model.accessors.size());
+    ASSERT_FALSE(loaded.buffers.empty());
+    EXPECT_EQ(loaded.buffers[0].data, model.buffers[0].data);
+}
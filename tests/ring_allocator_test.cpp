@@ -0,0 +1,79 @@
+#include "ring_allocator.h"
+#include "thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+static constexpr size_t kAllocsPerFrame = 2048;
+static constexpr uint64_t kFrameLag = 2;
+
+// Alternates 256 B (a constant buffer) and 4 KB (a 64-bone palette) requests.
+static uint64_t RequestSize(size_t i) { return (i & 1) ? 4096 : 256; }
+
+// Allocates one frame from every pool thread; false if any allocation failed, is misaligned,
+// leaves the block or overlaps another one of the frame.
+static bool AllocateFrame(RingAllocator& ring, ThreadPool& pool, uint64_t frame) {
+    ring.Reclaim(frame > kFrameLag ? frame - kFrameLag : 0);
+    std::vector<std::pair<uint64_t, uint64_t>> ranges(kAllocsPerFrame);
+    std::atomic<bool> ok{true};
+    pool.ParallelFor(0, kAllocsPerFrame, 64, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            const RingAllocator::Allocation a = ring.Allocate(RequestSize(i));
+            if (!a || a.offset % 256 || a.offset + RequestSize(i) > ring.Capacity()) ok = false;
+            ranges[i] = { a.offset, a.offset + RequestSize(i) };
+        }
+    });
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t i = 1; i < ranges.size(); ++i) if (ranges[i].first < ranges[i - 1].second) ok = false;
+    ring.FinishFrame(frame);
+    return ok;
+}
+
+// Enough frames to wrap the ring several times, with kFrameLag frames in flight.
+TEST(RingAllocator, ConcurrentFramesWrapWithoutOverlap) {
+    ThreadPool pool(3);
+    uint64_t frameBytes = 0;
+    for (size_t i = 0; i < kAllocsPerFrame; ++i) frameBytes += RequestSize(i);
+    std::vector<uint8_t> block(frameBytes * (kFrameLag + 1) + 4096);
+    RingAllocator ring(block.data(), block.size());
+    for (uint64_t frame = 1; frame <= 4 * (kFrameLag + 1); ++frame) ASSERT_TRUE(AllocateFrame(ring, pool, frame)) << "frame " << frame;
+}
+
+TEST(RingAllocator, FullRingFailsUntilReclaimed) {
+    std::vector<uint8_t> block(4096);
+    RingAllocator ring(block.data(), block.size());
+    for (int i = 0; i < 16; ++i) ASSERT_TRUE(ring.Allocate(256));
+    EXPECT_FALSE(ring.Allocate(256));
+    EXPECT_FALSE(ring.Allocate(8192));
+    ASSERT_TRUE(ring.FinishFrame(1));
+    ring.Reclaim(0);
+    EXPECT_FALSE(ring.Allocate(256));
+    ring.Reclaim(1);
+    EXPECT_EQ(ring.UsedBytes(), 0u);
+    EXPECT_TRUE(ring.Allocate(256));
+}
+
+// Block sizes that are not a multiple of the alignment still get aligned offsets after wrapping.
+TEST(RingAllocator, AlignsOffsetsInOddSizedBlocks) {
+    for (uint64_t blockSize : { 1000ull, 4096ull + 100ull }) {
+        std::vector<uint8_t> block(blockSize);
+        RingAllocator ring(block.data(), block.size());
+        for (uint64_t frame = 1; frame <= 64; ++frame) {
+            ring.Reclaim(frame > 1 ? frame - 1 : 0);
+            const uint64_t alignment = frame % 2 ? 256 : 16;
+            for (int i = 0; i < 3; ++i) {
+                const uint64_t size = 40 + 30 * i;
+                const RingAllocator::Allocation a = ring.Allocate(size, alignment);
+                if (!a) break;
+                ASSERT_EQ(a.offset % alignment, 0u) << "block " << blockSize << " frame " << frame;
+                ASSERT_LE(a.offset + size, blockSize);
+                ASSERT_EQ(a.cpu, block.data() + a.offset);
+            }
+            ASSERT_TRUE(ring.FinishFrame(frame));
+        }
+    }
+}
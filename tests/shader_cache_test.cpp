@@ -0,0 +1,41 @@
+#include "shader_cache.h"
+#include "shader_tree.h"
+#include "thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+TEST(ShaderCache, WarmInstanceHitsWithIdenticalBytes) {
+    const ShaderTree tree("grfx_tests_shader_cache_warm");
+    ThreadPool pool(3);
+    ShaderCache cold(tree.CacheDir(), "fake 1.0", FakeCompile);
+    const std::vector<ShaderBinary> first = cold.GetAll(pool, tree.descs);
+    EXPECT_EQ(cold.Stats().misses, kShaders);
+    EXPECT_EQ(cold.Stats().hits, 0u);
+
+    ShaderCache warm(tree.CacheDir(), "fake 1.0", FakeCompile);
+    const std::vector<ShaderBinary> second = warm.GetAll(pool, tree.descs);
+    EXPECT_EQ(warm.Stats().hits, kShaders);
+    ASSERT_EQ(second.size(), first.size());
+    for (size_t i = 0; i < kShaders; ++i) {
+        EXPECT_EQ(first[i].object, second[i].object) << "shader " << i;
+        EXPECT_EQ(first[i].pdb, second[i].pdb) << "shader " << i;
+        EXPECT_EQ(first[i].reflection, second[i].reflection) << "shader " << i;
+        EXPECT_EQ(first[i].pdbName, second[i].pdbName) << "shader " << i;
+    }
+}
+
+TEST(ShaderCache, KeyCoversCompilerAndIncludes) {
+    const ShaderTree tree("grfx_tests_shader_cache_keys");
+    EXPECT_EQ(ScanShaderIncludes(tree.descs[0].file, tree.descs[0].includeDirs).size(), 3u);
+    ShaderCache a(tree.CacheDir(), "fake 1.0", FakeCompile), b(tree.CacheDir(), "fake 1.1", FakeCompile);
+    EXPECT_NE(a.Key(tree.descs[0]), b.Key(tree.descs[0]));
+
+    ThreadPool pool(3);
+    a.GetAll(pool, tree.descs);
+    WriteText(tree.root / "src" / "inc" / "leaf.hlsli", "#define LEAF 2\n"); // nested include of the even shaders
+    ShaderCache edited(tree.CacheDir(), "fake 1.0", FakeCompile);
+    edited.GetAll(pool, tree.descs);
+    EXPECT_EQ(edited.Stats().misses, kShaders / 2);
+}
@@ -0,0 +1,100 @@
+#include "skeleton.h"
+#include "bench_common.h"
+#include "mat4.h"
+#include "thread_pool.h"
+#include "tinygltf.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+// Random forest stored out of depth order: children often precede their parents, a few bones
+// are extra roots, and every bone has a random rigid inverse bind.
+static Skin MakeShuffledSkin(uint32_t boneCount, BenchRng& rng) {
+    const Skin sorted = MakeRandomSkin<Skin>(boneCount, rng);
+    std::vector<int32_t> order(boneCount); // new index -> sorted index
+    std::iota(order.begin(), order.end(), 0);
+    for (uint32_t i = boneCount; i > 1; --i) std::swap(order[i - 1], order[rng.Next() % i]);
+    std::vector<int32_t> moved(boneCount);
+    for (uint32_t i = 0; i < boneCount; ++i) moved[order[i]] = int32_t(i);
+    const std::vector<float> ibm = MakeRandomPalette(boneCount, rng);
+    Skin skin = sorted;
+    for (uint32_t i = 0; i < boneCount; ++i) {
+        Bone& b = skin.bones[i];
+        b = sorted.bones[order[i]];
+        b.parent = b.parent < 0 || rng.Next() % 16 == 0 ? -1 : moved[b.parent];
+        memcpy(b.inverseBind, &ibm[size_t(i) * 16], sizeof(b.inverseBind));
+    }
+    return skin;
+}
+
+// global = parentGlobal * local, walked up the Skin's own parent links.
+static void NaiveGlobal(const Skin& skin, const std::vector<float>& boneLocal, int32_t b, float* out) {
+    if (skin.bones[b].parent < 0) { memcpy(out, &boneLocal[size_t(b) * 16], sizeof(float) * 16); return; }
+    float parent[16];
+    NaiveGlobal(skin, boneLocal, skin.bones[b].parent, parent);
+    Mat4Mul(parent, &boneLocal[size_t(b) * 16], out);
+}
+
+static void ExpectMatrixNear(const float* a, const float* b, const char* what, size_t index) {
+    for (int e = 0; e < 16; ++e) ASSERT_NEAR(a[e], b[e], 1e-4f) << what << " " << index << " element " << e;
+}
+
+TEST(Skeleton, LayoutSortsParentsBeforeChildren) {
+    BenchRng rng;
+    const Skin skin = MakeShuffledSkin(200, rng);
+    const SkeletonLayout layout = BuildSkeletonLayout(skin);
+    ASSERT_EQ(layout.BoneCount(), skin.bones.size());
+    for (size_t s = 0; s < layout.BoneCount(); ++s) {
+        const int32_t b = layout.boneOfSlot[s];
+        EXPECT_EQ(layout.slotOfBone[b], int32_t(s));
+        EXPECT_LT(layout.parent[s], int32_t(s));
+        const int32_t parentBone = skin.bones[b].parent;
+        EXPECT_EQ(layout.parent[s], parentBone < 0 ? -1 : layout.slotOfBone[parentBone]);
+    }
+}
+
+TEST(Skeleton, EvaluateMatchesNaiveRecursion) {
+    BenchRng rng;
+    const Skin skin = MakeShuffledSkin(200, rng);
+    const SkeletonLayout layout = BuildSkeletonLayout(skin);
+    const size_t n = skin.bones.size();
+    const std::vector<float> boneLocal = MakeRandomPalette(uint32_t(n), rng);
+    std::vector<float> local(n * 16), global(n * 16), skinning(n * 16);
+    for (size_t b = 0; b < n; ++b)
+        memcpy(&local[size_t(layout.slotOfBone[b]) * 16], &boneLocal[b * 16], sizeof(float) * 16);
+    EvaluateSkeleton(layout, local.data(), global.data(), skinning.data());
+
+    for (size_t b = 0; b < n; ++b) {
+        float expected[16], expectedSkinning[16];
+        NaiveGlobal(skin, boneLocal, int32_t(b), expected);
+        ExpectMatrixNear(&global[size_t(layout.slotOfBone[b]) * 16], expected, "global of bone", b);
+        Mat4Mul(expected, skin.bones[b].inverseBind, expectedSkinning);
+        ExpectMatrixNear(&skinning[b * 16], expectedSkinning, "skinning of bone", b);
+    }
+}
+
+TEST(Skeleton, InstancesMatchPerInstanceEvaluation) {
+    BenchRng rng;
+    const SkeletonLayout layout = BuildSkeletonLayout(MakeShuffledSkin(64, rng));
+    const size_t n = layout.BoneCount(), stride = n * 16, instances = 37; // not a multiple of the grain
+    std::vector<float> locals;
+    for (size_t i = 0; i < instances; ++i) {
+        const std::vector<float> pose = MakeRandomPalette(uint32_t(n), rng);
+        locals.insert(locals.end(), pose.begin(), pose.end());
+    }
+    std::vector<float> globals(locals.size()), skinning(locals.size());
+    ThreadPool pool(3);
+    EvaluateSkeletonInstances(pool, layout, instances, locals.data(), globals.data(), skinning.data(), 4);
+
+    std::vector<float> global(stride), palette(stride);
+    for (size_t i = 0; i < instances; ++i) {
+        EvaluateSkeleton(layout, &locals[i * stride], global.data(), palette.data());
+        EXPECT_TRUE(std::equal(global.begin(), global.end(), globals.begin() + i * stride)) << "globals of instance " << i;
+        EXPECT_TRUE(std::equal(palette.begin(), palette.end(), skinning.begin() + i * stride)) << "skinning of instance " << i;
+    }
+}
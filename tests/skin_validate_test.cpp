@@ -0,0 +1,57 @@
+#include "skin_validate.h"
+#include "synthetic_rig.h"
+#include "thread_pool.h"
+
+#include <gtest/gtest.h>
+
+static const int kJointTypes[]  = { TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT };
+static const int kWeightTypes[] = { TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT };
+
+TEST(SkinValidate, CleanStreamsReportNothing) {
+    for (int jt : kJointTypes)
+        for (int wt : kWeightTypes) {
+            BenchRng rng;
+            const tinygltf::Model model = MakeSkinnedModel(1, 4096, jt, wt, 0.0f, 200, rng);
+            SkinValidationOptions options; options.fix = false;
+            EXPECT_TRUE(ValidateSkinStreams(GetSkinStreams(model, model.meshes[0].primitives[0]), 200, options).Clean())
+                << "joints " << jt << " weights " << wt;
+        }
+}
+
+// Fixing a dirty copy must leave nothing for a second pass to report.
+TEST(SkinValidate, FixConverges) {
+    ThreadPool pool(3);
+    for (int jt : kJointTypes)
+        for (int wt : kWeightTypes) {
+            BenchRng rng;
+            tinygltf::Model model = MakeSkinnedModel(4, 4096, jt, wt, 0.05f, 200, rng);
+            EXPECT_FALSE(ValidateModelSkins(pool, model).Clean()) << "joints " << jt << " weights " << wt;
+            EXPECT_TRUE(ValidateModelSkins(pool, model).Clean()) << "joints " << jt << " weights " << wt;
+        }
+}
+
+// An out-of-range joint only matters when its slot has weight; unused slots are reset quietly.
+TEST(SkinValidate, UnweightedOutOfRangeJointsAreNotIssues) {
+    BenchRng rng;
+    tinygltf::Model model = MakeSkinnedModel(1, 64, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_COMPONENT_TYPE_FLOAT, 0.0f, 200, rng);
+    const VertexSkinView view = GetSkinStreams(model, model.meshes[0].primitives[0]);
+    ASSERT_TRUE(view.valid);
+    auto joints = [&](size_t i) { return reinterpret_cast<uint16_t*>(const_cast<uint8_t*>(view.joints + view.strideJ * i)); };
+    auto weights = [&](size_t i) { return reinterpret_cast<float*>(const_cast<uint8_t*>(view.weights + view.strideW * i)); };
+    for (size_t i : { 5, 6 }) { float* w = weights(i); w[0] += w[3]; w[3] = 0.0f; }
+    joints(5)[3] = 250; // unused slot
+    joints(6)[0] = 250; // weighted slot
+
+    SkinValidationOptions options; options.fix = false;
+    const SkinIssueCounts report = ValidateSkinStreams(view, 200, options);
+    EXPECT_EQ(report.jointOutOfRange, 1u);
+    EXPECT_EQ(report.modified, 1u);
+    EXPECT_EQ(report.firstBadVertex, 6u);
+
+    options.fix = true;
+    EXPECT_EQ(ValidateSkinStreams(view, 200, options).modified, 1u);
+    EXPECT_EQ(joints(5)[3], 0u);
+    EXPECT_EQ(joints(6)[0], 0u);
+    options.fix = false;
+    EXPECT_TRUE(ValidateSkinStreams(view, 200, options).Clean());
+}
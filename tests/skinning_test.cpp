@@ -0,0 +1,37 @@
+#include "bench_common.h"
+#include "cpu_skinning.h"
+#include "thread_pool.h"
+
+#include <gtest/gtest.h>
+
+static constexpr uint32_t kBones = 128;
+
+struct SkinningCase {
+    SkinningStreams streams; std::vector<float> palette; SkinnedVertices reference;
+    SkinningCase() {
+        BenchRng rng;
+        const std::vector<VertexIn> verts = MakeRandomSkinnedVertices(10000, kBones, rng); // not a multiple of 8
+        streams = MakeSkinningStreams(verts.data(), verts.size(), kBones);
+        palette = MakeRandomPalette(kBones, rng);
+        SkinVertices(streams, palette.data(), reference, SkinningBackend::Scalar);
+    }
+};
+
+TEST(Skinning, KernelsMatchScalarReference) {
+    const SkinningCase c;
+    for (SkinningBackend backend : { SkinningBackend::Auto, SkinningBackend::SSE, SkinningBackend::AVX2 }) {
+        SkinnedVertices out;
+        SkinVertices(c.streams, c.palette.data(), out, backend);
+        EXPECT_LE(MaxSkinningError(out, c.reference, c.streams.count), 1e-4f) << SkinningBackendName(backend);
+    }
+}
+
+TEST(Skinning, ParallelMatchesScalarReference) {
+    const SkinningCase c;
+    for (int workers : { 0, 3 }) {
+        ThreadPool pool(workers);
+        SkinnedVertices out;
+        SkinVerticesParallel(pool, c.streams, c.palette.data(), out, SkinningBackend::Auto, 512);
+        EXPECT_LE(MaxSkinningError(out, c.reference, c.streams.count), 1e-4f) << workers << " workers";
+    }
+}
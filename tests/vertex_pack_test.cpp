@@ -0,0 +1,37 @@
+#include "bench_common.h"
+#include "vertex_pack.h"
+
+#include <gtest/gtest.h>
+
+static MeshletMesh MakeGridMesh() {
+    BenchRng rng; std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    MakeRandomSkinnedGrid(64, 64, rng, verts, indices);
+    return BuildMeshlets(verts, indices);
+}
+
+// Half a quantization step (+ float slack), oct16 well under 0.01 deg, unorm8 within one step.
+TEST(VertexPack, RoundTripWithinLayoutBounds) {
+    const MeshletMesh mesh = MakeGridMesh();
+    for (JointFormat joints : { JointFormat::U8, JointFormat::U16 }) {
+        SCOPED_TRACE(joints == JointFormat::U16 ? "u16 joints" : "u8 joints");
+        const PackedVertices packed = PackMeshletVertices(mesh, joints);
+        EXPECT_EQ(packed.VertexCount(), mesh.vertices.size());
+        const VertexPackError e = MeasureVertexPackError(mesh, packed);
+        EXPECT_LE(e.position, e.positionBound * 1.01f + 1e-6f);
+        EXPECT_LE(e.normalDegrees, 0.01f);
+        EXPECT_LE(e.weight, 1.0f / 255.0f);
+        EXPECT_EQ(e.jointMismatches, 0u);
+    }
+}
+
+TEST(VertexPack, QuantizedWeightsSumTo255) {
+    BenchRng rng;
+    for (int i = 0; i < 10000; ++i) {
+        const float w[4] = { rng.Uniform(), rng.Uniform(), rng.Uniform(), i % 7 ? rng.Uniform() : 0.0f };
+        uint8_t q[4]; QuantizeWeights(w, q);
+        ASSERT_EQ(q[0] + q[1] + q[2] + q[3], 255);
+    }
+    const float zero[4] = {};
+    uint8_t q[4]; QuantizeWeights(zero, q);
+    EXPECT_EQ(q[0], 255);
+}
@@ -0,0 +1,123 @@
+// cook: validates/repairs the skin streams of a glTF asset, converts it into a cooked .pack
+// (meshlets, skins, animation clips) and compares load time of the glTF path against
+// memory-mapping the pack.
+//
+//   cook <model.gltf|model.glb> <out.pack> [--quantize-clips]
+
+#include "tinygltf.h"
+#include "meshlet.h"
+#include "skeleton.h"
+#include "animation.h"
+#include "pack.h"
+#include "skin_validate.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+static double MsSince(Clock::time_point t0) { return std::chrono::duration<double, std::milli>(Clock::now() - t0).count(); }
+
+// Skin whose joints are targeted by the most channels of the animation, or -1.
+static int SkinOfAnimation(const tinygltf::Model& model, const tinygltf::Animation& anim) {
+    int best = -1; size_t bestHits = 0;
+    for (size_t s = 0; s < model.skins.size(); ++s) {
+        const auto& joints = model.skins[s].joints;
+        size_t hits = 0;
+        for (const auto& ch : anim.channels)
+            hits += std::find(joints.begin(), joints.end(), ch.target_node) != joints.end();
+        if (hits > bestHits) { best = int(s); bestHits = hits; }
+    }
+    return best;
+}
+
+// Everything the runtime needs from the glTF, extracted the way the pack stores it.
+static void Cook(const tinygltf::Model& model, bool quantizeClips, PackBuilder& out) {
+    std::vector<SkeletonLayout> layouts;
+    for (size_t s = 0; s < model.skins.size(); ++s) {
+        Skin skin = BuildSkin(model, int(s));
+        layouts.push_back(BuildSkeletonLayout(skin));
+        ReadRestPose(model, layouts.back());
+        out.AddSkin(model.skins[s].name, skin, layouts.back());
+    }
+
+    std::vector<int> skinOfMesh(model.meshes.size(), -1);
+    for (const auto& node : model.nodes)
+        if (node.mesh >= 0 && node.mesh < int(model.meshes.size()) && node.skin >= 0) skinOfMesh[node.mesh] = node.skin;
+    for (size_t m = 0; m < model.meshes.size(); ++m)
+        for (size_t p = 0; p < model.meshes[m].primitives.size(); ++p) {
+            MeshletMesh mesh;
+            try { mesh = BuildMeshlets(model, model.meshes[m].primitives[p]); }
+            catch (const std::exception& e) { fprintf(stderr, "mesh %zu prim %zu: %s\n", m, p, e.what()); continue; }
+            const std::string name = (model.meshes[m].name.empty() ? "mesh" + std::to_string(m) : model.meshes[m].name) + "/" + std::to_string(p);
+            out.AddMesh(name, mesh, skinOfMesh[m]);
+        }
+
+    for (size_t a = 0; a < model.animations.size(); ++a) {
+        const int skin = SkinOfAnimation(model, model.animations[a]);
+        if (skin < 0) { fprintf(stderr, "animation %zu targets no skin joints, skipped\n", a); continue; }
+        AnimationClip clip = BuildAnimationClip(model, int(a), layouts[skin]);
+        if (quantizeClips) clip = CompressClip(clip);
+        out.AddClip(clip, uint32_t(skin));
+    }
+}
+
+// Reads every byte of the mapped file (page faults included) so the pack timing is not just mmap().
+static uint64_t TouchPack(const PackFile& pack) {
+    uint64_t sum = 0;
+    for (const PackMesh& m : pack.Meshes()) sum += m.vertexCount;
+    for (uint32_t s = 0; s < pack.Skins().size(); ++s) sum += pack.Layout(s).BoneCount();
+    for (uint32_t c = 0; c < pack.Clips().size(); ++c) sum += pack.Clip(c).trackCount;
+    for (size_t i = 0; i < pack.SizeBytes(); i += 64) sum += pack.Data()[i];
+    return sum;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: cook <model.gltf|model.glb> <out.pack> [--quantize-clips]\n");
+        return 1;
+    }
+    const bool quantize = argc > 3 && std::string(argv[3]) == "--quantize-clips";
+
+    try {
+        auto t0 = Clock::now();
+        tinygltf::Model model;
+        if (!LoadGLTF(argv[1], model)) return 1;
+        const double parseMs = MsSince(t0);
+
+        // repair skin streams in place before anything reads them
+        ThreadPool pool;
+        t0 = Clock::now();
+        const SkinValidationReport skinReport = ValidateModelSkins(pool, model);
+        const double validateMs = MsSince(t0);
+        if (!skinReport.Clean()) PrintSkinReport(skinReport, stderr);
+
+        PackBuilder builder;
+        t0 = Clock::now();
+        Cook(model, quantize, builder);
+        const double extractMs = MsSince(t0);
+        builder.Write(argv[2]);
+
+        t0 = Clock::now();
+        PackFile pack(argv[2]);
+        const double openMs = MsSince(t0);
+        const uint64_t sum = TouchPack(pack);
+        const double packMs = MsSince(t0);
+
+        printf("%s -> %s (%.2f MB): %zu meshes, %zu meshlets, %zu vertices, %zu skins, %zu clips\n",
+               argv[1], argv[2], pack.SizeBytes() / (1024.0 * 1024.0), pack.Meshes().size(), pack.Meshlets().size(),
+               pack.Vertices().size(), pack.Skins().size(), pack.Clips().size());
+        printf("skin validation: %zu vertices, %zu fixed, %.2f ms (%.0f MB/s)\n", skinReport.total.vertices, skinReport.total.modified,
+               validateMs, validateMs > 0 ? skinReport.bytesScanned / (1024.0 * 1024.0) / (validateMs / 1000.0) : 0.0);
+        printf("glTF: parse %8.2f ms + extract/meshletize %8.2f ms = %8.2f ms\n", parseMs, extractMs, parseMs + extractMs);
+        printf("pack: map   %8.2f ms + touch all pages       = %8.2f ms  (%.1fx faster, checksum %llu)\n",
+               openMs, packMs, packMs > 0 ? (parseMs + extractMs) / packMs : 0.0, (unsigned long long)sum);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "cook failed: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+// meshletize: builds meshlets for every primitive of a glTF asset (or a synthetic grid)
+// and reports vertices/meshlet, triangle fill, build time, packed-vertex size/error and the
+// skin-aware LOD chain (triangles, meshlets and error estimate per level).
+//
+//   meshletize <model.gltf|model.glb> [maxVertices maxPrimitives maxBones]
+//   meshletize --grid <N>            [maxVertices maxPrimitives maxBones]   (2*N*N triangles)
+
+#include "tinygltf.h"
+#include "lod.h"
+#include "meshlet.h"
+#include "vertex_pack.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// N x N quad grid skinned to a chain of 8 bones along +Y.
+static void MakeGrid(uint32_t n, std::vector<VertexIn>& verts, std::vector<uint32_t>& indices) {
+    verts.resize(size_t(n + 1) * (n + 1));
+    for (uint32_t y = 0; y <= n; ++y)
+        for (uint32_t x = 0; x <= n; ++x) {
+            const float fy = float(y) / n * 7.0f; const uint32_t b = std::min(uint32_t(fy), 6u); const float w = fy - b;
+            verts[size_t(y) * (n + 1) + x] = { { float(x) / n, float(y) / n, 0 }, { 0, 0, 1 }, { b, b + 1, 0, 0 }, { 1 - w, w, 0, 0 } };
+        }
+    indices.clear(); indices.reserve(size_t(n) * n * 6);
+    for (uint32_t y = 0; y < n; ++y)
+        for (uint32_t x = 0; x < n; ++x) {
+            const uint32_t i = y * (n + 1) + x;
+            indices.insert(indices.end(), { i, i + n + 1, i + 1, i + 1, i + n + 1, i + n + 2 });
+        }
+}
+
+static void Report(const char* name, const std::vector<VertexIn>& verts, const std::vector<uint32_t>& indices,
+                   const MeshletLimits& limits) {
+    auto t0 = std::chrono::steady_clock::now();
+    MeshletMesh mesh = BuildMeshlets(verts, indices, limits);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    MeshletStats s = ComputeMeshletStats(mesh, limits, verts.size());
+    printf("%-24s tris %9zu  meshlets %7zu  verts/meshlet %6.2f  tris/meshlet %6.2f  fill %5.1f%%  bones/meshlet %5.2f  dup %.2fx  %9.2f ms  %6.2f Mtri/s\n",
+           name, indices.size() / 3, s.meshletCount, s.avgVertices, s.avgTriangles, s.triangleFill * 100.0,
+           s.avgBones, s.vertexDuplication, ms, ms > 0 ? indices.size() / 3 / ms / 1000.0 : 0.0);
+    const PackedVertices packed = PackMeshletVertices(mesh);
+    const VertexPackError e = MeasureVertexPackError(mesh, packed);
+    printf("%-24s packed %zu B/vertex (%.2fx smaller)  pos err %.3g (bound %.3g)  nrm err %.4f deg  wgt err %.4f  joint mismatches %zu\n",
+           "", packed.BytesPerVertex(), double(sizeof(VertexIn)) / packed.BytesPerVertex(), e.position, e.positionBound,
+           e.normalDegrees, e.weight, e.jointMismatches);
+
+    LodOptions lodOptions; lodOptions.meshlet = limits;
+    t0 = std::chrono::steady_clock::now();
+    const LodChain chain = BuildLodChain(verts, indices, lodOptions);
+    ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    printf("%-24s lod chain: %zu levels in %.2f ms (radius %.3g)\n", "", chain.levels.size(), ms, chain.radius);
+    for (size_t i = 0; i < chain.levels.size(); ++i) {
+        const LodLevel& l = chain.levels[i];
+        printf("%-24s   lod %zu  tris %9zu (%5.1f%%)  meshlets %7zu  error %.3g (%.2f%% of radius)\n", "", i, l.indices.size() / 3,
+               100.0 * l.indices.size() / std::max<size_t>(1, chain.levels[0].indices.size()), l.meshlets.meshlets.size(),
+               l.error, chain.radius > 0 ? 100.0 * l.error / chain.radius : 0.0);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: meshletize <model.gltf|model.glb> [maxVertices maxPrimitives maxBones]\n"
+                        "       meshletize --grid <N> [maxVertices maxPrimitives maxBones]\n");
+        return 1;
+    }
+    const bool grid = std::string(argv[1]) == "--grid";
+    const int limitArg = grid ? 3 : 2;
+    MeshletLimits limits;
+    if (argc > limitArg)     limits.maxVertices   = uint32_t(atoi(argv[limitArg]));
+    if (argc > limitArg + 1) limits.maxPrimitives = uint32_t(atoi(argv[limitArg + 1]));
+    if (argc > limitArg + 2) limits.maxBones      = uint32_t(atoi(argv[limitArg + 2]));
+
+    std::vector<VertexIn> verts; std::vector<uint32_t> indices;
+    if (grid) {
+        if (argc < 3) { fprintf(stderr, "--grid needs a size\n"); return 1; }
+        MakeGrid(uint32_t(atoi(argv[2])), verts, indices);
+        Report("grid", verts, indices, limits);
+        return 0;
+    }
+
+    tinygltf::Model model;
+    if (!LoadGLTF(argv[1], model)) return 1;
+    for (size_t m = 0; m < model.meshes.size(); ++m)
+        for (size_t p = 0; p < model.meshes[m].primitives.size(); ++p) {
+            try { ReadPrimitiveVertices(model, model.meshes[m].primitives[p], verts, indices); }
+            catch (const std::exception& e) { fprintf(stderr, "mesh %zu prim %zu: %s\n", m, p, e.what()); continue; }
+            std::string name = model.meshes[m].name.empty() ? "mesh" + std::to_string(m) : model.meshes[m].name;
+            Report((name + "/" + std::to_string(p)).c_str(), verts, indices, limits);
+        }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// shaderc: precompiles shaders into the on-disk shader cache (shader_cache.h) with DXC, so the
+// demo starts warm. Builds against the Windows or the Linux DXC release; keys only match the
+// demo's when both use the same DXC version.
+//
+//   shaderc [--cache DIR] [--root DIR] [-j N] [--measure] [file:entry:target[:DEF=1,DEF2=0]]...
+//
+// Without shader specs it compiles every DemoShaderPermutations() entry. --measure drops those
+// entries first and reports cold (all misses) vs warm (all hits) times.
+
+#include "demo_shaders.h"
+#include "dxc_compiler.h"
+#include "thread_pool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> Split(const std::string& s, char sep) {
+    std::vector<std::string> out; size_t pos = 0;
+    for (size_t next; (next = s.find(sep, pos)) != std::string::npos; pos = next + 1) out.push_back(s.substr(pos, next - pos));
+    out.push_back(s.substr(pos));
+    return out;
+}
+
+static double Run(ShaderCache& cache, ThreadPool& pool, const std::vector<ShaderDesc>& descs, const char* label) {
+    auto t0 = std::chrono::steady_clock::now();
+    const std::vector<ShaderBinary> binaries = cache.GetAll(pool, descs);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    for (size_t i = 0; i < descs.size(); ++i) {
+        cache.ExportPdb(binaries[i]);
+        printf("  %016llx  %-28s %-8s %-6s dxil %7zu B  pdb %7zu B  refl %6zu B\n", (unsigned long long)cache.Key(descs[i]),
+               descs[i].file.c_str(), descs[i].entry.c_str(), descs[i].target.c_str(),
+               binaries[i].object.size(), binaries[i].pdb.size(), binaries[i].reflection.size());
+    }
+    const ShaderCacheStats s = cache.Stats();
+    printf("%s: %zu shaders in %.1f ms wall  (%zu hits, %zu misses; key %.1f ms, load %.1f ms, compile %.1f ms summed)\n",
+           label, descs.size(), ms, s.hits, s.misses, s.keyMs, s.loadMs, s.compileMs);
+    return ms;
+}
+
+int main(int argc, char** argv) {
+    std::string cacheDir = "shader_cache", root = "shaders";
+    int threads = -1; bool measure = false;
+    std::vector<ShaderDesc> descs;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--cache" && i + 1 < argc) cacheDir = argv[++i];
+        else if (a == "--root" && i + 1 < argc) root = argv[++i];
+        else if (a == "-j" && i + 1 < argc) threads = atoi(argv[++i]) - 1;
+        else if (a == "--measure") measure = true;
+        else if (a[0] != '-') {
+            const std::vector<std::string> parts = Split(a, ':');
+            if (parts.size() < 3) { fprintf(stderr, "bad shader spec '%s' (file:entry:target[:DEFINES])\n", a.c_str()); return 1; }
+            const std::string dir = std::filesystem::path(parts[0]).parent_path().string();
+            ShaderDesc d{ parts[0], parts[1], parts[2], {}, { dir.empty() ? "." : dir }, kDemoShaderArgs };
+            if (parts.size() > 3 && !parts[3].empty()) d.defines = Split(parts[3], ',');
+            descs.push_back(d);
+        } else {
+            fprintf(stderr, "usage: shaderc [--cache DIR] [--root DIR] [-j N] [--measure] [file:entry:target[:DEF=1,DEF2=0]]...\n");
+            return 1;
+        }
+    }
+    if (descs.empty()) descs = DemoShaderPermutations(root);
+
+    try {
+        ThreadPool pool(threads);
+        const std::string compilerId = DxcCompilerId(DxcCreateInstance);
+        auto compile = [](const ShaderDesc& d) { return CompileWithDxc(DxcCreateInstance, d); };
+        printf("%s, %u threads, cache %s\n", compilerId.c_str(), pool.WorkerCount() + 1, cacheDir.c_str());
+        if (measure) {
+            ShaderCache cold(cacheDir, compilerId, compile);
+            for (const ShaderDesc& d : descs) { std::error_code ec; std::filesystem::remove(cold.EntryPath(cold.Key(d)), ec); }
+            const double coldMs = Run(cold, pool, descs, "cold");
+            ShaderCache warm(cacheDir, compilerId, compile);
+            const double warmMs = Run(warm, pool, descs, "warm");
+            printf("warm start is %.1fx faster\n", warmMs > 0 ? coldMs / warmMs : 0.0);
+        } else {
+            ShaderCache cache(cacheDir, compilerId, compile);
+            Run(cache, pool, descs, "precompile");
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}